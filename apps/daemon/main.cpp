@@ -4,12 +4,16 @@
 #include "gpu/cuda_ipc_memory.hpp"
 #include "gpu/gpu.hpp"
 #include "ipc/ipc.hpp"
+#include "queue/numa.hpp"
+#include "queue/ring_pool.hpp"
 #include "worker/worker.hpp"
 
 #include <csignal>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <utility>
 
 namespace {
 
@@ -19,9 +23,36 @@ extern "C" void request_stop(int) {
     stop_requested = 1;
 }
 
+bool configured_flag(const char *name) {
+    const char *const configured = std::getenv(name);
+    return configured != nullptr && std::strcmp(configured, "1") == 0;
+}
+
 int run_server(const char *socket_path) {
     ugdr::gpu::RuntimeCudaIpcMemoryBackend memory_backend;
-    ugdr::control::QpService service(memory_backend);
+    // UGDR_DEVICE_PCI_ADDRESS names the GPU or NIC behind the device, whose NUMA node then hosts
+    // the control thread, the ring pool thread, and ring memory.
+    ugdr::control::DeviceCatalog catalog;
+    const std::uint64_t device_identity = catalog.devices().front().identity;
+    const char *const pci_address = std::getenv("UGDR_DEVICE_PCI_ADDRESS");
+    if (pci_address != nullptr && pci_address[0] != '\0') {
+        const int status = catalog.set_pci_address(device_identity, pci_address);
+        if (status != 0) {
+            std::cerr << "ugdr_daemon: no NUMA node for " << pci_address << ": " << status << '\n';
+        }
+    }
+    const int numa_node = catalog.numa_node(device_identity);
+    (void)ugdr::queue::pin_thread_to_numa_node(numa_node);
+    // UGDR_RING_HUGE_PAGES=1 backs large rings with huge pages; UGDR_RING_PREFAULT=1 populates
+    // each ring as it is created.
+    const ugdr::queue::RingMemoryOptions ring_options{
+        configured_flag("UGDR_RING_HUGE_PAGES"), configured_flag("UGDR_RING_PREFAULT"), numa_node};
+    ugdr::queue::SharedRingPool ring_pool(4, ring_options);
+    ugdr::control::QpService service(std::move(catalog), memory_backend);
+    service.set_ring_memory_options(ring_options);
+    if (ring_pool.start() == 0) {
+        service.set_ring_pool(&ring_pool);
+    }
     ugdr::control::ControlIpcHandler handler(service);
     ugdr::ipc::IpcServer server(handler);
     const int start_status = server.start(socket_path);
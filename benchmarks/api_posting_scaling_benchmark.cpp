@@ -0,0 +1,346 @@
+#include "control/qp.hpp"
+#include "ipc/ipc.hpp"
+#include "queue/descriptors.hpp"
+#include "queue/shared_ring.hpp"
+#include "ugdr/api.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint32_t kQueueDepth = 256;
+constexpr std::size_t kMaxThreads = 8;
+constexpr std::uint64_t kDefaultWrsPerThread = UINT64_C(1) << 20U;
+constexpr std::uint64_t kControlPollInterval = 1024;
+constexpr std::array<std::size_t, 4> kThreadCounts{1, 2, 4, 8};
+
+class UnusedCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &, ugdr::gpu::CudaIpcMapping *) override {
+        return EIO;
+    }
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return EIO;
+    }
+};
+
+class DrainingService final : public ugdr::control::ControlService {
+  public:
+    DrainingService() : service_(backend_) {
+    }
+
+    ugdr::control::ControlServiceResult
+    handle(ugdr::ipc::SessionId session_id, ugdr::control::DecodedControlRequest request) override {
+        const auto method = static_cast<ugdr::control::ControlMethod>(request.value.method);
+        auto result = service_.handle(session_id, std::move(request));
+        if (method == ugdr::control::ControlMethod::create_qp && result.response.status == 0) {
+            capture_send_queue(result);
+        }
+        return result;
+    }
+
+    void on_disconnect(ugdr::ipc::SessionId session_id) noexcept override {
+        service_.on_disconnect(session_id);
+    }
+
+    void drain() {
+        for (ugdr::queue::SharedRing &ring : send_queues_) {
+            ugdr::queue::ConstSlotBatch batch;
+            if (ring.consumer_peek(kQueueDepth, &batch) == 0) {
+                (void)ring.consumer_release(batch.count);
+            }
+        }
+    }
+
+    [[nodiscard]] bool valid() const noexcept {
+        return valid_;
+    }
+
+  private:
+    void capture_send_queue(const ugdr::control::ControlServiceResult &result) {
+        std::uint32_t stride = 0;
+        if (result.file_descriptors.empty() || ugdr::queue::send_slot_stride(1, &stride) != 0) {
+            valid_ = false;
+            return;
+        }
+        const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, kQueueDepth,
+                                                      stride};
+        const int fd = ::fcntl(result.file_descriptors[0].get(), F_DUPFD_CLOEXEC, 0);
+        ugdr::queue::SharedRing ring;
+        if (fd < 0 || ugdr::queue::map_shared_ring(fd, descriptor, &ring) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            valid_ = false;
+            return;
+        }
+        send_queues_.push_back(std::move(ring));
+    }
+
+    UnusedCudaBackend backend_;
+    ugdr::control::QpService service_;
+    std::vector<ugdr::queue::SharedRing> send_queues_;
+    bool valid_ = true;
+};
+
+int child_main(const std::string &socket_path, int ready_fd) {
+    DrainingService service;
+    ugdr::control::ControlIpcHandler handler(service);
+    ugdr::ipc::IpcServer server(handler);
+    if (server.start(socket_path) != 0) {
+        return 20;
+    }
+    const char ready = 'r';
+    if (::write(ready_fd, &ready, 1) != 1) {
+        return 21;
+    }
+    for (std::uint64_t cycle = 0;; ++cycle) {
+        if ((cycle & (kControlPollInterval - 1)) == 0 && server.poll_once(0) != 0) {
+            return 22;
+        }
+        if (!service.valid()) {
+            return 23;
+        }
+        service.drain();
+    }
+}
+
+void terminate_process(pid_t *process) {
+    if (*process <= 0) {
+        return;
+    }
+    (void)::kill(*process, SIGTERM);
+    (void)::waitpid(*process, nullptr, 0);
+    *process = -1;
+}
+
+int initialize(ugdr_qp *qp) {
+    ugdr_qp_attr attributes{};
+    attributes.qp_state = UGDR_QPS_INIT;
+    attributes.cur_qp_state = UGDR_QPS_RESET;
+    attributes.qp_access_flags = UGDR_ACCESS_REMOTE_WRITE;
+    return ugdr_modify_qp(qp, &attributes,
+                          UGDR_QP_STATE | UGDR_QP_CUR_STATE | UGDR_QP_ACCESS_FLAGS);
+}
+
+int connect(ugdr_qp *qp, std::uint32_t remote_qp_num) {
+    const ugdr_qp_conn_info remote{remote_qp_num};
+    ugdr_qp_attr retry{};
+    retry.timeout = 14;
+    retry.retry_cnt = 7;
+    retry.rnr_retry = 7;
+    retry.min_rnr_timer = 1;
+    constexpr int mask =
+        UGDR_QP_TIMEOUT | UGDR_QP_RETRY_CNT | UGDR_QP_RNR_RETRY | UGDR_QP_MIN_RNR_TIMER;
+    return ugdr_connect_qp(qp, &remote, &retry, mask);
+}
+
+bool post_all(ugdr_qp *qp, std::uint64_t first_wr_id, std::uint64_t count) {
+    ugdr_send_wr wr{};
+    wr.opcode = UGDR_WR_RDMA_WRITE;
+    wr.wr.rdma.remote_addr = UINT64_C(0x100000);
+    wr.wr.rdma.rkey = 1;
+    for (std::uint64_t index = 0; index < count;) {
+        wr.wr_id = first_wr_id + index;
+        ugdr_send_wr *bad = nullptr;
+        const int status = ugdr_post_send(qp, &wr, &bad);
+        if (status == 0) {
+            ++index;
+        } else if (status == ENOMEM) {
+            std::this_thread::yield();
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool run(const std::vector<ugdr_qp *> &qps, std::size_t thread_count, bool shared_qp,
+         std::uint64_t wrs_per_thread, double *baseline) {
+    std::atomic<bool> start{false};
+    std::atomic<std::size_t> ready{0};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (std::size_t index = 0; index < thread_count; ++index) {
+        threads.emplace_back([&, index] {
+            ugdr_qp *const qp = shared_qp ? qps[0] : qps[index];
+            ++ready;
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            if (!post_all(qp, static_cast<std::uint64_t>(index) * wrs_per_thread,
+                          wrs_per_thread)) {
+                ++failures;
+            }
+        });
+    }
+    while (ready.load() != thread_count) {
+        std::this_thread::yield();
+    }
+    const auto begin = Clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - begin);
+    if (failures.load() != 0) {
+        return false;
+    }
+    const std::uint64_t completed = wrs_per_thread * thread_count;
+    const double wrs_per_second = static_cast<double>(completed) / elapsed.count();
+    if (thread_count == 1) {
+        *baseline = wrs_per_second;
+    }
+    std::printf("benchmark=api_posting_scaling build_type=%s cpu_threads=%u qp_mode=%s "
+                "threads=%zu wr_per_thread=%llu completed_wr=%llu MWR_per_s=%.3f "
+                "scaling=%.2f\n",
+                UGDR_BENCHMARK_BUILD_TYPE, std::thread::hardware_concurrency(),
+                shared_qp ? "shared" : "private", thread_count,
+                static_cast<unsigned long long>(wrs_per_thread),
+                static_cast<unsigned long long>(completed), wrs_per_second / 1'000'000.0,
+                *baseline > 0.0 ? wrs_per_second / *baseline : 0.0);
+    return true;
+}
+
+int run_client(std::uint64_t wrs_per_thread) {
+    int count = 0;
+    ugdr_device **devices = ugdr_get_device_list(&count);
+    ugdr_context *const context =
+        devices != nullptr && count == 1 ? ugdr_open_device(devices[0]) : nullptr;
+    if (devices != nullptr) {
+        ugdr_free_device_list(devices);
+    }
+    ugdr_pd *const pd = context != nullptr ? ugdr_alloc_pd(context) : nullptr;
+    ugdr_cq *const cq =
+        context != nullptr ? ugdr_create_cq(context, kQueueDepth, nullptr, nullptr, 0) : nullptr;
+    if (context == nullptr || pd == nullptr || cq == nullptr) {
+        return 6;
+    }
+
+    int result = 0;
+    std::vector<ugdr_qp *> qps;
+    for (std::size_t index = 0; index < kMaxThreads && result == 0; ++index) {
+        ugdr_qp_init_attr attributes{cq, cq, kQueueDepth, kQueueDepth, 1, 1, UGDR_QPT_RC, 0,
+                                     nullptr};
+        ugdr_qp *const qp = ugdr_create_qp(pd, &attributes);
+        if (qp == nullptr || initialize(qp) != 0) {
+            result = 7;
+        }
+        if (qp != nullptr) {
+            qps.push_back(qp);
+        }
+    }
+    for (std::size_t index = 0; index + 1 < qps.size() && result == 0; index += 2) {
+        ugdr_qp_conn_info first{};
+        ugdr_qp_conn_info second{};
+        if (ugdr_query_qp_conn_info(qps[index], &first) != 0 ||
+            ugdr_query_qp_conn_info(qps[index + 1], &second) != 0 ||
+            connect(qps[index], second.qp_num) != 0 || connect(qps[index + 1], first.qp_num) != 0) {
+            result = 8;
+        }
+    }
+    for (const bool shared_qp : {false, true}) {
+        double baseline = 0.0;
+        for (const std::size_t thread_count : kThreadCounts) {
+            if (result == 0 && !run(qps, thread_count, shared_qp, wrs_per_thread, &baseline)) {
+                result = 9;
+            }
+        }
+    }
+
+    for (ugdr_qp *qp : qps) {
+        if (ugdr_destroy_qp(qp) != 0 && result == 0) {
+            result = 10;
+        }
+    }
+    if ((ugdr_destroy_cq(cq) != 0 || ugdr_dealloc_pd(pd) != 0 || ugdr_close_device(context) != 0) &&
+        result == 0) {
+        result = 10;
+    }
+    return result;
+}
+
+bool parse_options(int argc, char **argv, std::uint64_t *wrs_per_thread) {
+    for (int index = 1; index < argc; ++index) {
+        const std::string argument = argv[index];
+        if (argument != "--wr-per-thread" || index + 1 >= argc) {
+            return false;
+        }
+        char *end = nullptr;
+        errno = 0;
+        const unsigned long long value = std::strtoull(argv[++index], &end, 10);
+        if (errno != 0 || end == argv[index] || *end != '\0' || value == 0) {
+            return false;
+        }
+        *wrs_per_thread = value;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::uint64_t wrs_per_thread = kDefaultWrsPerThread;
+    if (!parse_options(argc, argv, &wrs_per_thread)) {
+        std::printf("usage: %s [--wr-per-thread N]\n", argv[0]);
+        return 2;
+    }
+
+    char directory_template[] = "/tmp/ugdr-api-posting-scaling-XXXXXX";
+    char *const directory = ::mkdtemp(directory_template);
+    if (directory == nullptr) {
+        return 1;
+    }
+    const std::string socket_path = std::string(directory) + "/control.sock";
+    std::array<int, 2> ready_pipe{};
+    if (::pipe2(ready_pipe.data(), O_CLOEXEC) != 0) {
+        (void)::rmdir(directory);
+        return 2;
+    }
+    pid_t child = ::fork();
+    if (child < 0) {
+        (void)::close(ready_pipe[0]);
+        (void)::close(ready_pipe[1]);
+        (void)::rmdir(directory);
+        return 3;
+    }
+    if (child == 0) {
+        (void)::close(ready_pipe[0]);
+        const int result = child_main(socket_path, ready_pipe[1]);
+        (void)::close(ready_pipe[1]);
+        std::_Exit(result);
+    }
+    (void)::close(ready_pipe[1]);
+    char ready = 0;
+    const bool started = ::read(ready_pipe[0], &ready, 1) == 1 && ready == 'r';
+    (void)::close(ready_pipe[0]);
+    if (!started || ::setenv("UGDR_DAEMON_SOCKET", socket_path.c_str(), 1) != 0) {
+        terminate_process(&child);
+        (void)::rmdir(directory);
+        return 4;
+    }
+
+    const int result = run_client(wrs_per_thread);
+    terminate_process(&child);
+    (void)::unlink(socket_path.c_str());
+    (void)::rmdir(directory);
+    return result;
+}
@@ -564,8 +564,10 @@ int run_benchmark(const Options &options) {
                       : ugdr_create_cq(context, static_cast<int>(kQueueDepth), nullptr, nullptr, 0);
         receive_cq = context == nullptr ? nullptr : ugdr_create_cq(context, 1, nullptr, nullptr, 0);
         ugdr_qp_init_attr requester_attributes{
-            send_cq, send_cq, static_cast<std::uint32_t>(kQueueDepth), 1, 1, 1, UGDR_QPT_RC, 0};
-        ugdr_qp_init_attr responder_attributes{receive_cq, receive_cq, 1, 1, 1, 1, UGDR_QPT_RC, 0};
+            send_cq, send_cq, static_cast<std::uint32_t>(kQueueDepth), 1, 1, 1, UGDR_QPT_RC, 0,
+            nullptr};
+        ugdr_qp_init_attr responder_attributes{receive_cq, receive_cq, 1, 1, 1, 1, UGDR_QPT_RC, 0,
+                                               nullptr};
         requester =
             source_pd == nullptr ? nullptr : ugdr_create_qp(source_pd, &requester_attributes);
         responder =
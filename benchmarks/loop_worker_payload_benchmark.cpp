@@ -215,7 +215,7 @@ bool make_endpoint(ugdr::control::QpService &service, ugdr::ipc::SessionId sessi
 }
 
 bool connect_endpoints(ugdr::control::QpService &service, const Endpoint &first,
-                       const Endpoint &second) {
+                       const Endpoint &second, std::uint8_t rnr_retry) {
     ugdr::control::QpAttributes init;
     init.state = ugdr::control::kQpStateInit;
     init.current_state = ugdr::control::kQpStateReset;
@@ -234,7 +234,7 @@ bool connect_endpoints(ugdr::control::QpService &service, const Endpoint &first,
     ugdr::control::QpAttributes retry;
     retry.timeout = 1;
     retry.retry_count = 1;
-    retry.rnr_retry = 1;
+    retry.rnr_retry = rnr_retry;
     retry.min_rnr_timer = 1;
     return service.handle(first.session, decoded(ugdr::control::make_connect_qp_request(
                                              first.qp_identity, second.qp_num, retry,
@@ -254,8 +254,27 @@ struct BenchmarkCase {
     std::uint32_t signaling_interval = 0;
     std::uint64_t warmup = 0;
     std::uint64_t iterations = 0;
+    std::uint32_t credit_window = 0;
+    ugdr::worker::CongestionControl congestion_control = ugdr::worker::CongestionControl::none;
+    std::uint32_t receive_interval_us = 0;
+    bool report_cq_moderation = false;
+    std::uint16_t cq_count = 0;
+    std::uint16_t cq_period_us = 0;
 };
 
+struct WindowSample {
+    std::uint64_t completed_parents = 0;
+    std::uint32_t window = 0;
+    std::uint32_t outstanding_payloads = 0;
+    std::uint64_t delay_ns = 0;
+};
+
+constexpr std::size_t kWindowSamples = 16;
+
+const char *congestion_control_name(ugdr::worker::CongestionControl congestion_control) {
+    return congestion_control == ugdr::worker::CongestionControl::delay ? "delay" : "none";
+}
+
 std::uint64_t payloads_per_wr(const BenchmarkCase &parameters) {
     const std::uint32_t base = parameters.wr_bytes / parameters.sge_count;
     const std::uint32_t remainder = parameters.wr_bytes % parameters.sge_count;
@@ -299,7 +318,8 @@ bool post_one(const BenchmarkCase &parameters, const Endpoint &source, const End
     wr.wr_id = wr_id;
     wr.sg_list = sges.data();
     wr.num_sge = static_cast<int>(sges.size());
-    wr.opcode = UGDR_WR_RDMA_WRITE;
+    wr.opcode =
+        parameters.receive_interval_us == 0 ? UGDR_WR_RDMA_WRITE : UGDR_WR_RDMA_WRITE_WITH_IMM;
     if (parameters.signaling_interval != 0 && wr_id % parameters.signaling_interval == 0) {
         wr.send_flags = UGDR_SEND_SIGNALED;
     }
@@ -310,16 +330,37 @@ bool post_one(const BenchmarkCase &parameters, const Endpoint &source, const End
            bad_wr == nullptr;
 }
 
+bool post_receive(ugdr::queue::SharedRing &receive_queue, std::uint32_t max_recv_sge,
+                  std::uint64_t wr_id) {
+    ugdr_recv_wr wr{};
+    wr.wr_id = wr_id;
+    ugdr_recv_wr *bad_wr = nullptr;
+    return ugdr::api::post_receive_chain(receive_queue, max_recv_sge, &wr, &bad_wr) == 0;
+}
+
 bool run_phase(const BenchmarkCase &parameters, std::uint64_t iterations, std::uint64_t *next_wr_id,
                const Endpoint &source, const Endpoint &target,
-               ugdr::control::WorkerQpView &requester_view, ugdr::worker::LoopWorker &requester,
+               ugdr::control::WorkerQpView &requester_view,
+               ugdr::control::WorkerQpView &responder_view, ugdr::worker::LoopWorker &requester,
                ugdr::worker::LoopWorker &responder, ControlOnlyBackend &backend,
-               BenchmarkObserver &observer, double *elapsed_seconds) {
+               BenchmarkObserver &observer, double *elapsed_seconds,
+               std::vector<WindowSample> *samples = nullptr) {
     observer.reset();
     backend.reset_count();
     std::uint64_t posted = 0;
+    const std::uint64_t sample_interval = std::max<std::uint64_t>(iterations / kWindowSamples, 1);
+    std::uint64_t next_sample = 0;
+    std::uint64_t next_receive_wr_id = 1;
+    const auto receive_interval = std::chrono::microseconds(parameters.receive_interval_us);
     const auto start = Clock::now();
+    auto next_receive = start;
     while (observer.completed_parents() != iterations) {
+        if (samples != nullptr && observer.completed_parents() >= next_sample) {
+            const auto &counters = requester.flow_control_counters();
+            samples->push_back({observer.completed_parents(), counters.window,
+                                counters.outstanding_payloads, counters.last_delay_ns});
+            next_sample += sample_interval;
+        }
         while (posted != iterations &&
                posted - observer.completed_parents() < parameters.queue_depth) {
             const std::uint64_t wr_id = (*next_wr_id)++;
@@ -330,13 +371,22 @@ bool run_phase(const BenchmarkCase &parameters, std::uint64_t iterations, std::u
             }
             ++posted;
         }
+        const bool starved = parameters.receive_interval_us != 0;
+        if (starved && Clock::now() >= next_receive &&
+            post_receive(*responder_view.receive_queue, responder_view.max_recv_sge,
+                         next_receive_wr_id)) {
+            ++next_receive_wr_id;
+            next_receive += receive_interval;
+        }
         bool progressed = requester.progress_once();
         progressed = responder.progress_once() || progressed;
         progressed = backend.progress_once() || progressed;
         progressed = responder.progress_once() || progressed;
         progressed = requester.progress_once() || progressed;
         progressed = drain_cq(*requester_view.send_cq) || progressed;
-        if (!progressed) {
+        if (starved) {
+            (void)drain_cq(*responder_view.receive_cq);
+        } else if (!progressed) {
             return false;
         }
     }
@@ -362,7 +412,16 @@ bool run(const BenchmarkCase &parameters) {
                        parameters.sge_count, &requester_endpoint) ||
         !make_endpoint(service, 602, UINT64_C(0x200000000), parameters.queue_depth,
                        parameters.sge_count, &responder_endpoint) ||
-        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        !connect_endpoints(service, requester_endpoint, responder_endpoint,
+                           parameters.receive_interval_us == 0
+                               ? 1
+                               : ugdr::worker::LoopWorker::kInfiniteRnrRetry) ||
+        service
+                .handle(requester_endpoint.session,
+                        decoded(ugdr::control::make_modify_cq_request(
+                            requester_endpoint.cq_identity,
+                            {parameters.cq_count, parameters.cq_period_us})))
+                .response.status != 0) {
         return false;
     }
 
@@ -371,28 +430,38 @@ bool run(const BenchmarkCase &parameters) {
     ugdr::worker::LocalTransport transport(parameters.queue_depth, parameters.queue_depth);
     ControlOnlyBackend backend(std::max<std::size_t>(backend_capacity, 1));
     BenchmarkObserver observer;
+    ugdr::worker::FlowControlOptions flow_control;
+    flow_control.credit_window = parameters.credit_window;
+    flow_control.congestion_control = parameters.congestion_control;
+    flow_control.target_delay = std::chrono::microseconds(20);
     ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
                                        ugdr::worker::LoopWorkerRole::requester,
-                                       parameters.payload_bytes, &observer);
+                                       parameters.payload_bytes, &observer, flow_control);
     ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
                                        ugdr::worker::LoopWorkerRole::responder,
-                                       parameters.payload_bytes);
+                                       parameters.payload_bytes, nullptr, flow_control);
     ugdr::control::WorkerQpView requester_view;
-    if (service.worker_qp_view(requester_endpoint.qp_num, &requester_view) != 0) {
+    ugdr::control::WorkerQpView responder_view;
+    if (service.worker_qp_view(requester_endpoint.qp_num, &requester_view) != 0 ||
+        service.worker_qp_view(responder_endpoint.qp_num, &responder_view) != 0) {
         return false;
     }
 
     std::uint64_t next_wr_id = 1;
     double warmup_seconds = 0.0;
     if (!run_phase(parameters, parameters.warmup, &next_wr_id, requester_endpoint,
-                   responder_endpoint, requester_view, requester, responder, backend, observer,
-                   &warmup_seconds)) {
+                   responder_endpoint, requester_view, responder_view, requester, responder,
+                   backend, observer, &warmup_seconds)) {
         return false;
     }
     double elapsed_seconds = 0.0;
+    std::vector<WindowSample> samples;
+    const bool flow_controlled = parameters.credit_window != 0 ||
+                                 parameters.congestion_control !=
+                                     ugdr::worker::CongestionControl::none;
     if (!run_phase(parameters, parameters.iterations, &next_wr_id, requester_endpoint,
-                   responder_endpoint, requester_view, requester, responder, backend, observer,
-                   &elapsed_seconds)) {
+                   responder_endpoint, requester_view, responder_view, requester, responder,
+                   backend, observer, &elapsed_seconds, flow_controlled ? &samples : nullptr)) {
         return false;
     }
 
@@ -431,6 +500,56 @@ bool run(const BenchmarkCase &parameters) {
                 static_cast<unsigned long long>(backend.completed_tasks()),
                 static_cast<unsigned long long>(observer.logical_bytes()), parent_mwr,
                 payload_mtask, logical_gb, p50, p99, latencies.size());
+    if (parameters.report_cq_moderation) {
+        std::printf("benchmark=loop_worker_cq_moderation build_type=%s wr_bytes=%u "
+                    "queue_depth=%u signaling_interval=%u cq_count=%u cq_period_us=%u "
+                    "parent_MWR_per_s=%.6f wr_p50_us=%.3f wr_p99_us=%.3f\n",
+                    UGDR_BENCHMARK_BUILD_TYPE, parameters.wr_bytes, parameters.queue_depth,
+                    parameters.signaling_interval, parameters.cq_count, parameters.cq_period_us,
+                    parent_mwr, p50, p99);
+    }
+    if (parameters.receive_interval_us != 0) {
+        const auto &retries = requester.retry_counters();
+        const auto &responder_retries = responder.retry_counters();
+        std::printf("benchmark=loop_worker_rnr build_type=%s wr_bytes=%u queue_depth=%u "
+                    "receive_interval_us=%u parent_MWR_per_s=%.6f wr_p50_us=%.3f wr_p99_us=%.3f "
+                    "rnr_naks_sent=%llu rnr_naks_received=%llu rnr_retry_exhausted=%llu "
+                    "retransmitted_parent_wr=%llu discarded_requests=%llu\n",
+                    UGDR_BENCHMARK_BUILD_TYPE, parameters.wr_bytes, parameters.queue_depth,
+                    parameters.receive_interval_us, parent_mwr, p50, p99,
+                    static_cast<unsigned long long>(responder_retries.rnr_naks_sent),
+                    static_cast<unsigned long long>(retries.rnr_naks_received),
+                    static_cast<unsigned long long>(retries.rnr_retry_exhausted),
+                    static_cast<unsigned long long>(retries.retransmitted_parents),
+                    static_cast<unsigned long long>(responder_retries.discarded_requests));
+    }
+    if (!flow_controlled) {
+        return true;
+    }
+    const auto &counters = requester.flow_control_counters();
+    std::printf("benchmark=loop_worker_flow_control build_type=%s wr_bytes=%u payload_bytes=%u "
+                "queue_depth=%u credit_window=%u congestion_control=%s window=%u "
+                "window_min=%u window_peak=%u credit_stalls=%llu window_increases=%llu "
+                "window_decreases=%llu peak_outstanding_payloads=%u admitted_parent_wr=%llu\n",
+                UGDR_BENCHMARK_BUILD_TYPE, parameters.wr_bytes, parameters.payload_bytes,
+                parameters.queue_depth, parameters.credit_window,
+                congestion_control_name(parameters.congestion_control), counters.window,
+                counters.minimum_window, counters.peak_window,
+                static_cast<unsigned long long>(counters.credit_stalls),
+                static_cast<unsigned long long>(counters.window_increases),
+                static_cast<unsigned long long>(counters.window_decreases),
+                counters.peak_outstanding_payloads,
+                static_cast<unsigned long long>(counters.admitted_parents));
+    for (std::size_t index = 0; index < samples.size(); ++index) {
+        std::printf("benchmark=loop_worker_flow_control_window credit_window=%u "
+                    "congestion_control=%s sample=%zu completed_parent_wr=%llu window=%u "
+                    "outstanding_payloads=%u delay_ns=%llu\n",
+                    parameters.credit_window,
+                    congestion_control_name(parameters.congestion_control), index,
+                    static_cast<unsigned long long>(samples[index].completed_parents),
+                    samples[index].window, samples[index].outstanding_payloads,
+                    static_cast<unsigned long long>(samples[index].delay_ns));
+    }
     return true;
 }
 
@@ -442,6 +561,19 @@ int main() {
         BenchmarkCase{65536, 8192, 1, 64, 32, 1000, 10000},
         BenchmarkCase{65536, 8192, 4, 64, 32, 1000, 10000},
         BenchmarkCase{65536, 4096, 4, 64, 0, 1000, 10000},
+        BenchmarkCase{65536, 8192, 1, 64, 32, 1000, 10000, 64},
+        BenchmarkCase{65536, 8192, 1, 64, 32, 1000, 10000, 256,
+                      ugdr::worker::CongestionControl::delay},
+        BenchmarkCase{4096, 8192, 1, 32, 1, 100, 2000, 0, ugdr::worker::CongestionControl::none,
+                      5},
+        BenchmarkCase{4096, 8192, 1, 32, 1, 100, 2000, 0, ugdr::worker::CongestionControl::none,
+                      50},
+        BenchmarkCase{64, 8192, 1, 64, 1, 1000, 50000, 0, ugdr::worker::CongestionControl::none,
+                      0, true},
+        BenchmarkCase{64, 8192, 1, 64, 1, 1000, 50000, 0, ugdr::worker::CongestionControl::none,
+                      0, true, 16, 8},
+        BenchmarkCase{64, 8192, 1, 64, 1, 1000, 50000, 0, ugdr::worker::CongestionControl::none,
+                      0, true, 32, 0},
     };
     for (const auto &parameters : cases) {
         if (!run(parameters)) {
@@ -0,0 +1,135 @@
+#include "control/pd_mr_cq.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+constexpr ugdr::ipc::SessionId kSession = 1;
+constexpr std::uint64_t kMrLength = 4096;
+constexpr std::size_t kLookups = 1U << 22U;
+
+std::uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+class NullCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &memory,
+             ugdr::gpu::CudaIpcMapping *mapping) override {
+        mapping->gpu_uuid = memory.gpu_uuid;
+        mapping->daemon_base_address = UINT64_C(0x800000000000) + memory.client_address;
+        return 0;
+    }
+
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return 0;
+    }
+};
+
+ugdr::control::DecodedControlRequest decoded(ugdr::control::UgdrControlRequest request) {
+    ugdr::control::DecodedControlRequest value;
+    value.value = std::move(request);
+    return value;
+}
+
+struct Registered {
+    std::uint32_t lkey = 0;
+    std::uint64_t address = 0;
+};
+
+bool run_case(std::size_t mr_count) {
+    NullCudaBackend backend;
+    ugdr::control::PdMrCqService service(backend);
+    const auto context =
+        service.handle(kSession, decoded(ugdr::control::make_create_context_request(1)));
+    const auto pd = service.handle(kSession, decoded(ugdr::control::make_create_pd_request(
+                                                 context.response.object_identity)));
+    if (context.response.status != 0 || pd.response.status != 0) {
+        return false;
+    }
+    const std::uint64_t pd_identity = pd.response.object_identity;
+
+    ugdr::gpu::ExportedCudaMemory memory;
+    memory.gpu_uuid[0] = 1;
+    memory.allocation_size = kMrLength;
+    memory.length = kMrLength;
+    memory.ipc_handle.resize(64, std::byte{0x5a});
+    std::vector<Registered> registered;
+    registered.reserve(mr_count);
+    for (std::size_t index = 0; index < mr_count; ++index) {
+        memory.client_address =
+            UINT64_C(0x10000000) + static_cast<std::uint64_t>(index) * kMrLength;
+        const auto result = service.handle(
+            kSession, decoded(ugdr::control::make_register_mr_request(
+                          pd_identity, memory, ugdr::control::kAccessLocalWrite)));
+        ugdr::control::MrRegistrationResult accepted;
+        if (result.response.status != 0 ||
+            ugdr::control::decode_mr_registration_result(result.response.opaque, &accepted) != 0) {
+            return false;
+        }
+        registered.push_back({accepted.lkey, accepted.client_address});
+    }
+
+    // Random order, so large tables pay their real cache and TLB misses.
+    std::mt19937_64 random(mr_count);
+    std::vector<std::uint32_t> order(kLookups);
+    for (std::uint32_t &value : order) {
+        value = static_cast<std::uint32_t>(random() % mr_count);
+    }
+    std::uint64_t checksum = 0;
+    std::uint64_t daemon_address = 0;
+    const std::uint64_t cycle_begin = read_cycles();
+    const auto begin = std::chrono::steady_clock::now();
+    for (const std::uint32_t index : order) {
+        const Registered &mr = registered[index];
+        if (service.resolve_lkey(kSession, pd_identity, mr.lkey, mr.address + 64, 64,
+                                 &daemon_address) != 0) {
+            return false;
+        }
+        checksum += daemon_address;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const std::uint64_t cycle_end = read_cycles();
+    if (checksum == 0) {
+        return false;
+    }
+
+    const double lookups = static_cast<double>(kLookups);
+    std::cout << "benchmark=mr_key_translation"
+              << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+              << " cpu_threads=" << std::thread::hardware_concurrency() << " mrs=" << mr_count
+              << " lookups=" << kLookups << std::fixed << std::setprecision(3) << " ns_per_resolve="
+              << std::chrono::duration<double, std::nano>(end - begin).count() / lookups
+              << " cycles_per_resolve=" << static_cast<double>(cycle_end - cycle_begin) / lookups
+              << '\n';
+    service.on_disconnect(kSession);
+    return service.mr_count() == 0;
+}
+
+}  // namespace
+
+int main() {
+    for (const std::size_t mr_count : {1U, 64U, 4096U, 65536U, 1048576U}) {
+        if (!run_case(mr_count)) {
+            return 1;
+        }
+    }
+    return 0;
+}
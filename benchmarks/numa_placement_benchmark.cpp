@@ -0,0 +1,122 @@
+#include "queue/numa.hpp"
+#include "queue/shared_ring.hpp"
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// A 16 MiB completion ring: larger than most last-level caches, so polls reach memory.
+constexpr ugdr::queue::QueueDescriptor kCompletionRing{ugdr::queue::QueueKind::completion, 262144,
+                                                       64};
+constexpr std::uint32_t kPollBatch = 32;
+constexpr std::uint64_t kPollLaps = 16;
+constexpr int kMaxProbedNodes = 64;
+
+// Node ids are not always dense, so probe until every online node is found.
+std::vector<int> online_nodes() {
+    const int count = ugdr::queue::numa_node_count();
+    std::vector<int> nodes;
+    for (int node = 0; node < kMaxProbedNodes && static_cast<int>(nodes.size()) < count; ++node) {
+        if (ugdr::queue::pin_thread_to_numa_node(node) == 0) {
+            nodes.push_back(node);
+        }
+    }
+    return nodes;
+}
+
+// Places the ring on memory_node, then produces and polls it from a thread on thread_node.
+bool run_case(int memory_node, int thread_node, std::size_t node_count) {
+    if (ugdr::queue::pin_thread_to_numa_node(thread_node) != 0) {
+        return false;
+    }
+    ugdr::queue::RingMemoryOptions options;
+    options.numa_node = memory_node;
+    ugdr::queue::SharedRing producer;
+    ugdr::queue::SharedRing poller;
+    int descriptor_fd = -1;
+    if (ugdr::queue::create_shared_ring(kCompletionRing, &producer, options) != 0 ||
+        producer.duplicate_fd(&descriptor_fd) != 0) {
+        return false;
+    }
+    const int map_status = ugdr::queue::map_shared_ring(descriptor_fd, kCompletionRing, &poller);
+    (void)::close(descriptor_fd);
+    if (map_status != 0) {
+        return false;
+    }
+
+    const std::uint64_t total = kPollLaps * kCompletionRing.capacity;
+    std::uint64_t checksum = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::uint64_t produced = 0; produced < total; produced += kPollBatch) {
+        ugdr::queue::MutableSlotBatch reserved;
+        ugdr::queue::ConstSlotBatch visible;
+        if (producer.producer_reserve(kPollBatch, &reserved) != 0) {
+            return false;
+        }
+        auto *written = static_cast<std::uint64_t *>(reserved.first.data);
+        for (std::uint32_t index = 0; index < reserved.first.count; ++index) {
+            written[index * kCompletionRing.slot_stride / sizeof(std::uint64_t)] = produced + index;
+        }
+        if (producer.producer_publish(reserved.count) != 0 ||
+            poller.consumer_peek(kPollBatch, &visible) != 0) {
+            return false;
+        }
+        const auto *slots = static_cast<const std::uint64_t *>(visible.first.data);
+        for (std::uint32_t index = 0; index < visible.first.count; ++index) {
+            checksum += slots[index * kCompletionRing.slot_stride / sizeof(std::uint64_t)];
+        }
+        if (poller.consumer_release(visible.count) != 0) {
+            return false;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+
+    std::cout << "benchmark=numa_ring_placement"
+              << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+              << " cpu_threads=" << std::thread::hardware_concurrency()
+              << " numa_nodes=" << node_count << " memory_node=" << memory_node
+              << " thread_node=" << thread_node
+              << " placement=" << (memory_node == thread_node ? "local" : "remote")
+              << " ring_bytes=" << producer.mapping_size() << std::fixed << std::setprecision(3)
+              << " poll_mcqe_per_s=" << static_cast<double>(total) / seconds / 1e6
+              << " checksum=" << checksum << '\n';
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) != 0) {
+        return 1;
+    }
+    const std::vector<int> nodes = online_nodes();
+    if (nodes.empty()) {
+        // No sysfs node topology at all: measure unplaced memory and an unpinned thread.
+        return run_case(ugdr::queue::kNoNumaNode, ugdr::queue::kNoNumaNode, 1) ? 0 : 1;
+    }
+    for (const int memory_node : nodes) {
+        for (const int thread_node : nodes) {
+            if (!run_case(memory_node, thread_node, nodes.size())) {
+                return 1;
+            }
+        }
+    }
+    if (nodes.size() == 1) {
+        std::cout << "benchmark=numa_ring_placement"
+                  << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+                  << " cpu_threads=" << std::thread::hardware_concurrency()
+                  << " numa_nodes=1 placement=remote skipped=single_node\n";
+    }
+    return sched_setaffinity(0, sizeof(original), &original) == 0 ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+#include "control/concurrent_registry.hpp"
+#include "control/object_registry.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t kObjects = 1024;
+constexpr std::chrono::milliseconds kDuration{250};
+constexpr ugdr::control::OwnerSessionId kSession = 1;
+
+struct Record {
+    std::uint64_t value = 0;
+};
+
+using Concurrent =
+    ugdr::control::ConcurrentGenerationRegistry<Record, ugdr::control::ObjectType::qp>;
+using Plain = ugdr::control::GenerationRegistry<Record, ugdr::control::ObjectType::qp>;
+
+// The baseline a multi-threaded daemon would otherwise need: the plain registry behind a
+// reader-writer lock.
+class LockedRegistry {
+  public:
+    std::optional<std::uint64_t> insert(Record record) {
+        std::unique_lock lock(mutex_);
+        return registry_.insert(kSession, record);
+    }
+
+    int erase(std::uint64_t identity) {
+        std::unique_lock lock(mutex_);
+        return registry_.erase(kSession, identity);
+    }
+
+    std::uint64_t read(std::uint64_t identity) {
+        std::shared_lock lock(mutex_);
+        const Record *const record = registry_.resolve(kSession, identity);
+        return record != nullptr ? record->value : 0;
+    }
+
+    std::optional<std::uint32_t> register_reader() {
+        return 0;
+    }
+
+    void quiescent(std::uint32_t) {
+    }
+
+    void unregister_reader(std::uint32_t) {
+    }
+
+  private:
+    std::shared_mutex mutex_;
+    Plain registry_;
+};
+
+class QsbrRegistry {
+  public:
+    std::optional<std::uint64_t> insert(Record record) {
+        return registry_.insert(kSession, record);
+    }
+
+    int erase(std::uint64_t identity) {
+        return registry_.erase(kSession, identity);
+    }
+
+    std::uint64_t read(std::uint64_t identity) {
+        const Record *const record = registry_.resolve(kSession, identity);
+        return record != nullptr ? record->value : 0;
+    }
+
+    std::optional<std::uint32_t> register_reader() {
+        return registry_.register_reader();
+    }
+
+    void quiescent(std::uint32_t reader) {
+        registry_.quiescent(reader);
+    }
+
+    void unregister_reader(std::uint32_t reader) {
+        registry_.unregister_reader(reader);
+    }
+
+  private:
+    Concurrent registry_;
+};
+
+// One quiescent point per batch of lookups stands in for a worker loop iteration.
+template <typename Registry>
+void reader_loop(Registry &registry, std::uint32_t reader, const std::atomic<bool> &stop,
+                 const std::vector<std::atomic<std::uint64_t>> &identities, std::uint64_t *reads,
+                 std::uint64_t *checksum) {
+    const auto id = registry.register_reader();
+    if (!id.has_value()) {
+        return;
+    }
+    std::uint32_t index = reader * 97U;
+    while (!stop.load(std::memory_order_relaxed)) {
+        for (int batch = 0; batch < 64; ++batch) {
+            *checksum +=
+                registry.read(identities[index % kObjects].load(std::memory_order_acquire));
+            ++index;
+        }
+        *reads += 64;
+        registry.quiescent(*id);
+    }
+    registry.unregister_reader(*id);
+}
+
+template <typename Registry>
+bool run_case(std::string_view name, unsigned reader_count) {
+    Registry registry;
+    std::vector<std::atomic<std::uint64_t>> identities(kObjects);
+    for (std::uint32_t index = 0; index < kObjects; ++index) {
+        const auto identity = registry.insert(Record{index + 1U});
+        if (!identity.has_value()) {
+            return false;
+        }
+        identities[index].store(*identity, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<std::uint64_t> reads(reader_count);
+    std::vector<std::uint64_t> checksums(reader_count);
+    std::vector<std::thread> readers;
+    for (unsigned reader = 0; reader < reader_count; ++reader) {
+        readers.emplace_back([&, reader] {
+            reader_loop(registry, reader, stop, identities, &reads[reader], &checksums[reader]);
+        });
+    }
+    std::uint64_t writes = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    auto now = begin;
+    while (now - begin < kDuration) {
+        const std::uint32_t index = static_cast<std::uint32_t>(writes % kObjects);
+        if (registry.erase(identities[index].load(std::memory_order_relaxed)) != 0) {
+            stop.store(true);
+            break;
+        }
+        const auto identity = registry.insert(Record{index + 1U});
+        if (!identity.has_value()) {
+            stop.store(true);
+            break;
+        }
+        identities[index].store(*identity, std::memory_order_release);
+        ++writes;
+        now = std::chrono::steady_clock::now();
+    }
+    stop.store(true);
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    const double seconds = std::chrono::duration<double>(now - begin).count();
+    std::uint64_t total_reads = 0;
+    for (const std::uint64_t count : reads) {
+        total_reads += count;
+    }
+    std::cout << "benchmark=registry_contention"
+              << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+              << " cpu_threads=" << std::thread::hardware_concurrency() << " registry=" << name
+              << " readers=" << reader_count << " objects=" << kObjects << std::fixed
+              << std::setprecision(3)
+              << " M_resolves_per_s=" << static_cast<double>(total_reads) / seconds / 1e6
+              << " M_resolves_per_s_per_reader="
+              << static_cast<double>(total_reads) / seconds / 1e6 / reader_count
+              << " K_writes_per_s=" << static_cast<double>(writes) / seconds / 1e3 << '\n';
+    return writes != 0 && total_reads != 0;
+}
+
+}  // namespace
+
+int main() {
+    for (const unsigned readers : {1U, 2U, 4U, 8U}) {
+        if (!run_case<LockedRegistry>("shared_mutex", readers) ||
+            !run_case<QsbrRegistry>("concurrent", readers)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include "control/qp.hpp"
+#include "queue/descriptors.hpp"
+#include "queue/ring_arena.hpp"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr ugdr::ipc::SessionId kSession = 1;
+constexpr std::size_t kQueuePairs = 4096;
+constexpr std::uint32_t kQueueDepth = 64;
+constexpr std::uint32_t kMaxSge = 1;
+
+class NullCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &, ugdr::gpu::CudaIpcMapping *) override {
+        return 0;
+    }
+
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return 0;
+    }
+};
+
+ugdr::control::DecodedControlRequest decoded(ugdr::control::UgdrControlRequest request) {
+    ugdr::control::DecodedControlRequest value;
+    value.value = std::move(request);
+    return value;
+}
+
+// The decoded response a client would receive: the same bytes, with the fds it would own.
+ugdr::control::DecodedControlResponse as_received(ugdr::control::ControlServiceResult &result) {
+    ugdr::control::DecodedControlResponse response;
+    response.value = std::move(result.response);
+    response.file_descriptors = std::move(result.file_descriptors);
+    return response;
+}
+
+std::size_t open_fds() {
+    std::size_t count = 0;
+    if (DIR *const directory = opendir("/proc/self/fd"); directory != nullptr) {
+        while (readdir(directory) != nullptr) {
+            ++count;
+        }
+        closedir(directory);
+    }
+    return count;
+}
+
+std::size_t mappings() {
+    std::ifstream maps("/proc/self/maps");
+    std::size_t count = 0;
+    for (std::string line; std::getline(maps, line);) {
+        ++count;
+    }
+    return count;
+}
+
+// Creates kQueuePairs QPs through the daemon service and maps both rings of each on the client
+// side, so the fd and mapping counts cover one daemon and one client process together.
+bool run_case(bool arena_enabled) {
+    NullCudaBackend backend;
+    ugdr::control::QpService service(backend);
+    const auto context =
+        service.handle(kSession, decoded(ugdr::control::make_create_context_request(1)));
+    const std::uint64_t context_identity = context.response.object_identity;
+    std::shared_ptr<ugdr::queue::SharedRingArena> client_arena;
+    if (arena_enabled) {
+        const auto arena = service.handle(
+            kSession, decoded(ugdr::control::make_map_ring_arena_request(
+                          context_identity, ugdr::queue::kMaxRingArenaBytes)));
+        if (arena.response.status != 0 || arena.file_descriptors.size() != 1) {
+            return false;
+        }
+        const int descriptor = arena.file_descriptors[0].get();
+        if (ugdr::queue::SharedRingArena::map(descriptor, &client_arena) != 0) {
+            return false;
+        }
+    }
+    const auto pd =
+        service.handle(kSession, decoded(ugdr::control::make_create_pd_request(context_identity)));
+    const auto cq = service.handle(
+        kSession, decoded(ugdr::control::make_create_cq_request(context_identity, 1024)));
+    if (context.response.status != 0 || pd.response.status != 0 || cq.response.status != 0) {
+        return false;
+    }
+    const ugdr::control::QpCreateAttributes attributes{
+        cq.response.object_identity, cq.response.object_identity, kQueueDepth, kQueueDepth,
+        kMaxSge,                     kMaxSge,                     ugdr::control::kQpTypeRc};
+    std::uint32_t send_stride = 0;
+    std::uint32_t receive_stride = 0;
+    if (ugdr::queue::send_slot_stride(kMaxSge, &send_stride) != 0 ||
+        ugdr::queue::receive_slot_stride(kMaxSge, &receive_stride) != 0) {
+        return false;
+    }
+    const std::vector<ugdr::queue::QueueDescriptor> expected{
+        {ugdr::queue::QueueKind::send, kQueueDepth, send_stride},
+        {ugdr::queue::QueueKind::receive, kQueueDepth, receive_stride}};
+
+    const std::size_t fds_before = open_fds();
+    const std::size_t mappings_before = mappings();
+    std::vector<std::vector<ugdr::queue::SharedRing>> client_rings;
+    client_rings.reserve(kQueuePairs);
+    std::vector<double> samples;
+    samples.reserve(kQueuePairs);
+    for (std::size_t index = 0; index < kQueuePairs; ++index) {
+        const auto begin = std::chrono::steady_clock::now();
+        auto qp = service.handle(kSession, decoded(ugdr::control::make_create_qp_request(
+                                               pd.response.object_identity, attributes)));
+        if (qp.response.status != 0) {
+            return false;
+        }
+        std::vector<ugdr::queue::SharedRing> rings;
+        const auto response = as_received(qp);
+        if (ugdr::control::map_queue_rings(response, expected, {client_arena}, &rings) != 0) {
+            return false;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+        client_rings.push_back(std::move(rings));
+    }
+    const std::size_t fds = open_fds() - fds_before;
+    const std::size_t mapped = mappings() - mappings_before;
+
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](double value) {
+        return samples[static_cast<std::size_t>(value * static_cast<double>(samples.size() - 1))];
+    };
+    std::cout << "benchmark=create_qp_ring_arena"
+              << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+              << " cpu_threads=" << std::thread::hardware_concurrency()
+              << " arena=" << (arena_enabled ? "on" : "off") << " queue_pairs=" << kQueuePairs
+              << " queue_depth=" << kQueueDepth << " fds=" << fds << " mappings=" << mapped
+              << std::fixed << std::setprecision(3) << " p50_us=" << percentile(0.50)
+              << " p99_us=" << percentile(0.99) << '\n';
+    client_rings.clear();
+    service.on_disconnect(kSession);
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    for (const bool arena_enabled : {false, true}) {
+        if (!run_case(arena_enabled)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "queue/shared_ring.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kRounds = 256;
+// A 1 MiB send ring: large enough for huge pages, and its first lap touches every page.
+constexpr ugdr::queue::QueueDescriptor kSendRing{ugdr::queue::QueueKind::send, 4096, 256};
+// A 4 MiB completion ring, polled lap after lap once it is warm.
+constexpr ugdr::queue::QueueDescriptor kCompletionRing{ugdr::queue::QueueKind::completion, 65536,
+                                                       64};
+constexpr std::uint32_t kPollBatch = 32;
+constexpr std::uint64_t kPollLaps = 64;
+
+struct Case {
+    const char *name;
+    ugdr::queue::RingMemoryOptions options;
+};
+
+// Creates a ring the way the daemon does and maps it the way a client does.
+bool create_pair(const ugdr::queue::QueueDescriptor &descriptor,
+                 const ugdr::queue::RingMemoryOptions &options, ugdr::queue::SharedRing *daemon,
+                 ugdr::queue::SharedRing *client) {
+    int descriptor_fd = -1;
+    if (ugdr::queue::create_shared_ring(descriptor, daemon, options) != 0 ||
+        daemon->duplicate_fd(&descriptor_fd) != 0) {
+        return false;
+    }
+    const int status =
+        ugdr::queue::map_shared_ring(descriptor_fd, descriptor, client, {false, options.prefault});
+    (void)::close(descriptor_fd);
+    return status == 0;
+}
+
+// Posts one full lap through a fresh client mapping, the page faults of which land on the first
+// posts of a new QP.
+bool first_lap(ugdr::queue::SharedRing &client, ugdr::queue::SharedRing &daemon) {
+    for (std::uint32_t index = 0; index < kSendRing.capacity; ++index) {
+        void *slot = nullptr;
+        if (client.producer_reserve(&slot) != 0) {
+            return false;
+        }
+        std::memcpy(slot, &index, sizeof(index));
+        if (client.producer_publish() != 0) {
+            return false;
+        }
+    }
+    ugdr::queue::ConstSlotBatch batch;
+    return daemon.consumer_peek(kSendRing.capacity, &batch) == 0 &&
+           daemon.consumer_release(batch.count) == 0;
+}
+
+double percentile(std::vector<double> &samples, double value) {
+    std::sort(samples.begin(), samples.end());
+    return samples[static_cast<std::size_t>(value * static_cast<double>(samples.size() - 1))];
+}
+
+bool run_case(const Case &test_case) {
+    const long page = sysconf(_SC_PAGESIZE);
+    std::size_t huge_size = 0;
+    if (page <= 0 || ugdr::queue::shared_ring_mapping_size(
+                         kSendRing, ugdr::queue::kSharedRingHugePageBytes, &huge_size) != 0) {
+        return false;
+    }
+    std::vector<double> map_samples;
+    std::vector<double> post_samples;
+    map_samples.reserve(kRounds);
+    post_samples.reserve(kRounds);
+    std::size_t ring_bytes = 0;
+    for (std::size_t round = 0; round < kRounds; ++round) {
+        ugdr::queue::SharedRing daemon;
+        ugdr::queue::SharedRing client;
+        const auto begin = std::chrono::steady_clock::now();
+        if (!create_pair(kSendRing, test_case.options, &daemon, &client)) {
+            return false;
+        }
+        const auto mapped = std::chrono::steady_clock::now();
+        if (!first_lap(client, daemon)) {
+            return false;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        ring_bytes = daemon.mapping_size();
+        map_samples.push_back(std::chrono::duration<double, std::micro>(mapped - begin).count());
+        post_samples.push_back(std::chrono::duration<double, std::micro>(end - mapped).count());
+    }
+
+    // Steady state: the daemon side writes completions and the client side polls them. Batches
+    // divide the capacity, so neither side ever sees a wrapped batch.
+    ugdr::queue::SharedRing producer;
+    ugdr::queue::SharedRing poller;
+    if (!create_pair(kCompletionRing, test_case.options, &producer, &poller)) {
+        return false;
+    }
+    const std::uint64_t total = kPollLaps * kCompletionRing.capacity;
+    std::uint64_t checksum = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::uint64_t produced = 0; produced < total; produced += kPollBatch) {
+        ugdr::queue::MutableSlotBatch reserved;
+        ugdr::queue::ConstSlotBatch visible;
+        if (producer.producer_reserve(kPollBatch, &reserved) != 0) {
+            return false;
+        }
+        auto *written = static_cast<std::uint64_t *>(reserved.first.data);
+        for (std::uint32_t index = 0; index < reserved.first.count; ++index) {
+            written[index * kCompletionRing.slot_stride / sizeof(std::uint64_t)] = produced + index;
+        }
+        if (producer.producer_publish(reserved.count) != 0 ||
+            poller.consumer_peek(kPollBatch, &visible) != 0) {
+            return false;
+        }
+        const auto *slots = static_cast<const std::uint64_t *>(visible.first.data);
+        for (std::uint32_t index = 0; index < visible.first.count; ++index) {
+            checksum += slots[index * kCompletionRing.slot_stride / sizeof(std::uint64_t)];
+        }
+        if (poller.consumer_release(visible.count) != 0) {
+            return false;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+
+    std::cout << "benchmark=shared_ring_memory"
+              << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+              << " cpu_threads=" << std::thread::hardware_concurrency()
+              << " options=" << test_case.name
+              << " huge_backed=" << (ring_bytes == huge_size ? "yes" : "no")
+              << " rounds=" << kRounds << " ring_bytes=" << ring_bytes << std::fixed
+              << std::setprecision(3) << " map_p50_us=" << percentile(map_samples, 0.50)
+              << " first_lap_p50_us=" << percentile(post_samples, 0.50)
+              << " first_lap_p99_us=" << percentile(post_samples, 0.99)
+              << " poll_mcqe_per_s=" << static_cast<double>(total) / seconds / 1e6
+              << " checksum=" << checksum << '\n';
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    const Case cases[] = {{"default", {false, false}},
+                          {"prefault", {false, true}},
+                          {"huge", {true, false}},
+                          {"huge_prefault", {true, true}}};
+    for (const Case &test_case : cases) {
+        if (!run_case(test_case)) {
+            return 1;
+        }
+    }
+    return 0;
+}
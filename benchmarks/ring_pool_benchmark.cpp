@@ -0,0 +1,104 @@
+#include "control/qp.hpp"
+#include "queue/ring_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr ugdr::ipc::SessionId kSession = 1;
+constexpr std::size_t kRounds = 1000;
+constexpr std::uint32_t kQueueDepth = 256;
+constexpr std::uint32_t kMaxSge = 4;
+// Clients create QPs between other work; the pause also lets the refill thread run.
+constexpr auto kPause = std::chrono::microseconds(200);
+
+class NullCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &, ugdr::gpu::CudaIpcMapping *) override {
+        return 0;
+    }
+
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return 0;
+    }
+};
+
+ugdr::control::DecodedControlRequest decoded(ugdr::control::UgdrControlRequest request) {
+    ugdr::control::DecodedControlRequest value;
+    value.value = std::move(request);
+    return value;
+}
+
+bool run_case(bool pooled) {
+    NullCudaBackend backend;
+    ugdr::queue::SharedRingPool pool;
+    ugdr::control::QpService service(backend);
+    if (pooled) {
+        if (pool.start() != 0) {
+            return false;
+        }
+        service.set_ring_pool(&pool);
+    }
+    const auto context =
+        service.handle(kSession, decoded(ugdr::control::make_create_context_request(1)));
+    const auto pd = service.handle(kSession, decoded(ugdr::control::make_create_pd_request(
+                                                 context.response.object_identity)));
+    const auto cq = service.handle(kSession, decoded(ugdr::control::make_create_cq_request(
+                                                 context.response.object_identity, 1024)));
+    if (context.response.status != 0 || pd.response.status != 0 || cq.response.status != 0) {
+        return false;
+    }
+    const ugdr::control::QpCreateAttributes attributes{
+        cq.response.object_identity, cq.response.object_identity, kQueueDepth, kQueueDepth,
+        kMaxSge,                     kMaxSge,                     ugdr::control::kQpTypeRc};
+
+    std::vector<double> samples;
+    samples.reserve(kRounds);
+    for (std::size_t round = 0; round < kRounds; ++round) {
+        std::this_thread::sleep_for(kPause);
+        const auto begin = std::chrono::steady_clock::now();
+        const auto qp = service.handle(kSession, decoded(ugdr::control::make_create_qp_request(
+                                                     pd.response.object_identity, attributes)));
+        const auto end = std::chrono::steady_clock::now();
+        if (qp.response.status != 0 ||
+            service
+                    .handle(kSession, decoded(ugdr::control::make_destroy_qp_request(
+                                          qp.response.object_identity)))
+                    .response.status != 0) {
+            return false;
+        }
+        samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](double value) {
+        return samples[static_cast<std::size_t>(value * static_cast<double>(samples.size() - 1))];
+    };
+    std::cout << "benchmark=create_qp_ring_pool"
+              << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+              << " cpu_threads=" << std::thread::hardware_concurrency()
+              << " pool=" << (pooled ? "on" : "off") << " queue_depth=" << kQueueDepth
+              << " rounds=" << kRounds << " pool_hits=" << pool.hits() << std::fixed
+              << std::setprecision(3) << " p50_us=" << percentile(0.50)
+              << " p99_us=" << percentile(0.99) << '\n';
+    service.on_disconnect(kSession);
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    for (const bool pooled : {false, true}) {
+        if (!run_case(pooled)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "control/qp.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kNeighborSessions = 100;
+constexpr std::size_t kClientMrs = 8;
+constexpr std::size_t kRounds = 512;
+
+class NullCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &memory,
+             ugdr::gpu::CudaIpcMapping *mapping) override {
+        mapping->gpu_uuid = memory.gpu_uuid;
+        mapping->daemon_base_address = UINT64_C(0x800000000000);
+        return 0;
+    }
+
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return 0;
+    }
+};
+
+ugdr::control::DecodedControlRequest decoded(ugdr::control::UgdrControlRequest request) {
+    ugdr::control::DecodedControlRequest value;
+    value.value = std::move(request);
+    return value;
+}
+
+bool open_session(ugdr::control::QpService &service, ugdr::ipc::SessionId session,
+                  std::size_t mr_count) {
+    const auto context =
+        service.handle(session, decoded(ugdr::control::make_create_context_request(1)));
+    const auto pd = service.handle(session, decoded(ugdr::control::make_create_pd_request(
+                                                context.response.object_identity)));
+    if (context.response.status != 0 || pd.response.status != 0) {
+        return false;
+    }
+    ugdr::gpu::ExportedCudaMemory memory;
+    memory.gpu_uuid[0] = 1;
+    memory.client_address = UINT64_C(0x10000000);
+    memory.allocation_size = 4096;
+    memory.length = 4096;
+    memory.ipc_handle.resize(64, std::byte{0x5a});
+    for (std::size_t index = 0; index < mr_count; ++index) {
+        if (service
+                .handle(session, decoded(ugdr::control::make_register_mr_request(
+                                     pd.response.object_identity, memory,
+                                     ugdr::control::kAccessLocalWrite)))
+                .response.status != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool run_case(std::size_t neighbor_objects) {
+    NullCudaBackend backend;
+    ugdr::control::QpService service(backend);
+    for (std::size_t neighbor = 0; neighbor < kNeighborSessions; ++neighbor) {
+        if (!open_session(service, 1000 + neighbor, neighbor_objects / kNeighborSessions)) {
+            return false;
+        }
+    }
+    const std::size_t live_before = service.mr_count();
+    std::vector<double> samples;
+    samples.reserve(kRounds);
+    for (std::size_t round = 0; round < kRounds; ++round) {
+        const ugdr::ipc::SessionId session = 1 + round;
+        if (!open_session(service, session, kClientMrs)) {
+            return false;
+        }
+        const auto begin = std::chrono::steady_clock::now();
+        service.on_disconnect(session);
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+    }
+    if (service.mr_count() != live_before) {
+        return false;
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](double value) {
+        return samples[static_cast<std::size_t>(value * static_cast<double>(samples.size() - 1))];
+    };
+    std::cout << "benchmark=session_teardown"
+              << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
+              << " cpu_threads=" << std::thread::hardware_concurrency()
+              << " neighbor_sessions=" << kNeighborSessions
+              << " neighbor_objects=" << service.mr_count() + 2 * kNeighborSessions
+              << " client_mrs=" << kClientMrs << " rounds=" << kRounds << std::fixed
+              << std::setprecision(3) << " p50_us=" << percentile(0.50)
+              << " p99_us=" << percentile(0.99) << '\n';
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    for (const std::size_t neighbor_objects : {0U, 10000U, 100000U}) {
+        if (!run_case(neighbor_objects)) {
+            return 1;
+        }
+    }
+    return 0;
+}
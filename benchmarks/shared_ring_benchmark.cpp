@@ -40,8 +40,9 @@ bool read_span(const ugdr::queue::ConstSlotSpan &span, std::uint64_t *expected)
     return true;
 }
 
-int run(std::uint32_t batch_size) {
-    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, kCapacity, kStride};
+int run(std::uint32_t batch_size, ugdr::queue::RingOwnership ownership) {
+    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, kCapacity, kStride,
+                                                  ownership};
     ugdr::queue::SharedRing producer;
     if (ugdr::queue::create_shared_ring(descriptor, &producer) != 0) {
         return 1;
@@ -104,7 +105,8 @@ int run(std::uint32_t batch_size) {
     const double minimum_payload = 50'000'000'000.0 / descriptors_per_second;
     std::cout << "benchmark=shared_ring"
               << " build_type=" << UGDR_BENCHMARK_BUILD_TYPE
-              << " cpu_threads=" << std::thread::hardware_concurrency()
+              << " cpu_threads=" << std::thread::hardware_concurrency() << " ownership="
+              << (ownership == ugdr::queue::RingOwnership::phase ? "phase" : "counters")
               << " batch=" << batch_size << " iterations=" << kIterations / batch_size
               << " completed_wr=" << kIterations << " MWR_per_s=" << std::fixed
               << std::setprecision(3) << descriptors_per_second / 1'000'000.0
@@ -116,8 +118,11 @@ int run(std::uint32_t batch_size) {
 }  // namespace
 
 int main() {
-    if (run(1) != 0) {
-        return 1;
+    for (const auto ownership :
+         {ugdr::queue::RingOwnership::counters, ugdr::queue::RingOwnership::phase}) {
+        if (run(1, ownership) != 0 || run(32, ownership) != 0) {
+            return 1;
+        }
     }
-    return run(32);
+    return 0;
 }
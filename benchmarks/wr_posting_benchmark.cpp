@@ -1,26 +1,47 @@
 #include "api/wr_posting.hpp"
+#include "control/qp.hpp"
+#include "control/queue_descriptor.hpp"
+#include "ipc/ipc.hpp"
+#include "queue/completion_queue.hpp"
 #include "queue/descriptors.hpp"
 #include "queue/shared_ring.hpp"
 
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include <array>
+#include <cerrno>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace {
 
 constexpr std::uint32_t kCapacity = 64;
+constexpr std::uint32_t kMaxShapeBatch = 256;
 constexpr std::uint64_t kDescriptorCount = UINT64_C(4000000);
+constexpr std::uint64_t kApiDescriptorCount = UINT64_C(1000000);
+constexpr std::uint64_t kPollCount = UINT64_C(4000000);
+constexpr std::uint64_t kCompletionCount = UINT64_C(200000);
+constexpr std::uint32_t kCompletionBatch = 32;
+constexpr std::uint64_t kControlPollInterval = 1024;
+constexpr std::chrono::microseconds kDrainInterval{20};
 
-bool create_pair(ugdr::queue::SharedRing *producer, ugdr::queue::SharedRing *consumer) {
+bool create_pair(ugdr::queue::SharedRing *producer, ugdr::queue::SharedRing *consumer,
+                 std::uint32_t capacity = kCapacity) {
     std::uint32_t stride = 0;
     if (ugdr::queue::send_slot_stride(1, &stride) != 0) {
         return false;
     }
-    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, kCapacity, stride};
+    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, capacity, stride};
     if (ugdr::queue::create_shared_ring(descriptor, producer) != 0) {
         return false;
     }
@@ -73,8 +94,512 @@ bool run(std::uint32_t batch_size) {
     return true;
 }
 
+// Same WRs, one SGE each, posted as a linked chain and as a contiguous array.
+bool run_shapes(std::uint32_t batch_size) {
+    ugdr::queue::SharedRing producer;
+    ugdr::queue::SharedRing consumer;
+    if (!create_pair(&producer, &consumer, kMaxShapeBatch)) {
+        return false;
+    }
+    std::vector<ugdr_sge> sges(batch_size);
+    std::vector<ugdr_send_wr> requests(batch_size);
+    for (std::uint32_t index = 0; index < batch_size; ++index) {
+        sges[index] = {UINT64_C(0x100000) + index * UINT64_C(64), 64, 7};
+        requests[index].wr_id = index;
+        requests[index].sg_list = &sges[index];
+        requests[index].num_sge = 1;
+        requests[index].opcode = UGDR_WR_RDMA_WRITE;
+        requests[index].wr.rdma.rkey = 9;
+        requests[index].next = index + 1 < batch_size ? &requests[index + 1] : nullptr;
+    }
+    const std::uint64_t iterations = kDescriptorCount / batch_size;
+    auto measure = [&](auto post) -> double {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t iteration = 0; iteration < iterations; ++iteration) {
+            ugdr::queue::ConstSlotBatch slots;
+            if (!post() || consumer.consumer_peek(batch_size, &slots) != 0 ||
+                slots.count != batch_size || consumer.consumer_release(batch_size) != 0) {
+                return 0.0;
+            }
+        }
+        const auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        return static_cast<double>(iterations * batch_size) / elapsed.count() / 1'000'000.0;
+    };
+    const double chain = measure([&] {
+        ugdr_send_wr *bad = nullptr;
+        return ugdr::api::post_send_chain(producer, 1, requests.data(), &bad) == 0;
+    });
+    const double array = measure([&] {
+        int posted = 0;
+        return ugdr::api::post_send_array(producer, 1, requests.data(),
+                                          static_cast<int>(batch_size), &posted) == 0;
+    });
+    if (chain == 0.0 || array == 0.0) {
+        return false;
+    }
+    std::printf("benchmark=wr_posting_shape build_type=%s cpu_threads=%u batch=%u "
+                "completed_wr=%llu chain_MWR_per_s=%.3f array_MWR_per_s=%.3f\n",
+                UGDR_BENCHMARK_BUILD_TYPE, std::thread::hardware_concurrency(), batch_size,
+                static_cast<unsigned long long>(iterations * batch_size), chain, array);
+    return true;
+}
+
+// One small write per post: full validation and encode versus a precompiled template.
+bool run_template() {
+    ugdr::queue::SharedRing producer;
+    ugdr::queue::SharedRing consumer;
+    if (!create_pair(&producer, &consumer)) {
+        return false;
+    }
+    ugdr_sge sge{UINT64_C(0x100000), 64, 7};
+    ugdr_send_wr request{};
+    request.sg_list = &sge;
+    request.num_sge = 1;
+    request.opcode = UGDR_WR_RDMA_WRITE;
+    request.wr.rdma.rkey = 9;
+    ugdr::api::SendTemplate send_template;
+    if (ugdr::api::make_send_template(request, 1, &send_template) != 0) {
+        return false;
+    }
+    auto measure = [&](auto post) -> double {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t iteration = 0; iteration < kDescriptorCount; ++iteration) {
+            if (!post(iteration)) {
+                return 0.0;
+            }
+            if ((iteration + 1) % kCapacity == 0) {
+                ugdr::queue::ConstSlotBatch slots;
+                if (consumer.consumer_peek(kCapacity, &slots) != 0 ||
+                    consumer.consumer_release(slots.count) != 0) {
+                    return 0.0;
+                }
+            }
+        }
+        const auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        return elapsed.count() * 1e9 / static_cast<double>(kDescriptorCount);
+    };
+    const double full = measure([&](std::uint64_t iteration) {
+        request.wr_id = iteration;
+        sge.addr = UINT64_C(0x100000) + (iteration & 0xffU) * 64;
+        request.wr.rdma.remote_addr = UINT64_C(0x200000) + (iteration & 0xffU) * 64;
+        ugdr_send_wr *bad = nullptr;
+        return ugdr::api::post_send_chain(producer, 1, &request, &bad) == 0;
+    });
+    const double precompiled = measure([&](std::uint64_t iteration) {
+        return ugdr::api::post_send_template(producer, send_template, iteration,
+                                             UINT64_C(0x100000) + (iteration & 0xffU) * 64,
+                                             UINT64_C(0x200000) + (iteration & 0xffU) * 64) ==
+               0;
+    });
+    if (full == 0.0 || precompiled == 0.0) {
+        return false;
+    }
+    std::printf("benchmark=wr_posting_template build_type=%s cpu_threads=%u "
+                "completed_wr=%llu chain_ns_per_wr=%.2f template_ns_per_wr=%.2f\n",
+                UGDR_BENCHMARK_BUILD_TYPE, std::thread::hardware_concurrency(),
+                static_cast<unsigned long long>(kDescriptorCount), full, precompiled);
+    return true;
+}
+
+class UnusedCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &, ugdr::gpu::CudaIpcMapping *) override {
+        return EIO;
+    }
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return EIO;
+    }
+};
+
+class DrainingService final : public ugdr::control::ControlService {
+  public:
+    DrainingService() : service_(backend_) {
+    }
+
+    ugdr::control::ControlServiceResult
+    handle(ugdr::ipc::SessionId session_id, ugdr::control::DecodedControlRequest request) override {
+        const auto method = static_cast<ugdr::control::ControlMethod>(request.value.method);
+        auto result = service_.handle(session_id, std::move(request));
+        if (method == ugdr::control::ControlMethod::create_cq && result.response.status == 0) {
+            capture_completion_queue(result);
+        }
+        if (method == ugdr::control::ControlMethod::create_qp && result.response.status == 0) {
+            capture_send_queue(result);
+        }
+        return result;
+    }
+
+    void on_disconnect(ugdr::ipc::SessionId session_id) noexcept override {
+        service_.on_disconnect(session_id);
+    }
+
+    // Signaled WQEs complete on the most recently created CQ, which every benchmark QP uses.
+    void drain() {
+        for (ugdr::queue::SharedRing &ring : send_queues_) {
+            ugdr::queue::ConstSlotBatch batch;
+            if (ring.consumer_peek(kCapacity, &batch) != 0) {
+                continue;
+            }
+            std::array<ugdr::queue::CompletionEntry, kCapacity> completions{};
+            int count = 0;
+            const std::uint32_t stride = ring.descriptor().slot_stride;
+            for (const ugdr::queue::ConstSlotSpan &span : {batch.first, batch.second}) {
+                for (std::uint32_t index = 0; index < span.count; ++index) {
+                    const auto *const header = reinterpret_cast<const ugdr::queue::SendWqeHeader *>(
+                        static_cast<const std::byte *>(span.data) +
+                        static_cast<std::size_t>(index) * stride);
+                    if ((header->send_flags & UGDR_SEND_SIGNALED) != 0) {
+                        completions[count++] = {header->wr_id, UGDR_WC_SUCCESS,
+                                                UGDR_WC_RDMA_WRITE};
+                    }
+                }
+            }
+            if (count != 0 && !completion_queues_.empty()) {
+                (void)ugdr::queue::produce_completions(completion_queues_.back(),
+                                                       completions.data(), count);
+            }
+            (void)ring.consumer_release(batch.count);
+        }
+    }
+
+  private:
+    void capture_send_queue(const ugdr::control::ControlServiceResult &result) {
+        std::uint32_t stride = 0;
+        if (result.file_descriptors.empty() || ugdr::queue::send_slot_stride(1, &stride) != 0) {
+            return;
+        }
+        const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, kCapacity,
+                                                      stride};
+        const int fd = ::fcntl(result.file_descriptors[0].get(), F_DUPFD_CLOEXEC, 0);
+        ugdr::queue::SharedRing ring;
+        if (fd < 0 || ugdr::queue::map_shared_ring(fd, descriptor, &ring) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return;
+        }
+        send_queues_.push_back(std::move(ring));
+    }
+
+    void capture_completion_queue(const ugdr::control::ControlServiceResult &result) {
+        std::vector<ugdr::queue::QueueDescriptor> descriptors;
+        if (ugdr::control::decode_queue_descriptors(result.response.opaque, &descriptors) != 0 ||
+            descriptors.size() != 1) {
+            return;
+        }
+        const int fd = result.file_descriptors.empty()
+                           ? -1
+                           : ::fcntl(result.file_descriptors[0].get(), F_DUPFD_CLOEXEC, 0);
+        ugdr::queue::SharedRing ring;
+        if (fd < 0 || ugdr::queue::map_shared_ring(fd, descriptors[0], &ring) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return;
+        }
+        completion_queues_.push_back(std::move(ring));
+    }
+
+    UnusedCudaBackend backend_;
+    ugdr::control::QpService service_;
+    std::vector<ugdr::queue::SharedRing> send_queues_;
+    std::vector<ugdr::queue::SharedRing> completion_queues_;
+};
+
+int child_main(const std::string &socket_path, int ready_fd) {
+    DrainingService service;
+    ugdr::control::ControlIpcHandler handler(service);
+    ugdr::ipc::IpcServer server(handler);
+    if (server.start(socket_path) != 0) {
+        return 20;
+    }
+    const char ready = 'r';
+    if (::write(ready_fd, &ready, 1) != 1) {
+        return 21;
+    }
+    for (std::uint64_t cycle = 0;; ++cycle) {
+        if ((cycle & (kControlPollInterval - 1)) == 0 && server.poll_once(0) != 0) {
+            return 22;
+        }
+        service.drain();
+    }
+}
+
+void terminate_process(pid_t *process) {
+    if (*process <= 0) {
+        return;
+    }
+    (void)::kill(*process, SIGTERM);
+    (void)::waitpid(*process, nullptr, 0);
+    *process = -1;
+}
+
+int initialize(ugdr_qp *qp) {
+    ugdr_qp_attr attributes{};
+    attributes.qp_state = UGDR_QPS_INIT;
+    attributes.cur_qp_state = UGDR_QPS_RESET;
+    attributes.qp_access_flags = UGDR_ACCESS_REMOTE_WRITE;
+    return ugdr_modify_qp(qp, &attributes,
+                          UGDR_QP_STATE | UGDR_QP_CUR_STATE | UGDR_QP_ACCESS_FLAGS);
+}
+
+int connect(ugdr_qp *qp, std::uint32_t remote_qp_num) {
+    const ugdr_qp_conn_info remote{remote_qp_num};
+    ugdr_qp_attr retry{};
+    retry.timeout = 14;
+    retry.retry_cnt = 7;
+    retry.rnr_retry = 7;
+    retry.min_rnr_timer = 1;
+    constexpr int mask =
+        UGDR_QP_TIMEOUT | UGDR_QP_RETRY_CNT | UGDR_QP_RNR_RETRY | UGDR_QP_MIN_RNR_TIMER;
+    return ugdr_connect_qp(qp, &remote, &retry, mask);
+}
+
+bool run_api(ugdr_context *context, ugdr_pd *pd, bool single_threaded, bool compact) {
+    ugdr_cq_init_attr_ex cq_attributes{};
+    cq_attributes.cqe = kCapacity;
+    cq_attributes.flags = single_threaded
+                              ? static_cast<std::uint32_t>(UGDR_CREATE_CQ_ATTR_SINGLE_THREADED)
+                              : 0U;
+    cq_attributes.flags |= compact ? static_cast<std::uint32_t>(UGDR_CREATE_CQ_ATTR_COMPACT_CQE)
+                                   : 0U;
+    ugdr_cq *const cq = ugdr_create_cq_ex(context, &cq_attributes);
+    if (cq == nullptr) {
+        return false;
+    }
+    ugdr_qp_init_attr_ex qp_attributes{cq, cq, kCapacity, kCapacity, 1, 1, UGDR_QPT_RC, 0, nullptr,
+                                       0};
+    qp_attributes.create_flags = single_threaded
+                                     ? static_cast<std::uint32_t>(UGDR_QP_CREATE_SINGLE_THREADED)
+                                     : 0U;
+    std::array<ugdr_qp *, 2> qps{ugdr_create_qp_ex(pd, &qp_attributes),
+                                 ugdr_create_qp_ex(pd, &qp_attributes)};
+    bool ok = qps[0] != nullptr && qps[1] != nullptr && initialize(qps[0]) == 0 &&
+              initialize(qps[1]) == 0;
+    ugdr_qp_conn_info first{};
+    ugdr_qp_conn_info second{};
+    ok = ok && ugdr_query_qp_conn_info(qps[0], &first) == 0 &&
+         ugdr_query_qp_conn_info(qps[1], &second) == 0 && connect(qps[0], second.qp_num) == 0 &&
+         connect(qps[1], first.qp_num) == 0;
+
+    const char *const mode = single_threaded ? "single_threaded" : "locked";
+    const char *const cqe = compact ? "compact" : "padded";
+    // Posting never touches the CQ, so the compact run only repeats the CQ measurements.
+    for (const std::uint32_t batch_size : {1U, 32U}) {
+        if (compact) {
+            break;
+        }
+        std::array<ugdr_send_wr, 32> requests{};
+        for (std::uint32_t index = 0; index < batch_size; ++index) {
+            requests[index].wr_id = index;
+            requests[index].opcode = UGDR_WR_RDMA_WRITE;
+            requests[index].next = index + 1 < batch_size ? &requests[index + 1] : nullptr;
+        }
+        // Only time spent inside accepted posts counts; the daemon drains the SQ in between.
+        const std::uint64_t iterations = kApiDescriptorCount / batch_size;
+        auto measure = [&](const char *benchmark, auto post) {
+            std::chrono::duration<double> elapsed{};
+            for (std::uint64_t iteration = 0; ok && iteration < iterations;) {
+                const auto start = std::chrono::steady_clock::now();
+                int status = 0;
+                while (iteration < iterations && (status = post()) == 0) {
+                    ++iteration;
+                }
+                elapsed += std::chrono::steady_clock::now() - start;
+                if (status != 0 && status != ENOMEM) {
+                    ok = false;
+                } else if (status != 0) {
+                    std::this_thread::sleep_for(kDrainInterval);
+                }
+            }
+            if (!ok) {
+                return;
+            }
+            const double descriptors_per_second =
+                static_cast<double>(iterations * batch_size) / elapsed.count();
+            std::printf("benchmark=%s build_type=%s cpu_threads=%u mode=%s batch=%u "
+                        "iterations=%llu completed_wr=%llu MWR_per_s=%.3f\n",
+                        benchmark, UGDR_BENCHMARK_BUILD_TYPE, std::thread::hardware_concurrency(),
+                        mode, batch_size, static_cast<unsigned long long>(iterations),
+                        static_cast<unsigned long long>(iterations * batch_size),
+                        descriptors_per_second / 1'000'000.0);
+        };
+        // A prefix accepted before ENOMEM stays posted; the rest is retried after the drain.
+        ugdr_send_wr *pending = requests.data();
+        measure("wr_posting_api", [&] {
+            ugdr_send_wr *bad = nullptr;
+            const int status = ugdr_post_send(qps[0], pending, &bad);
+            pending = status == 0 ? requests.data() : bad;
+            return status;
+        });
+        std::uint32_t template_id = 0;
+        ok = ok && ugdr_create_send_template(qps[0], requests.data(), &template_id) == 0;
+        if (batch_size == 1) {
+            std::uint64_t wr_id = 0;
+            measure("wr_template_api", [&] {
+                const int status = ugdr_post_send_template(qps[0], template_id, wr_id, 0, 0);
+                wr_id += status == 0 ? 1 : 0;
+                return status;
+            });
+        }
+        measure("wr_builder_api", [&] {
+            const int status = ugdr_wr_start(qps[0]);
+            if (status != 0) {
+                return status;
+            }
+            for (std::uint32_t index = 0; index < batch_size; ++index) {
+                ugdr_wr_rdma_write(qps[0], index, 0, 0, 0);
+            }
+            return ugdr_wr_complete(qps[0]);
+        });
+    }
+
+    if (ok) {
+        std::array<ugdr_wc, 16> completions{};
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t iteration = 0; ok && iteration < kPollCount; ++iteration) {
+            ok = ugdr_poll_cq(cq, static_cast<int>(completions.size()), completions.data()) == 0;
+        }
+        const auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        if (ok) {
+            std::printf("benchmark=cq_polling_api build_type=%s cpu_threads=%u mode=%s cqe=%s "
+                        "empty_polls=%llu ns_per_poll=%.1f\n",
+                        UGDR_BENCHMARK_BUILD_TYPE, std::thread::hardware_concurrency(), mode, cqe,
+                        static_cast<unsigned long long>(kPollCount),
+                        elapsed.count() * 1e9 / static_cast<double>(kPollCount));
+        }
+    }
+
+    // Each round posts one signaled batch; only polls that return completions are timed.
+    for (const bool iterate : {false, true}) {
+        std::array<ugdr_wc, kCompletionBatch> completions{};
+        std::chrono::duration<double> elapsed{};
+        const std::uint64_t rounds = kCompletionCount / kCompletionBatch;
+        for (std::uint64_t round = 0; ok && round < rounds; ++round) {
+            ok = ugdr_wr_start(qps[0]) == 0;
+            for (std::uint32_t index = 0; ok && index < kCompletionBatch; ++index) {
+                ugdr_wr_rdma_write(qps[0], index, UGDR_SEND_SIGNALED, 0, 0);
+            }
+            ok = ok && ugdr_wr_complete(qps[0]) == 0;
+            for (std::uint32_t drained = 0; ok && drained < kCompletionBatch;) {
+                const auto start = std::chrono::steady_clock::now();
+                std::uint32_t count = 0;
+                if (iterate) {
+                    if (ugdr_start_poll(cq) == 0) {
+                        do {
+                            ok = ok && ugdr_wc_read_status(cq) == UGDR_WC_SUCCESS &&
+                                 ugdr_wc_read_wr_id(cq) == drained + count;
+                            ++count;
+                        } while (ugdr_next_poll(cq) == 0);
+                        ugdr_end_poll(cq);
+                    }
+                } else {
+                    const int polled = ugdr_poll_cq(cq, static_cast<int>(completions.size()),
+                                                    completions.data());
+                    for (int index = 0; index < polled; ++index, ++count) {
+                        ok = ok && completions[index].status == UGDR_WC_SUCCESS &&
+                             completions[index].wr_id == drained + count;
+                    }
+                    ok = ok && polled >= 0;
+                }
+                if (count == 0) {
+                    std::this_thread::sleep_for(kDrainInterval);
+                    continue;
+                }
+                elapsed += std::chrono::steady_clock::now() - start;
+                drained += count;
+            }
+        }
+        if (ok) {
+            const std::uint64_t total = rounds * kCompletionBatch;
+            std::printf("benchmark=cq_drain_api build_type=%s cpu_threads=%u mode=%s cqe=%s "
+                        "reader=%s completions=%llu ns_per_completion=%.1f\n",
+                        UGDR_BENCHMARK_BUILD_TYPE, std::thread::hardware_concurrency(), mode, cqe,
+                        iterate ? "start_poll" : "poll_cq", static_cast<unsigned long long>(total),
+                        elapsed.count() * 1e9 / static_cast<double>(total));
+        }
+    }
+
+    for (ugdr_qp *qp : qps) {
+        ok = qp != nullptr && ugdr_destroy_qp(qp) == 0 && ok;
+    }
+    return ugdr_destroy_cq(cq) == 0 && ok;
+}
+
+int run_api_benchmarks() {
+    char directory_template[] = "/tmp/ugdr-wr-posting-XXXXXX";
+    char *const directory = ::mkdtemp(directory_template);
+    if (directory == nullptr) {
+        return 2;
+    }
+    const std::string socket_path = std::string(directory) + "/control.sock";
+    std::array<int, 2> ready_pipe{};
+    if (::pipe2(ready_pipe.data(), O_CLOEXEC) != 0) {
+        (void)::rmdir(directory);
+        return 3;
+    }
+    pid_t child = ::fork();
+    if (child < 0) {
+        (void)::close(ready_pipe[0]);
+        (void)::close(ready_pipe[1]);
+        (void)::rmdir(directory);
+        return 4;
+    }
+    if (child == 0) {
+        (void)::close(ready_pipe[0]);
+        const int result = child_main(socket_path, ready_pipe[1]);
+        (void)::close(ready_pipe[1]);
+        std::_Exit(result);
+    }
+    (void)::close(ready_pipe[1]);
+    char ready = 0;
+    const bool started = ::read(ready_pipe[0], &ready, 1) == 1 && ready == 'r';
+    (void)::close(ready_pipe[0]);
+    int result = 0;
+    if (!started || ::setenv("UGDR_DAEMON_SOCKET", socket_path.c_str(), 1) != 0) {
+        result = 5;
+    }
+
+    int count = 0;
+    ugdr_device **devices = result == 0 ? ugdr_get_device_list(&count) : nullptr;
+    ugdr_context *const context =
+        devices != nullptr && count == 1 ? ugdr_open_device(devices[0]) : nullptr;
+    if (devices != nullptr) {
+        ugdr_free_device_list(devices);
+    }
+    ugdr_pd *const pd = context != nullptr ? ugdr_alloc_pd(context) : nullptr;
+    if (result == 0 && (pd == nullptr || !run_api(context, pd, false, false) ||
+                        !run_api(context, pd, true, false) || !run_api(context, pd, true, true))) {
+        result = 6;
+    }
+    if (pd != nullptr && ugdr_dealloc_pd(pd) != 0 && result == 0) {
+        result = 7;
+    }
+    if (context != nullptr && ugdr_close_device(context) != 0 && result == 0) {
+        result = 7;
+    }
+    terminate_process(&child);
+    (void)::unlink(socket_path.c_str());
+    (void)::rmdir(directory);
+    return result;
+}
+
 }  // namespace
 
 int main() {
-    return run(1) && run(32) ? 0 : 1;
+    if (!run(1) || !run(32)) {
+        return 1;
+    }
+    for (std::uint32_t batch_size = 1; batch_size <= kMaxShapeBatch; batch_size *= 2) {
+        if (!run_shapes(batch_size)) {
+            return 1;
+        }
+    }
+    if (!run_template()) {
+        return 1;
+    }
+    return run_api_benchmarks();
 }
@@ -17,8 +17,14 @@ typedef struct ugdr_mr ugdr_mr;
 typedef struct ugdr_cq ugdr_cq;
 typedef struct ugdr_comp_channel ugdr_comp_channel;
 typedef struct ugdr_qp ugdr_qp;
+typedef struct ugdr_srq ugdr_srq;
 
+typedef struct ugdr_cq_init_attr_ex ugdr_cq_init_attr_ex;
+typedef struct ugdr_moderate_cq ugdr_moderate_cq;
+typedef struct ugdr_modify_cq_attr ugdr_modify_cq_attr;
 typedef struct ugdr_qp_init_attr ugdr_qp_init_attr;
+typedef struct ugdr_qp_init_attr_ex ugdr_qp_init_attr_ex;
+typedef struct ugdr_srq_init_attr ugdr_srq_init_attr;
 typedef struct ugdr_qp_attr ugdr_qp_attr;
 typedef struct ugdr_qp_conn_info ugdr_qp_conn_info;
 typedef struct ugdr_sge ugdr_sge;
@@ -84,6 +90,19 @@ typedef enum ugdr_wc_flags {
     UGDR_WC_WITH_IMM = 1U << 1U,
 } ugdr_wc_flags;
 
+typedef enum ugdr_create_cq_attr_flags {
+    UGDR_CREATE_CQ_ATTR_SINGLE_THREADED = 1U << 0U,
+    UGDR_CREATE_CQ_ATTR_COMPACT_CQE = 1U << 16U,
+} ugdr_create_cq_attr_flags;
+
+typedef enum ugdr_cq_attr_mask {
+    UGDR_CQ_ATTR_MODERATE = 1U << 0U,
+} ugdr_cq_attr_mask;
+
+typedef enum ugdr_qp_create_flags {
+    UGDR_QP_CREATE_SINGLE_THREADED = 1U << 0U,
+} ugdr_qp_create_flags;
+
 typedef enum ugdr_access_flags {
     UGDR_ACCESS_LOCAL_WRITE = 1U << 0U,
     UGDR_ACCESS_REMOTE_WRITE = 1U << 1U,
@@ -157,6 +176,44 @@ struct ugdr_qp_init_attr {
     uint32_t max_recv_sge;
     ugdr_qp_type qp_type;
     int sq_sig_all;
+    ugdr_srq *srq;
+};
+
+struct ugdr_qp_init_attr_ex {
+    ugdr_cq *send_cq;
+    ugdr_cq *recv_cq;
+    uint32_t max_send_wr;
+    uint32_t max_recv_wr;
+    uint32_t max_send_sge;
+    uint32_t max_recv_sge;
+    ugdr_qp_type qp_type;
+    int sq_sig_all;
+    ugdr_srq *srq;
+    uint32_t create_flags;
+};
+
+struct ugdr_srq_init_attr {
+    void *srq_context;
+    uint32_t max_wr;
+    uint32_t max_sge;
+};
+
+struct ugdr_cq_init_attr_ex {
+    uint32_t cqe;
+    void *cq_context;
+    ugdr_comp_channel *channel;
+    uint32_t comp_vector;
+    uint32_t flags;
+};
+
+struct ugdr_moderate_cq {
+    uint16_t cq_count;
+    uint16_t cq_period;
+};
+
+struct ugdr_modify_cq_attr {
+    uint32_t attr_mask;
+    ugdr_moderate_cq moderate;
 };
 
 struct ugdr_qp_attr {
@@ -187,21 +244,56 @@ int ugdr_dereg_mr(ugdr_mr *mr) UGDR_NOEXCEPT;
 
 ugdr_cq *ugdr_create_cq(ugdr_context *context, int cqe, void *cq_context,
                         ugdr_comp_channel *channel, int comp_vector) UGDR_NOEXCEPT;
+ugdr_cq *ugdr_create_cq_ex(ugdr_context *context, ugdr_cq_init_attr_ex *cq_attr) UGDR_NOEXCEPT;
 int ugdr_destroy_cq(ugdr_cq *cq) UGDR_NOEXCEPT;
+int ugdr_modify_cq(ugdr_cq *cq, ugdr_modify_cq_attr *attr) UGDR_NOEXCEPT;
 int ugdr_poll_cq(ugdr_cq *cq, int num_entries, ugdr_wc *wc) UGDR_NOEXCEPT;
+int ugdr_start_poll(ugdr_cq *cq) UGDR_NOEXCEPT;
+int ugdr_next_poll(ugdr_cq *cq) UGDR_NOEXCEPT;
+void ugdr_end_poll(ugdr_cq *cq) UGDR_NOEXCEPT;
+uint64_t ugdr_wc_read_wr_id(const ugdr_cq *cq) UGDR_NOEXCEPT;
+ugdr_wc_status ugdr_wc_read_status(const ugdr_cq *cq) UGDR_NOEXCEPT;
+ugdr_wc_opcode ugdr_wc_read_opcode(const ugdr_cq *cq) UGDR_NOEXCEPT;
+uint32_t ugdr_wc_read_byte_len(const ugdr_cq *cq) UGDR_NOEXCEPT;
+uint32_t ugdr_wc_read_imm_data(const ugdr_cq *cq) UGDR_NOEXCEPT;
+uint32_t ugdr_wc_read_qp_num(const ugdr_cq *cq) UGDR_NOEXCEPT;
+unsigned int ugdr_wc_read_wc_flags(const ugdr_cq *cq) UGDR_NOEXCEPT;
 
 ugdr_qp *ugdr_create_qp(ugdr_pd *pd, ugdr_qp_init_attr *init_attr) UGDR_NOEXCEPT;
+ugdr_qp *ugdr_create_qp_ex(ugdr_pd *pd, ugdr_qp_init_attr_ex *init_attr) UGDR_NOEXCEPT;
 int ugdr_destroy_qp(ugdr_qp *qp) UGDR_NOEXCEPT;
 int ugdr_modify_qp(ugdr_qp *qp, ugdr_qp_attr *attr, int attr_mask) UGDR_NOEXCEPT;
 int ugdr_query_qp(ugdr_qp *qp, ugdr_qp_attr *attr, int attr_mask,
                   ugdr_qp_init_attr *init_attr) UGDR_NOEXCEPT;
 
+ugdr_srq *ugdr_create_srq(ugdr_pd *pd, ugdr_srq_init_attr *srq_init_attr) UGDR_NOEXCEPT;
+int ugdr_destroy_srq(ugdr_srq *srq) UGDR_NOEXCEPT;
+int ugdr_post_srq_recv(ugdr_srq *srq, ugdr_recv_wr *wr, ugdr_recv_wr **bad_wr) UGDR_NOEXCEPT;
+
 int ugdr_query_qp_conn_info(ugdr_qp *qp, ugdr_qp_conn_info *info) UGDR_NOEXCEPT;
 int ugdr_connect_qp(ugdr_qp *qp, const ugdr_qp_conn_info *remote_info, const ugdr_qp_attr *attr,
                     int attr_mask) UGDR_NOEXCEPT;
 
 int ugdr_post_send(ugdr_qp *qp, ugdr_send_wr *wr, ugdr_send_wr **bad_wr) UGDR_NOEXCEPT;
 int ugdr_post_recv(ugdr_qp *qp, ugdr_recv_wr *wr, ugdr_recv_wr **bad_wr) UGDR_NOEXCEPT;
+int ugdr_post_send_batch(ugdr_qp *qp, const ugdr_send_wr *wrs, int count,
+                         int *posted) UGDR_NOEXCEPT;
+int ugdr_post_recv_batch(ugdr_qp *qp, const ugdr_recv_wr *wrs, int count,
+                         int *posted) UGDR_NOEXCEPT;
+int ugdr_create_send_template(ugdr_qp *qp, const ugdr_send_wr *shape,
+                              uint32_t *template_id) UGDR_NOEXCEPT;
+int ugdr_post_send_template(ugdr_qp *qp, uint32_t template_id, uint64_t wr_id,
+                            uint64_t local_addr, uint64_t remote_addr) UGDR_NOEXCEPT;
+
+int ugdr_wr_start(ugdr_qp *qp) UGDR_NOEXCEPT;
+void ugdr_wr_rdma_write(ugdr_qp *qp, uint64_t wr_id, unsigned int send_flags, uint32_t rkey,
+                        uint64_t remote_addr) UGDR_NOEXCEPT;
+void ugdr_wr_rdma_write_imm(ugdr_qp *qp, uint64_t wr_id, unsigned int send_flags, uint32_t rkey,
+                            uint64_t remote_addr, uint32_t imm_data) UGDR_NOEXCEPT;
+void ugdr_wr_set_sge(ugdr_qp *qp, uint32_t lkey, uint64_t addr, uint32_t length) UGDR_NOEXCEPT;
+void ugdr_wr_set_sge_list(ugdr_qp *qp, size_t num_sge, const ugdr_sge *sg_list) UGDR_NOEXCEPT;
+int ugdr_wr_complete(ugdr_qp *qp) UGDR_NOEXCEPT;
+void ugdr_wr_abort(ugdr_qp *qp) UGDR_NOEXCEPT;
 
 #ifdef __cplusplus
 }
@@ -1,13 +1,18 @@
 #include "ugdr/api.hpp"
 
+#include "api/mr_registration_cache.hpp"
 #include "api/wr_posting.hpp"
 #include "control/device_context.hpp"
 #include "control/pd_mr_cq.hpp"
 #include "control/qp.hpp"
 #include "gpu/cuda_ipc_memory.hpp"
+#include "queue/completion_queue.hpp"
 #include "queue/descriptors.hpp"
+#include "queue/ring_arena.hpp"
 #include "queue/shared_ring.hpp"
 
+#include <atomic>
+#include <cassert>
 #include <cerrno>
 
 #include <cstdint>
@@ -16,7 +21,6 @@
 #include <limits>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -33,6 +37,7 @@ struct ugdr_context {
     std::uint64_t daemon_identity = 0;
     std::uint64_t connection_epoch = 0;
     bool live = false;
+    std::shared_ptr<ugdr::queue::SharedRingArena> ring_arena;
 };
 
 struct ugdr_pd {
@@ -49,8 +54,11 @@ struct ugdr_cq {
     std::uint64_t connection_epoch = 0;
     int cqe = 0;
     bool live = false;
+    bool single_threaded = false;
     std::mutex polling_mutex;
+    std::atomic_flag polling_in_use;
     ugdr::queue::SharedRing completions;
+    ugdr::queue::CompletionReader reader;
 };
 
 struct ugdr_qp {
@@ -60,9 +68,26 @@ struct ugdr_qp {
     std::uint64_t connection_epoch = 0;
     ugdr_qp_state cached_state = UGDR_QPS_RESET;
     bool live = false;
+    bool single_threaded = false;
     std::mutex posting_mutex;
+    std::atomic_flag posting_in_use;
     ugdr::queue::SharedRing send_queue;
     ugdr::queue::SharedRing receive_queue;
+    ugdr::api::SendWqeBuilder send_builder;
+    std::vector<ugdr::api::SendTemplate> send_templates;
+};
+
+struct ugdr_srq {
+    ugdr_pd *pd = nullptr;
+    void *srq_context = nullptr;
+    std::uint64_t daemon_identity = 0;
+    std::uint64_t connection_epoch = 0;
+    std::uint32_t max_wr = 0;
+    std::uint32_t max_sge = 0;
+    bool live = false;
+    std::mutex posting_mutex;
+    std::atomic_flag posting_in_use;
+    ugdr::queue::SharedRing receive_queue;
 };
 
 namespace {
@@ -73,6 +98,40 @@ struct DeviceListRecord {
     bool live = true;
 };
 
+// UGDR_MR_CACHE_SIZE opts into the registration cache and bounds its idle registrations.
+std::size_t configured_mr_cache_limit() noexcept {
+    const char *const configured = std::getenv("UGDR_MR_CACHE_SIZE");
+    if (configured == nullptr || configured[0] < '0' || configured[0] > '9') {
+        return 0;
+    }
+    char *end = nullptr;
+    const unsigned long long value = std::strtoull(configured, &end, 10);
+    return *end == '\0' && value <= std::numeric_limits<std::size_t>::max()
+               ? static_cast<std::size_t>(value)
+               : 0;
+}
+
+// UGDR_RING_ARENA_BYTES opts each context into one ring arena of that size, so its queues cost
+// no descriptors or mappings of their own.
+std::size_t configured_ring_arena_bytes() noexcept {
+    const char *const configured = std::getenv("UGDR_RING_ARENA_BYTES");
+    if (configured == nullptr || configured[0] < '0' || configured[0] > '9') {
+        return 0;
+    }
+    char *end = nullptr;
+    const unsigned long long value = std::strtoull(configured, &end, 10);
+    return *end == '\0' && value <= ugdr::queue::kMaxRingArenaBytes
+               ? static_cast<std::size_t>(value)
+               : 0;
+}
+
+// UGDR_RING_PREFAULT=1 populates each queue ring mapping when it is created, so the first posts
+// and polls do not fault.
+bool configured_ring_prefault() noexcept {
+    const char *const configured = std::getenv("UGDR_RING_PREFAULT");
+    return configured != nullptr && std::strcmp(configured, "1") == 0;
+}
+
 struct MrProxyRecord {
     ugdr_mr value{};
     std::uint64_t daemon_identity = 0;
@@ -80,6 +139,124 @@ struct MrProxyRecord {
     bool live = false;
 };
 
+// Data-path calls serialize through the object's mutex, unless the object was created
+// single-threaded. Then the caller owns serialization, and debug builds assert that promise.
+void enter_data_path(std::mutex &mutex, std::atomic_flag &in_use, bool single_threaded) {
+    if (!single_threaded) {
+        mutex.lock();
+        return;
+    }
+#ifndef NDEBUG
+    const bool concurrent = in_use.test_and_set(std::memory_order_acquire);
+    assert(!concurrent && "single-threaded UGDR object used concurrently");
+    (void)concurrent;
+#else
+    (void)in_use;
+#endif
+}
+
+void leave_data_path(std::mutex &mutex, std::atomic_flag &in_use, bool single_threaded) noexcept {
+    if (!single_threaded) {
+        mutex.unlock();
+        return;
+    }
+#ifndef NDEBUG
+    in_use.clear(std::memory_order_release);
+#else
+    (void)in_use;
+#endif
+}
+
+class DataPathGuard {
+  public:
+    DataPathGuard(std::mutex &mutex, std::atomic_flag &in_use, bool single_threaded)
+        : mutex_(mutex), in_use_(in_use), single_threaded_(single_threaded) {
+        enter_data_path(mutex_, in_use_, single_threaded_);
+    }
+
+    DataPathGuard(const DataPathGuard &) = delete;
+    DataPathGuard &operator=(const DataPathGuard &) = delete;
+
+    ~DataPathGuard() {
+        leave_data_path(mutex_, in_use_, single_threaded_);
+    }
+
+  private:
+    std::mutex &mutex_;
+    std::atomic_flag &in_use_;
+    bool single_threaded_;
+};
+
+// Append-only set of live-or-destroyed handles. Inserts are serialized by the runtime mutex;
+// lookups are lock-free so the posting and polling paths never contend on a global lock.
+// Superseded slot arrays are retained because concurrent readers may still probe them.
+template <typename T> class HandleTable {
+  public:
+    bool contains(const T *handle) const noexcept {
+        const Slots *const slots = current_.load(std::memory_order_acquire);
+        if (slots == nullptr || handle == nullptr) {
+            return false;
+        }
+        for (std::size_t probe = hash(handle) & slots->mask;; probe = (probe + 1) & slots->mask) {
+            const T *const entry = slots->entries[probe].load(std::memory_order_acquire);
+            if (entry == handle) {
+                return true;
+            }
+            if (entry == nullptr) {
+                return false;
+            }
+        }
+    }
+
+    void insert(T *handle) {
+        Slots *slots = current_.load(std::memory_order_relaxed);
+        if (slots == nullptr || (count_ + 1) * 2 > slots->mask + 1) {
+            auto grown = std::make_unique<Slots>(slots == nullptr ? 64 : (slots->mask + 1) * 2);
+            if (slots != nullptr) {
+                for (std::size_t index = 0; index <= slots->mask; ++index) {
+                    T *const entry = slots->entries[index].load(std::memory_order_relaxed);
+                    if (entry != nullptr) {
+                        place(*grown, entry);
+                    }
+                }
+            }
+            generations_.reserve(generations_.size() + 1);
+            slots = grown.get();
+            generations_.push_back(std::move(grown));
+            current_.store(slots, std::memory_order_release);
+        }
+        place(*slots, handle);
+        ++count_;
+    }
+
+  private:
+    struct Slots {
+        explicit Slots(std::size_t capacity)
+            : mask(capacity - 1), entries(std::make_unique<std::atomic<T *>[]>(capacity)) {
+        }
+
+        std::size_t mask;
+        std::unique_ptr<std::atomic<T *>[]> entries;
+    };
+
+    static std::size_t hash(const T *handle) noexcept {
+        const auto value = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(handle));
+        return static_cast<std::size_t>(((value >> 4U) * UINT64_C(0x9e3779b97f4a7c15)) >> 24U);
+    }
+
+    static void place(Slots &slots, T *handle) noexcept {
+        std::size_t probe = hash(handle) & slots.mask;
+        while (slots.entries[probe].load(std::memory_order_relaxed) != nullptr) {
+            probe = (probe + 1) & slots.mask;
+        }
+        slots.entries[probe].store(handle, std::memory_order_release);
+    }
+
+    std::atomic<Slots *> current_{nullptr};
+    std::vector<std::unique_ptr<Slots>> generations_;
+    std::size_t count_ = 0;
+};
+
 class ClientRuntime {
   public:
     ugdr_device **get_device_list(int *num_devices) {
@@ -157,6 +334,15 @@ class ClientRuntime {
             return nullptr;
         }
         auto context = std::make_unique<ugdr_context>();
+        if (ring_arena_bytes_ != 0) {
+            const int arena_status = ugdr::control::client_map_ring_arena(
+                client_, identity, ring_arena_bytes_, &context->ring_arena);
+            if (arena_status != 0) {
+                (void)client_.destroy_context(identity);
+                errno = arena_status;
+                return nullptr;
+            }
+        }
         context->daemon_identity = identity;
         context->connection_epoch = client_.connection_epoch();
         context->live = true;
@@ -188,6 +374,7 @@ class ClientRuntime {
             return -1;
         }
         context->live = false;
+        context->ring_arena.reset();
         return 0;
     }
 
@@ -244,6 +431,12 @@ class ClientRuntime {
             pd->live = false;
             return EINVAL;
         }
+        while (ugdr_mr *const idle = mr_cache_.idle_in(pd)) {
+            const int flush_status = deregister_idle_mr(idle);
+            if (flush_status != 0) {
+                return flush_status;
+            }
+        }
         const int destroy_status = ugdr::control::client_destroy_pd(client_, pd->daemon_identity);
         if (destroy_status == 0) {
             pd->live = false;
@@ -272,6 +465,14 @@ class ClientRuntime {
             errno = EINVAL;
             return nullptr;
         }
+        if (mr_cache_.enabled()) {
+            ugdr_mr *const cached = mr_cache_.acquire(
+                pd, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(address)), length,
+                static_cast<std::uint32_t>(access));
+            if (cached != nullptr) {
+                return cached;
+            }
+        }
         if (next_mr_handle_ > std::numeric_limits<std::uint32_t>::max()) {
             errno = ENOSPC;
             return nullptr;
@@ -309,7 +510,11 @@ class ClientRuntime {
         try {
             mr_storage_.push_back(std::move(record));
             mrs_.emplace(result, mr_storage_.back().get());
+            if (mr_cache_.enabled()) {
+                (void)mr_cache_.insert(result, static_cast<std::uint32_t>(access));
+            }
         } catch (...) {
+            mr_cache_.erase(result);
             record_pointer->live = false;
             (void)ugdr::control::client_deregister_mr(client_, identity);
             throw;
@@ -329,9 +534,19 @@ class ClientRuntime {
         }
         MrProxyRecord *const record = found->second;
         if (record->connection_epoch != client_.connection_epoch()) {
+            mr_cache_.erase(mr);
             record->live = false;
             return EINVAL;
         }
+        if (mr_cache_.contains(mr)) {
+            const int release_status = mr_cache_.release(mr);
+            while (ugdr_mr *const victim = mr_cache_.next_eviction()) {
+                if (deregister_idle_mr(victim) != 0) {
+                    break;
+                }
+            }
+            return release_status;
+        }
         const int deregister_status =
             ugdr::control::client_deregister_mr(client_, record->daemon_identity);
         if (deregister_status == 0) {
@@ -341,10 +556,12 @@ class ClientRuntime {
     }
 
     ugdr_cq *create_cq(ugdr_context *context, int cqe, void *cq_context, ugdr_comp_channel *channel,
-                       int comp_vector) {
+                       int comp_vector, std::uint32_t flags = 0) {
         std::lock_guard lock(mutex_);
         if (contexts_.find(context) == contexts_.end() || !context->live || cqe <= 0 ||
-            channel != nullptr || comp_vector != 0) {
+            channel != nullptr || comp_vector != 0 ||
+            (flags & ~static_cast<std::uint32_t>(UGDR_CREATE_CQ_ATTR_SINGLE_THREADED |
+                                                 UGDR_CREATE_CQ_ATTR_COMPACT_CQE)) != 0) {
             errno = EINVAL;
             return nullptr;
         }
@@ -360,9 +577,11 @@ class ClientRuntime {
         }
         auto cq = std::make_unique<ugdr_cq>();
         std::uint64_t identity = 0;
-        const int create_status = ugdr::control::client_create_cq(client_, context->daemon_identity,
-                                                                  static_cast<std::uint32_t>(cqe),
-                                                                  &identity, &cq->completions);
+        const std::uint32_t create_flags =
+            (flags & UGDR_CREATE_CQ_ATTR_COMPACT_CQE) != 0 ? ugdr::control::kCqCreateCompact : 0;
+        const int create_status = ugdr::control::client_create_cq(
+            client_, context->daemon_identity, static_cast<std::uint32_t>(cqe), &identity,
+            &cq->completions, create_flags, ring_map_options(*context));
         if (create_status != 0) {
             errno = create_status;
             return nullptr;
@@ -372,11 +591,11 @@ class ClientRuntime {
         cq->daemon_identity = identity;
         cq->connection_epoch = client_.connection_epoch();
         cq->cqe = cqe;
+        cq->single_threaded = (flags & UGDR_CREATE_CQ_ATTR_SINGLE_THREADED) != 0;
         cq->live = true;
         ugdr_cq *const result = cq.get();
         try {
             cq_storage_.push_back(std::move(cq));
-            std::unique_lock registry_lock(cq_registry_mutex_);
             cqs_.insert(result);
         } catch (...) {
             result->live = false;
@@ -388,7 +607,7 @@ class ClientRuntime {
 
     int destroy_cq(ugdr_cq *cq) {
         std::lock_guard lock(mutex_);
-        if (cqs_.find(cq) == cqs_.end()) {
+        if (!cqs_.contains(cq)) {
             return EINVAL;
         }
         std::lock_guard polling_lock(cq->polling_mutex);
@@ -412,17 +631,31 @@ class ClientRuntime {
         return destroy_status;
     }
 
+    int modify_cq(ugdr_cq *cq, const ugdr_modify_cq_attr *attr) {
+        std::lock_guard lock(mutex_);
+        if (!cqs_.contains(cq) || attr == nullptr || attr->attr_mask != UGDR_CQ_ATTR_MODERATE) {
+            return EINVAL;
+        }
+        if (!cq->live) {
+            return EINVAL;
+        }
+        const int connect_status = ensure_connected();
+        if (connect_status != 0) {
+            return connect_status;
+        }
+        if (cq->connection_epoch != client_.connection_epoch()) {
+            return EINVAL;
+        }
+        return ugdr::control::client_modify_cq(
+            client_, cq->daemon_identity, {attr->moderate.cq_count, attr->moderate.cq_period});
+    }
+
     int poll_cq(ugdr_cq *cq, int num_entries, ugdr_wc *wc) noexcept {
-        if (cq == nullptr || num_entries < 0 || (num_entries > 0 && wc == nullptr)) {
+        if (cq == nullptr || !cqs_.contains(cq) || num_entries < 0 ||
+            (num_entries > 0 && wc == nullptr)) {
             return -EINVAL;
         }
-        {
-            std::shared_lock registry_lock(cq_registry_mutex_);
-            if (cqs_.find(cq) == cqs_.end()) {
-                return -EINVAL;
-            }
-        }
-        std::lock_guard polling_lock(cq->polling_mutex);
+        DataPathGuard polling_guard(cq->polling_mutex, cq->polling_in_use, cq->single_threaded);
         if (!cq->live) {
             return -EINVAL;
         }
@@ -431,8 +664,8 @@ class ClientRuntime {
         }
 
         ugdr::queue::ConstSlotBatch batch;
-        const int peek_status =
-            cq->completions.consumer_peek(static_cast<std::uint32_t>(num_entries), &batch);
+        const int peek_status = ugdr::queue::peek_completions(
+            cq->completions, static_cast<std::uint32_t>(num_entries), &batch);
         if (peek_status == EAGAIN) {
             return 0;
         }
@@ -456,7 +689,7 @@ class ClientRuntime {
                 completion.byte_len = entry.byte_length;
                 completion.imm_data = entry.immediate_data;
                 completion.qp_num = entry.qp_num;
-                completion.wc_flags = entry.flags;
+                completion.wc_flags = entry.flags & ~ugdr::queue::kCompletionOwnerFlag;
                 wc[output_index++] = completion;
             }
         };
@@ -466,16 +699,54 @@ class ClientRuntime {
         return release_status == 0 ? static_cast<int>(batch.count) : -release_status;
     }
 
-    ugdr_qp *create_qp(ugdr_pd *pd, ugdr_qp_init_attr *init_attr) {
+    // The polling lock taken here is held until end_poll unless start_poll fails.
+    int start_poll(ugdr_cq *cq) noexcept {
+        if (cq == nullptr || !cqs_.contains(cq)) {
+            return EINVAL;
+        }
+        enter_data_path(cq->polling_mutex, cq->polling_in_use, cq->single_threaded);
+        const int status = cq->live ? cq->reader.start(cq->completions) : EINVAL;
+        if (status != 0) {
+            leave_data_path(cq->polling_mutex, cq->polling_in_use, cq->single_threaded);
+        }
+        return status;
+    }
+
+    int next_poll(ugdr_cq *cq) noexcept {
+        return cqs_.contains(cq) ? cq->reader.next() : EINVAL;
+    }
+
+    void end_poll(ugdr_cq *cq) noexcept {
+        if (!cqs_.contains(cq) || !cq->reader.active()) {
+            return;
+        }
+        (void)cq->reader.end();
+        leave_data_path(cq->polling_mutex, cq->polling_in_use, cq->single_threaded);
+    }
+
+    // Outside a successful start_poll the readers see a zeroed UGDR_WC_GENERAL_ERR entry.
+    const ugdr::queue::CompletionEntry &polled_completion(const ugdr_cq *cq) const noexcept {
+        static constexpr ugdr::queue::CompletionEntry unpolled{0, UGDR_WC_GENERAL_ERR};
+        return cqs_.contains(cq) && cq->reader.active() ? cq->reader.current() : unpolled;
+    }
+
+    ugdr_qp *create_qp(ugdr_pd *pd, ugdr_qp_init_attr *init_attr, std::uint32_t create_flags = 0) {
         std::lock_guard lock(mutex_);
         if (pds_.find(pd) == pds_.end() || !pd->live || init_attr == nullptr ||
-            cqs_.find(init_attr->send_cq) == cqs_.end() ||
-            cqs_.find(init_attr->recv_cq) == cqs_.end() || !init_attr->send_cq->live ||
-            !init_attr->recv_cq->live || pd->context != init_attr->send_cq->context ||
+            !cqs_.contains(init_attr->send_cq) || !cqs_.contains(init_attr->recv_cq) ||
+            !init_attr->send_cq->live || !init_attr->recv_cq->live ||
+            pd->context != init_attr->send_cq->context ||
             pd->context != init_attr->recv_cq->context || init_attr->max_send_wr == 0 ||
-            init_attr->max_recv_wr == 0 || init_attr->max_send_sge == 0 ||
-            init_attr->max_recv_sge == 0 || init_attr->qp_type != UGDR_QPT_RC ||
-            (init_attr->sq_sig_all != 0 && init_attr->sq_sig_all != 1)) {
+            init_attr->max_send_sge == 0 || init_attr->qp_type != UGDR_QPT_RC ||
+            (init_attr->sq_sig_all != 0 && init_attr->sq_sig_all != 1) ||
+            (create_flags & ~static_cast<std::uint32_t>(UGDR_QP_CREATE_SINGLE_THREADED)) != 0) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        // As in verbs, the RQ capacities are ignored when the QP draws receives from an SRQ.
+        ugdr_srq *const srq = init_attr->srq;
+        if (srq != nullptr ? !srqs_.contains(srq) || !srq->live || srq->pd->context != pd->context
+                           : init_attr->max_recv_wr == 0 || init_attr->max_recv_sge == 0) {
             errno = EINVAL;
             return nullptr;
         }
@@ -486,8 +757,14 @@ class ClientRuntime {
         }
         const std::uint64_t epoch = client_.connection_epoch();
         if (pd->connection_epoch != epoch || init_attr->send_cq->connection_epoch != epoch ||
-            init_attr->recv_cq->connection_epoch != epoch) {
+            init_attr->recv_cq->connection_epoch != epoch ||
+            (srq != nullptr && srq->connection_epoch != epoch)) {
             pd->live = false;
+            if (srq != nullptr) {
+                std::lock_guard posting_lock(srq->posting_mutex);
+                srq->live = false;
+                srq->receive_queue.reset();
+            }
             if (init_attr->send_cq == init_attr->recv_cq) {
                 std::lock_guard polling_lock(init_attr->send_cq->polling_mutex);
                 init_attr->send_cq->live = false;
@@ -505,17 +782,19 @@ class ClientRuntime {
         attributes.send_cq_identity = init_attr->send_cq->daemon_identity;
         attributes.recv_cq_identity = init_attr->recv_cq->daemon_identity;
         attributes.max_send_wr = init_attr->max_send_wr;
-        attributes.max_recv_wr = init_attr->max_recv_wr;
+        attributes.max_recv_wr = srq != nullptr ? 0 : init_attr->max_recv_wr;
         attributes.max_send_sge = init_attr->max_send_sge;
-        attributes.max_recv_sge = init_attr->max_recv_sge;
+        attributes.max_recv_sge = srq != nullptr ? 0 : init_attr->max_recv_sge;
         attributes.qp_type = static_cast<std::uint32_t>(init_attr->qp_type);
         attributes.sq_sig_all = static_cast<std::uint32_t>(init_attr->sq_sig_all);
+        attributes.srq_identity = srq != nullptr ? srq->daemon_identity : 0;
 
         auto qp = std::make_unique<ugdr_qp>();
         std::uint64_t identity = 0;
         const int create_status =
             ugdr::control::client_create_qp(client_, pd->daemon_identity, attributes, &identity,
-                                            &qp->send_queue, &qp->receive_queue);
+                                            &qp->send_queue, &qp->receive_queue,
+                                            ring_map_options(*pd->context));
         if (create_status != 0) {
             errno = create_status;
             return nullptr;
@@ -525,11 +804,11 @@ class ClientRuntime {
         qp->daemon_identity = identity;
         qp->connection_epoch = epoch;
         qp->cached_state = UGDR_QPS_RESET;
+        qp->single_threaded = (create_flags & UGDR_QP_CREATE_SINGLE_THREADED) != 0;
         qp->live = true;
         ugdr_qp *const result = qp.get();
         try {
             qp_storage_.push_back(std::move(qp));
-            std::unique_lock registry_lock(qp_registry_mutex_);
             qps_.insert(result);
         } catch (...) {
             result->live = false;
@@ -541,7 +820,7 @@ class ClientRuntime {
 
     int destroy_qp(ugdr_qp *qp) {
         std::lock_guard lock(mutex_);
-        if (qps_.find(qp) == qps_.end()) {
+        if (!qps_.contains(qp)) {
             return EINVAL;
         }
         std::lock_guard posting_lock(qp->posting_mutex);
@@ -569,7 +848,7 @@ class ClientRuntime {
 
     int modify_qp(ugdr_qp *qp, const ugdr_qp_attr *attr, int attr_mask) {
         std::lock_guard lock(mutex_);
-        if (qps_.find(qp) == qps_.end() || attr == nullptr || attr_mask < 0) {
+        if (!qps_.contains(qp) || attr == nullptr || attr_mask < 0) {
             return EINVAL;
         }
         std::lock_guard posting_lock(qp->posting_mutex);
@@ -605,8 +884,7 @@ class ClientRuntime {
 
     int query_qp(ugdr_qp *qp, ugdr_qp_attr *attr, int attr_mask, ugdr_qp_init_attr *init_attr) {
         std::lock_guard lock(mutex_);
-        if (qps_.find(qp) == qps_.end() || attr == nullptr || init_attr == nullptr ||
-            attr_mask < 0) {
+        if (!qps_.contains(qp) || attr == nullptr || init_attr == nullptr || attr_mask < 0) {
             return EINVAL;
         }
         std::lock_guard posting_lock(qp->posting_mutex);
@@ -667,7 +945,7 @@ class ClientRuntime {
 
     int query_qp_conn_info(ugdr_qp *qp, ugdr_qp_conn_info *info) {
         std::lock_guard lock(mutex_);
-        if (qps_.find(qp) == qps_.end() || info == nullptr) {
+        if (!qps_.contains(qp) || info == nullptr) {
             return EINVAL;
         }
         std::lock_guard posting_lock(qp->posting_mutex);
@@ -696,8 +974,8 @@ class ClientRuntime {
     int connect_qp(ugdr_qp *qp, const ugdr_qp_conn_info *remote_info, const ugdr_qp_attr *attr,
                    int attr_mask) {
         std::lock_guard lock(mutex_);
-        if (qps_.find(qp) == qps_.end() || remote_info == nullptr || attr == nullptr ||
-            attr_mask < 0 || remote_info->qp_num == 0) {
+        if (!qps_.contains(qp) || remote_info == nullptr || attr == nullptr || attr_mask < 0 ||
+            remote_info->qp_num == 0) {
             return EINVAL;
         }
         std::lock_guard posting_lock(qp->posting_mutex);
@@ -728,21 +1006,101 @@ class ClientRuntime {
         return status;
     }
 
-    int post_send(ugdr_qp *qp, ugdr_send_wr *wr, ugdr_send_wr **bad_wr) noexcept {
-        if (qp == nullptr || wr == nullptr || bad_wr == nullptr) {
+    ugdr_srq *create_srq(ugdr_pd *pd, const ugdr_srq_init_attr *srq_init_attr) {
+        std::lock_guard lock(mutex_);
+        if (pds_.find(pd) == pds_.end() || !pd->live || srq_init_attr == nullptr ||
+            srq_init_attr->max_wr == 0 || srq_init_attr->max_sge == 0) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        const int connect_status = ensure_connected();
+        if (connect_status != 0) {
+            errno = connect_status;
+            return nullptr;
+        }
+        if (pd->connection_epoch != client_.connection_epoch()) {
+            pd->live = false;
+            errno = EINVAL;
+            return nullptr;
+        }
+        auto srq = std::make_unique<ugdr_srq>();
+        std::uint64_t identity = 0;
+        const int create_status = ugdr::control::client_create_srq(
+            client_, pd->daemon_identity, srq_init_attr->max_wr, srq_init_attr->max_sge,
+            &identity, &srq->receive_queue, ring_map_options(*pd->context));
+        if (create_status != 0) {
+            errno = create_status;
+            return nullptr;
+        }
+        srq->pd = pd;
+        srq->srq_context = srq_init_attr->srq_context;
+        srq->daemon_identity = identity;
+        srq->connection_epoch = client_.connection_epoch();
+        srq->max_wr = srq_init_attr->max_wr;
+        srq->max_sge = srq_init_attr->max_sge;
+        srq->live = true;
+        ugdr_srq *const result = srq.get();
+        try {
+            srq_storage_.push_back(std::move(srq));
+            srqs_.insert(result);
+        } catch (...) {
+            result->live = false;
+            (void)ugdr::control::client_destroy_srq(client_, identity);
+            throw;
+        }
+        return result;
+    }
+
+    int destroy_srq(ugdr_srq *srq) {
+        std::lock_guard lock(mutex_);
+        if (!srqs_.contains(srq)) {
+            return EINVAL;
+        }
+        std::lock_guard posting_lock(srq->posting_mutex);
+        if (!srq->live) {
+            return EINVAL;
+        }
+        const int connect_status = ensure_connected();
+        if (connect_status != 0) {
+            return connect_status;
+        }
+        if (srq->connection_epoch != client_.connection_epoch()) {
+            srq->live = false;
+            srq->receive_queue.reset();
+            return EINVAL;
+        }
+        const int destroy_status = ugdr::control::client_destroy_srq(client_, srq->daemon_identity);
+        if (destroy_status == 0) {
+            srq->live = false;
+            srq->receive_queue.reset();
+        }
+        return destroy_status;
+    }
+
+    // Any thread may post to an SRQ, so posting always takes its mutex.
+    int post_srq_receive(ugdr_srq *srq, ugdr_recv_wr *wr, ugdr_recv_wr **bad_wr) noexcept {
+        if (srq == nullptr || !srqs_.contains(srq) || wr == nullptr || bad_wr == nullptr) {
             if (wr != nullptr && bad_wr != nullptr) {
                 *bad_wr = wr;
             }
             return EINVAL;
         }
-        {
-            std::shared_lock registry_lock(qp_registry_mutex_);
-            if (qps_.find(qp) == qps_.end()) {
+        DataPathGuard posting_guard(srq->posting_mutex, srq->posting_in_use, false);
+        if (!srq->live) {
+            *bad_wr = wr;
+            return EINVAL;
+        }
+        return ugdr::api::post_receive_chain(srq->receive_queue, srq->max_sge, wr, bad_wr);
+    }
+
+    int post_send(ugdr_qp *qp, ugdr_send_wr *wr, ugdr_send_wr **bad_wr) noexcept {
+        if (qp == nullptr || !qps_.contains(qp) || wr == nullptr || bad_wr == nullptr) {
+            if (wr != nullptr && bad_wr != nullptr) {
                 *bad_wr = wr;
-                return EINVAL;
             }
+            return EINVAL;
         }
-        std::lock_guard posting_lock(qp->posting_mutex);
+        DataPathGuard posting_guard(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
         if (!qp->live || qp->cached_state != UGDR_QPS_RTS) {
             *bad_wr = wr;
             return EINVAL;
@@ -751,22 +1109,16 @@ class ClientRuntime {
     }
 
     int post_receive(ugdr_qp *qp, ugdr_recv_wr *wr, ugdr_recv_wr **bad_wr) noexcept {
-        if (qp == nullptr || wr == nullptr || bad_wr == nullptr) {
+        if (qp == nullptr || !qps_.contains(qp) || wr == nullptr || bad_wr == nullptr) {
             if (wr != nullptr && bad_wr != nullptr) {
                 *bad_wr = wr;
             }
             return EINVAL;
         }
-        {
-            std::shared_lock registry_lock(qp_registry_mutex_);
-            if (qps_.find(qp) == qps_.end()) {
-                *bad_wr = wr;
-                return EINVAL;
-            }
-        }
-        std::lock_guard posting_lock(qp->posting_mutex);
-        if (!qp->live || (qp->cached_state != UGDR_QPS_INIT && qp->cached_state != UGDR_QPS_RTR &&
-                          qp->cached_state != UGDR_QPS_RTS)) {
+        DataPathGuard posting_guard(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        if (!qp->live || qp->init_attr.srq != nullptr ||
+            (qp->cached_state != UGDR_QPS_INIT && qp->cached_state != UGDR_QPS_RTR &&
+             qp->cached_state != UGDR_QPS_RTS)) {
             *bad_wr = wr;
             return EINVAL;
         }
@@ -774,6 +1126,112 @@ class ClientRuntime {
                                              bad_wr);
     }
 
+    int post_send_batch(ugdr_qp *qp, const ugdr_send_wr *wrs, int count, int *posted) noexcept {
+        if (posted != nullptr) {
+            *posted = 0;
+        }
+        if (qp == nullptr || !qps_.contains(qp) || posted == nullptr) {
+            return EINVAL;
+        }
+        DataPathGuard posting_guard(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        if (!qp->live || qp->cached_state != UGDR_QPS_RTS) {
+            return EINVAL;
+        }
+        return ugdr::api::post_send_array(qp->send_queue, qp->init_attr.max_send_sge, wrs, count,
+                                          posted);
+    }
+
+    int post_receive_batch(ugdr_qp *qp, const ugdr_recv_wr *wrs, int count, int *posted) noexcept {
+        if (posted != nullptr) {
+            *posted = 0;
+        }
+        if (qp == nullptr || !qps_.contains(qp) || posted == nullptr) {
+            return EINVAL;
+        }
+        DataPathGuard posting_guard(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        if (!qp->live || qp->init_attr.srq != nullptr ||
+            (qp->cached_state != UGDR_QPS_INIT && qp->cached_state != UGDR_QPS_RTR &&
+             qp->cached_state != UGDR_QPS_RTS)) {
+            return EINVAL;
+        }
+        return ugdr::api::post_receive_array(qp->receive_queue, qp->init_attr.max_recv_sge, wrs,
+                                             count, posted);
+    }
+
+    int create_send_template(ugdr_qp *qp, const ugdr_send_wr *shape,
+                             std::uint32_t *template_id) {
+        if (qp == nullptr || !qps_.contains(qp) || shape == nullptr || template_id == nullptr) {
+            return EINVAL;
+        }
+        DataPathGuard posting_guard(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        ugdr::api::SendTemplate send_template;
+        const int status =
+            qp->live ? ugdr::api::make_send_template(*shape, qp->init_attr.max_send_sge,
+                                                     &send_template)
+                     : EINVAL;
+        if (status != 0) {
+            return status;
+        }
+        if (qp->send_templates.size() == std::numeric_limits<std::uint32_t>::max()) {
+            return ENOMEM;
+        }
+        qp->send_templates.push_back(send_template);
+        *template_id = static_cast<std::uint32_t>(qp->send_templates.size() - 1);
+        return 0;
+    }
+
+    int post_send_template(ugdr_qp *qp, std::uint32_t template_id, std::uint64_t wr_id,
+                           std::uint64_t local_addr, std::uint64_t remote_addr) noexcept {
+        if (qp == nullptr || !qps_.contains(qp)) {
+            return EINVAL;
+        }
+        DataPathGuard posting_guard(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        if (!qp->live || qp->cached_state != UGDR_QPS_RTS ||
+            template_id >= qp->send_templates.size()) {
+            return EINVAL;
+        }
+        return ugdr::api::post_send_template(qp->send_queue, qp->send_templates[template_id],
+                                             wr_id, local_addr, remote_addr);
+    }
+
+    // The posting lock taken here is held until wr_complete or wr_abort.
+    int wr_start(ugdr_qp *qp) noexcept {
+        if (qp == nullptr || !qps_.contains(qp)) {
+            return EINVAL;
+        }
+        enter_data_path(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        const int status =
+            qp->live && qp->cached_state == UGDR_QPS_RTS
+                ? qp->send_builder.start(qp->send_queue, qp->init_attr.max_send_sge)
+                : EINVAL;
+        if (status != 0) {
+            leave_data_path(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        }
+        return status;
+    }
+
+    // Null for an invalid handle. A valid QP's builder ignores calls outside start and complete.
+    ugdr::api::SendWqeBuilder *send_builder(ugdr_qp *qp) noexcept {
+        return qps_.contains(qp) ? &qp->send_builder : nullptr;
+    }
+
+    int wr_complete(ugdr_qp *qp) noexcept {
+        if (!qps_.contains(qp) || !qp->send_builder.active()) {
+            return EINVAL;
+        }
+        const int status = qp->send_builder.complete();
+        leave_data_path(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+        return status;
+    }
+
+    void wr_abort(ugdr_qp *qp) noexcept {
+        if (!qps_.contains(qp) || !qp->send_builder.active()) {
+            return;
+        }
+        qp->send_builder.abort();
+        leave_data_path(qp->posting_mutex, qp->posting_in_use, qp->single_threaded);
+    }
+
   private:
     int ensure_connected() {
         if (client_.connected()) {
@@ -786,9 +1244,26 @@ class ClientRuntime {
         return client_.connect(path);
     }
 
+    // Eviction is lazy; a failed deregistration leaves the registration idle for a later retry.
+    int deregister_idle_mr(ugdr_mr *mr) {
+        MrProxyRecord *const record = mrs_.at(mr);
+        if (record->connection_epoch == client_.connection_epoch()) {
+            const int status =
+                ugdr::control::client_deregister_mr(client_, record->daemon_identity);
+            if (status != 0) {
+                return status;
+            }
+        }
+        mr_cache_.erase(mr);
+        record->live = false;
+        return 0;
+    }
+
+    ugdr::control::RingMapOptions ring_map_options(const ugdr_context &context) const {
+        return {context.ring_arena, ring_prefault_};
+    }
+
     std::mutex mutex_;
-    std::shared_mutex cq_registry_mutex_;
-    std::shared_mutex qp_registry_mutex_;
     ugdr::control::ControlClient client_;
     std::vector<std::unique_ptr<DeviceListRecord>> list_storage_;
     std::vector<std::unique_ptr<ugdr_device>> device_storage_;
@@ -797,13 +1272,18 @@ class ClientRuntime {
     std::vector<std::unique_ptr<MrProxyRecord>> mr_storage_;
     std::vector<std::unique_ptr<ugdr_cq>> cq_storage_;
     std::vector<std::unique_ptr<ugdr_qp>> qp_storage_;
+    std::vector<std::unique_ptr<ugdr_srq>> srq_storage_;
     std::unordered_map<ugdr_device **, DeviceListRecord *> lists_;
     std::unordered_set<ugdr_device *> devices_;
     std::unordered_set<ugdr_context *> contexts_;
     std::unordered_set<ugdr_pd *> pds_;
     std::unordered_map<ugdr_mr *, MrProxyRecord *> mrs_;
-    std::unordered_set<ugdr_cq *> cqs_;
-    std::unordered_set<ugdr_qp *> qps_;
+    ugdr::api::MrRegistrationCache mr_cache_{configured_mr_cache_limit()};
+    const std::size_t ring_arena_bytes_ = configured_ring_arena_bytes();
+    const bool ring_prefault_ = configured_ring_prefault();
+    HandleTable<ugdr_cq> cqs_;
+    HandleTable<ugdr_qp> qps_;
+    HandleTable<ugdr_srq> srqs_;
     std::uint64_t next_mr_handle_ = 1;
 };
 
@@ -895,6 +1375,22 @@ ugdr_cq *ugdr_create_cq(ugdr_context *context, int cqe, void *cq_context,
     }
 }
 
+ugdr_cq *ugdr_create_cq_ex(ugdr_context *context, ugdr_cq_init_attr_ex *cq_attr) noexcept {
+    constexpr auto int_max = static_cast<std::uint32_t>(std::numeric_limits<int>::max());
+    if (cq_attr == nullptr || cq_attr->cqe > int_max || cq_attr->comp_vector > int_max) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    try {
+        return runtime().create_cq(context, static_cast<int>(cq_attr->cqe), cq_attr->cq_context,
+                                   cq_attr->channel, static_cast<int>(cq_attr->comp_vector),
+                                   cq_attr->flags);
+    } catch (...) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+}
+
 int ugdr_destroy_cq(ugdr_cq *cq) noexcept {
     try {
         return runtime().destroy_cq(cq);
@@ -903,6 +1399,14 @@ int ugdr_destroy_cq(ugdr_cq *cq) noexcept {
     }
 }
 
+int ugdr_modify_cq(ugdr_cq *cq, ugdr_modify_cq_attr *attr) noexcept {
+    try {
+        return runtime().modify_cq(cq, attr);
+    } catch (...) {
+        return ENOMEM;
+    }
+}
+
 int ugdr_poll_cq(ugdr_cq *cq, int num_entries, ugdr_wc *wc) noexcept {
     if (num_entries < 0 || (num_entries > 0 && wc == nullptr)) {
         return -EINVAL;
@@ -923,6 +1427,29 @@ ugdr_qp *ugdr_create_qp(ugdr_pd *pd, ugdr_qp_init_attr *init_attr) noexcept {
     }
 }
 
+ugdr_qp *ugdr_create_qp_ex(ugdr_pd *pd, ugdr_qp_init_attr_ex *init_attr) noexcept {
+    if (init_attr == nullptr) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    ugdr_qp_init_attr attributes{};
+    attributes.send_cq = init_attr->send_cq;
+    attributes.recv_cq = init_attr->recv_cq;
+    attributes.max_send_wr = init_attr->max_send_wr;
+    attributes.max_recv_wr = init_attr->max_recv_wr;
+    attributes.max_send_sge = init_attr->max_send_sge;
+    attributes.max_recv_sge = init_attr->max_recv_sge;
+    attributes.qp_type = init_attr->qp_type;
+    attributes.sq_sig_all = init_attr->sq_sig_all;
+    attributes.srq = init_attr->srq;
+    try {
+        return runtime().create_qp(pd, &attributes, init_attr->create_flags);
+    } catch (...) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+}
+
 int ugdr_destroy_qp(ugdr_qp *qp) noexcept {
     try {
         return runtime().destroy_qp(qp);
@@ -931,6 +1458,27 @@ int ugdr_destroy_qp(ugdr_qp *qp) noexcept {
     }
 }
 
+ugdr_srq *ugdr_create_srq(ugdr_pd *pd, ugdr_srq_init_attr *srq_init_attr) noexcept {
+    try {
+        return runtime().create_srq(pd, srq_init_attr);
+    } catch (...) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+}
+
+int ugdr_destroy_srq(ugdr_srq *srq) noexcept {
+    try {
+        return runtime().destroy_srq(srq);
+    } catch (...) {
+        return ENOMEM;
+    }
+}
+
+int ugdr_post_srq_recv(ugdr_srq *srq, ugdr_recv_wr *wr, ugdr_recv_wr **bad_wr) noexcept {
+    return runtime().post_srq_receive(srq, wr, bad_wr);
+}
+
 int ugdr_modify_qp(ugdr_qp *qp, ugdr_qp_attr *attr, int attr_mask) noexcept {
     try {
         return runtime().modify_qp(qp, attr, attr_mask);
@@ -973,4 +1521,104 @@ int ugdr_post_recv(ugdr_qp *qp, ugdr_recv_wr *wr, ugdr_recv_wr **bad_wr) noexcep
     return runtime().post_receive(qp, wr, bad_wr);
 }
 
+int ugdr_post_send_batch(ugdr_qp *qp, const ugdr_send_wr *wrs, int count, int *posted) noexcept {
+    return runtime().post_send_batch(qp, wrs, count, posted);
+}
+
+int ugdr_post_recv_batch(ugdr_qp *qp, const ugdr_recv_wr *wrs, int count, int *posted) noexcept {
+    return runtime().post_receive_batch(qp, wrs, count, posted);
+}
+
+int ugdr_create_send_template(ugdr_qp *qp, const ugdr_send_wr *shape,
+                              uint32_t *template_id) noexcept {
+    try {
+        return runtime().create_send_template(qp, shape, template_id);
+    } catch (...) {
+        return ENOMEM;
+    }
+}
+
+int ugdr_post_send_template(ugdr_qp *qp, uint32_t template_id, uint64_t wr_id,
+                            uint64_t local_addr, uint64_t remote_addr) noexcept {
+    return runtime().post_send_template(qp, template_id, wr_id, local_addr, remote_addr);
+}
+
+int ugdr_start_poll(ugdr_cq *cq) noexcept {
+    return runtime().start_poll(cq);
+}
+
+int ugdr_next_poll(ugdr_cq *cq) noexcept {
+    return runtime().next_poll(cq);
+}
+
+void ugdr_end_poll(ugdr_cq *cq) noexcept {
+    runtime().end_poll(cq);
+}
+
+uint64_t ugdr_wc_read_wr_id(const ugdr_cq *cq) noexcept {
+    return runtime().polled_completion(cq).wr_id;
+}
+
+ugdr_wc_status ugdr_wc_read_status(const ugdr_cq *cq) noexcept {
+    return static_cast<ugdr_wc_status>(runtime().polled_completion(cq).status);
+}
+
+ugdr_wc_opcode ugdr_wc_read_opcode(const ugdr_cq *cq) noexcept {
+    return static_cast<ugdr_wc_opcode>(runtime().polled_completion(cq).opcode);
+}
+
+uint32_t ugdr_wc_read_byte_len(const ugdr_cq *cq) noexcept {
+    return runtime().polled_completion(cq).byte_length;
+}
+
+uint32_t ugdr_wc_read_imm_data(const ugdr_cq *cq) noexcept {
+    return runtime().polled_completion(cq).immediate_data;
+}
+
+uint32_t ugdr_wc_read_qp_num(const ugdr_cq *cq) noexcept {
+    return runtime().polled_completion(cq).qp_num;
+}
+
+unsigned int ugdr_wc_read_wc_flags(const ugdr_cq *cq) noexcept {
+    return runtime().polled_completion(cq).flags & ~ugdr::queue::kCompletionOwnerFlag;
+}
+
+int ugdr_wr_start(ugdr_qp *qp) noexcept {
+    return runtime().wr_start(qp);
+}
+
+void ugdr_wr_rdma_write(ugdr_qp *qp, uint64_t wr_id, unsigned int send_flags, uint32_t rkey,
+                        uint64_t remote_addr) noexcept {
+    if (ugdr::api::SendWqeBuilder *const builder = runtime().send_builder(qp)) {
+        builder->rdma_write(wr_id, send_flags, rkey, remote_addr);
+    }
+}
+
+void ugdr_wr_rdma_write_imm(ugdr_qp *qp, uint64_t wr_id, unsigned int send_flags, uint32_t rkey,
+                            uint64_t remote_addr, uint32_t imm_data) noexcept {
+    if (ugdr::api::SendWqeBuilder *const builder = runtime().send_builder(qp)) {
+        builder->rdma_write_imm(wr_id, send_flags, rkey, remote_addr, imm_data);
+    }
+}
+
+void ugdr_wr_set_sge(ugdr_qp *qp, uint32_t lkey, uint64_t addr, uint32_t length) noexcept {
+    if (ugdr::api::SendWqeBuilder *const builder = runtime().send_builder(qp)) {
+        builder->set_sge(lkey, addr, length);
+    }
+}
+
+void ugdr_wr_set_sge_list(ugdr_qp *qp, size_t num_sge, const ugdr_sge *sg_list) noexcept {
+    if (ugdr::api::SendWqeBuilder *const builder = runtime().send_builder(qp)) {
+        builder->set_sge_list(num_sge, sg_list);
+    }
+}
+
+int ugdr_wr_complete(ugdr_qp *qp) noexcept {
+    return runtime().wr_complete(qp);
+}
+
+void ugdr_wr_abort(ugdr_qp *qp) noexcept {
+    runtime().wr_abort(qp);
+}
+
 }  // extern "C"
@@ -0,0 +1,129 @@
+#include "api/mr_registration_cache.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ugdr::api {
+namespace {
+
+std::uint64_t address_of(const ugdr_mr *mr) noexcept {
+    return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(mr->addr));
+}
+
+}  // namespace
+
+MrRegistrationCache::MrRegistrationCache(std::size_t idle_limit) noexcept
+    : idle_limit_(idle_limit) {
+}
+
+bool MrRegistrationCache::enabled() const noexcept {
+    return idle_limit_ != 0;
+}
+
+ugdr_mr *MrRegistrationCache::acquire(const ugdr_pd *pd, std::uint64_t address,
+                                      std::uint64_t length, std::uint32_t access) noexcept {
+    if (address > std::numeric_limits<std::uint64_t>::max() - length) {
+        return nullptr;
+    }
+    // Entries are ordered by start address, so only those starting at or below address can
+    // contain the range.
+    auto found = entries_.upper_bound(Key{pd, access, address});
+    while (found != entries_.begin()) {
+        --found;
+        if (std::get<0>(found->first) != pd || std::get<1>(found->first) != access) {
+            return nullptr;
+        }
+        Entry &entry = found->second;
+        if (entry.end >= address + length) {
+            if (entry.references++ == 0) {
+                idle_.erase(entry.idle);
+            }
+            return entry.mr;
+        }
+    }
+    return nullptr;
+}
+
+bool MrRegistrationCache::insert(ugdr_mr *mr, std::uint32_t access) {
+    const std::uint64_t address = address_of(mr);
+    const Key key{mr->pd, access, address};
+    const auto [entry, inserted] = entries_.try_emplace(key);
+    if (!inserted) {
+        return false;
+    }
+    try {
+        keys_.emplace(mr, key);
+    } catch (...) {
+        entries_.erase(entry);
+        throw;
+    }
+    entry->second.mr = mr;
+    entry->second.end = address + mr->length;
+    entry->second.references = 1;
+    return true;
+}
+
+int MrRegistrationCache::release(ugdr_mr *mr) noexcept {
+    const auto found = find(mr);
+    if (found == entries_.end() || found->second.references == 0) {
+        return EINVAL;
+    }
+    Entry &entry = found->second;
+    if (--entry.references == 0) {
+        try {
+            entry.idle = idle_.insert(idle_.end(), mr);
+        } catch (...) {
+            // Without room to park it, the registration stays referenced until erased.
+            entry.references = 1;
+            return ENOMEM;
+        }
+    }
+    return 0;
+}
+
+void MrRegistrationCache::erase(ugdr_mr *mr) noexcept {
+    const auto found = find(mr);
+    if (found == entries_.end()) {
+        return;
+    }
+    if (found->second.references == 0) {
+        idle_.erase(found->second.idle);
+    }
+    entries_.erase(found);
+    keys_.erase(mr);
+}
+
+bool MrRegistrationCache::contains(const ugdr_mr *mr) const noexcept {
+    return keys_.find(mr) != keys_.end();
+}
+
+ugdr_mr *MrRegistrationCache::next_eviction() const noexcept {
+    return idle_.size() > idle_limit_ ? idle_.front() : nullptr;
+}
+
+ugdr_mr *MrRegistrationCache::idle_in(const ugdr_pd *pd) const noexcept {
+    for (ugdr_mr *mr : idle_) {
+        if (mr->pd == pd) {
+            return mr;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t MrRegistrationCache::size() const noexcept {
+    return entries_.size();
+}
+
+std::size_t MrRegistrationCache::idle_count() const noexcept {
+    return idle_.size();
+}
+
+std::map<MrRegistrationCache::Key, MrRegistrationCache::Entry>::iterator
+MrRegistrationCache::find(const ugdr_mr *mr) noexcept {
+    const auto key = keys_.find(mr);
+    return key != keys_.end() ? entries_.find(key->second) : entries_.end();
+}
+
+}  // namespace ugdr::api
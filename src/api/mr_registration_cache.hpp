@@ -0,0 +1,61 @@
+#pragma once
+
+#include "ugdr/api.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <tuple>
+
+namespace ugdr::api {
+
+// Client-side pin-down cache. A registration is shared by every reg_mr whose range it fully
+// contains under the same PD and access, and is reference counted. When the last reference is
+// released the registration stays cached as idle; past idle_limit the least recently used idle
+// registration is offered for deregistration. A zero idle_limit disables the cache.
+//
+// The cache cannot see cudaFree. It is only correct while cached device memory stays allocated.
+class MrRegistrationCache {
+  public:
+    explicit MrRegistrationCache(std::size_t idle_limit = 0) noexcept;
+
+    [[nodiscard]] bool enabled() const noexcept;
+
+    // Returns a cached registration covering [address, address + length) and takes a reference.
+    ugdr_mr *acquire(const ugdr_pd *pd, std::uint64_t address, std::uint64_t length,
+                     std::uint32_t access) noexcept;
+    // Adds a new registration holding one reference. Returns false, leaving mr uncached, when a
+    // registration with the same PD, access, and start address is already cached.
+    bool insert(ugdr_mr *mr, std::uint32_t access);
+    // Drops one reference. Returns EINVAL when mr is not cached or holds no reference.
+    int release(ugdr_mr *mr) noexcept;
+    void erase(ugdr_mr *mr) noexcept;
+
+    [[nodiscard]] bool contains(const ugdr_mr *mr) const noexcept;
+    // Idle registrations the caller should deregister and erase, or nullptr when none.
+    [[nodiscard]] ugdr_mr *next_eviction() const noexcept;
+    [[nodiscard]] ugdr_mr *idle_in(const ugdr_pd *pd) const noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::size_t idle_count() const noexcept;
+
+  private:
+    using Key = std::tuple<const ugdr_pd *, std::uint32_t, std::uint64_t>;
+
+    struct Entry {
+        ugdr_mr *mr = nullptr;
+        std::uint64_t end = 0;
+        std::uint32_t references = 0;
+        std::list<ugdr_mr *>::iterator idle;
+    };
+
+    std::map<Key, Entry>::iterator find(const ugdr_mr *mr) noexcept;
+
+    std::size_t idle_limit_ = 0;
+    std::map<Key, Entry> entries_;
+    std::map<const ugdr_mr *, Key> keys_;
+    std::list<ugdr_mr *> idle_;
+};
+
+}  // namespace ugdr::api
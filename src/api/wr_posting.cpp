@@ -1,14 +1,26 @@
 #include "api/wr_posting.hpp"
 
-#include "queue/descriptors.hpp"
-
 #include <cerrno>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 namespace ugdr::api {
 namespace {
 
+static_assert(sizeof(ugdr_sge) == sizeof(queue::SharedSge));
+static_assert(offsetof(ugdr_sge, addr) == offsetof(queue::SharedSge, address));
+static_assert(offsetof(ugdr_sge, length) == offsetof(queue::SharedSge, length));
+static_assert(offsetof(ugdr_sge, lkey) == offsetof(queue::SharedSge, lkey));
+
+// The public and shared SGE layouts match, so each entry is a fixed-size 16-byte move.
+void copy_sges(void *destination, const ugdr_sge *sg_list, std::size_t num_sge) noexcept {
+    auto *const bytes = static_cast<std::byte *>(destination);
+    for (std::size_t index = 0; index < num_sge; ++index) {
+        std::memcpy(bytes + index * sizeof(ugdr_sge), sg_list + index, sizeof(ugdr_sge));
+    }
+}
+
 bool valid_sge_list(int num_sge, const ugdr_sge *sg_list, std::uint32_t max_sge) noexcept {
     return num_sge >= 0 && static_cast<std::uint32_t>(num_sge) <= max_sge &&
            (num_sge == 0 || sg_list != nullptr);
@@ -35,12 +47,7 @@ void encode_send(void *slot, const ugdr_send_wr &wr) noexcept {
     header->send_flags = wr.send_flags;
     header->immediate_data = wr.opcode == UGDR_WR_RDMA_WRITE_WITH_IMM ? wr.imm_data : 0;
     header->sge_count = static_cast<std::uint32_t>(wr.num_sge);
-
-    auto *const destination = reinterpret_cast<queue::SharedSge *>(header + 1);
-    for (int index = 0; index < wr.num_sge; ++index) {
-        destination[index] = {wr.sg_list[index].addr, wr.sg_list[index].length,
-                              wr.sg_list[index].lkey};
-    }
+    copy_sges(header + 1, wr.sg_list, static_cast<std::size_t>(wr.num_sge));
 }
 
 void encode_receive(void *slot, const ugdr_recv_wr &wr) noexcept {
@@ -48,12 +55,7 @@ void encode_receive(void *slot, const ugdr_recv_wr &wr) noexcept {
     *header = {};
     header->wr_id = wr.wr_id;
     header->sge_count = static_cast<std::uint32_t>(wr.num_sge);
-
-    auto *const destination = reinterpret_cast<queue::SharedSge *>(header + 1);
-    for (int index = 0; index < wr.num_sge; ++index) {
-        destination[index] = {wr.sg_list[index].addr, wr.sg_list[index].length,
-                              wr.sg_list[index].lkey};
-    }
+    copy_sges(header + 1, wr.sg_list, static_cast<std::size_t>(wr.num_sge));
 }
 
 template <typename Wr, typename Validator, typename Encoder>
@@ -102,6 +104,54 @@ int post_chain(queue::SharedRing &ring, std::uint32_t max_sge, Wr *wr, Wr **bad_
     return 0;
 }
 
+template <typename Wr, typename Validator, typename Encoder>
+int post_array(queue::SharedRing &ring, std::uint32_t max_sge, const Wr *wrs, int count,
+               int *posted, Validator validator, Encoder encoder) noexcept {
+    if (posted != nullptr) {
+        *posted = 0;
+    }
+    if (count < 0 || (count > 0 && wrs == nullptr) || posted == nullptr || !ring.valid()) {
+        return EINVAL;
+    }
+
+    const auto total = static_cast<std::uint32_t>(count);
+    const std::uint32_t stride = ring.descriptor().slot_stride;
+    std::uint32_t done = 0;
+    while (done < total) {
+        queue::MutableSlotBatch batch;
+        const int reserve_status = ring.producer_reserve(total - done, &batch);
+        if (reserve_status != 0) {
+            *posted = static_cast<int>(done);
+            return reserve_status == EAGAIN ? ENOMEM : reserve_status;
+        }
+
+        const std::uint32_t batch_start = done;
+        auto fill_span = [&](queue::MutableSlotSpan span) noexcept -> bool {
+            auto *slot = static_cast<std::byte *>(span.data);
+            for (std::uint32_t index = 0; index < span.count; ++index, ++done) {
+                if (!validator(wrs[done], max_sge)) {
+                    return false;
+                }
+                encoder(slot + static_cast<std::size_t>(index) * stride, wrs[done]);
+            }
+            return true;
+        };
+
+        const bool valid = fill_span(batch.first) && fill_span(batch.second);
+        const int publish_status = ring.producer_publish(done - batch_start);
+        if (publish_status != 0) {
+            *posted = static_cast<int>(batch_start);
+            return publish_status;
+        }
+        if (!valid) {
+            *posted = static_cast<int>(done);
+            return EINVAL;
+        }
+    }
+    *posted = static_cast<int>(done);
+    return 0;
+}
+
 }  // namespace
 
 int post_send_chain(queue::SharedRing &ring, std::uint32_t max_sge, ugdr_send_wr *wr,
@@ -120,4 +170,159 @@ int post_receive_chain(queue::SharedRing &ring, std::uint32_t max_sge, ugdr_recv
     return post_chain(ring, max_sge, wr, bad_wr, valid_receive_wr, encode_receive);
 }
 
+int post_send_array(queue::SharedRing &ring, std::uint32_t max_sge, const ugdr_send_wr *wrs,
+                    int count, int *posted) noexcept {
+    if (ring.descriptor().kind != queue::QueueKind::send) {
+        return EINVAL;
+    }
+    return post_array(ring, max_sge, wrs, count, posted, valid_send_wr, encode_send);
+}
+
+int post_receive_array(queue::SharedRing &ring, std::uint32_t max_sge, const ugdr_recv_wr *wrs,
+                       int count, int *posted) noexcept {
+    if (ring.descriptor().kind != queue::QueueKind::receive) {
+        return EINVAL;
+    }
+    return post_array(ring, max_sge, wrs, count, posted, valid_receive_wr, encode_receive);
+}
+
+int make_send_template(const ugdr_send_wr &shape, std::uint32_t max_sge,
+                       SendTemplate *send_template) noexcept {
+    if (send_template == nullptr || shape.num_sge > 1 || !valid_send_wr(shape, max_sge)) {
+        return EINVAL;
+    }
+    SendTemplate encoded{};
+    encode_send(&encoded, shape);
+    *send_template = encoded;
+    return 0;
+}
+
+int post_send_template(queue::SharedRing &ring, const SendTemplate &send_template,
+                       std::uint64_t wr_id, std::uint64_t local_addr,
+                       std::uint64_t remote_addr) noexcept {
+    void *slot = nullptr;
+    const int reserve_status = ring.producer_reserve(&slot);
+    if (reserve_status != 0) {
+        return reserve_status == EAGAIN ? ENOMEM : reserve_status;
+    }
+    auto *const encoded = static_cast<SendTemplate *>(slot);
+    std::memcpy(encoded, &send_template, sizeof(SendTemplate));
+    encoded->header.wr_id = wr_id;
+    encoded->header.remote_address = remote_addr;
+    encoded->sge.address = local_addr;
+    return ring.producer_publish();
+}
+
+int SendWqeBuilder::start(queue::SharedRing &ring, std::uint32_t max_sge) noexcept {
+    if (ring_ != nullptr || !ring.valid() || ring.descriptor().kind != queue::QueueKind::send) {
+        return EINVAL;
+    }
+    batch_ = {};
+    const int reserve_status = ring.producer_reserve(ring.descriptor().capacity, &batch_);
+    if (reserve_status != 0 && reserve_status != EAGAIN) {
+        return reserve_status;
+    }
+    ring_ = &ring;
+    cursor_ = static_cast<std::byte *>(batch_.first.data);
+    span_left_ = batch_.first.count;
+    stride_ = ring.descriptor().slot_stride;
+    max_sge_ = max_sge;
+    used_ = 0;
+    current_ = nullptr;
+    error_ = 0;
+    return 0;
+}
+
+void SendWqeBuilder::rdma_write(std::uint64_t wr_id, unsigned int send_flags, std::uint32_t rkey,
+                                std::uint64_t remote_addr) noexcept {
+    if (queue::SendWqeHeader *const header = next_header(wr_id, send_flags)) {
+        header->remote_address = remote_addr;
+        header->rkey = rkey;
+        header->opcode = UGDR_WR_RDMA_WRITE;
+    }
+}
+
+void SendWqeBuilder::rdma_write_imm(std::uint64_t wr_id, unsigned int send_flags,
+                                    std::uint32_t rkey, std::uint64_t remote_addr,
+                                    std::uint32_t imm_data) noexcept {
+    if (queue::SendWqeHeader *const header = next_header(wr_id, send_flags)) {
+        header->remote_address = remote_addr;
+        header->rkey = rkey;
+        header->opcode = UGDR_WR_RDMA_WRITE_WITH_IMM;
+        header->immediate_data = imm_data;
+    }
+}
+
+void SendWqeBuilder::set_sge(std::uint32_t lkey, std::uint64_t addr,
+                             std::uint32_t length) noexcept {
+    const ugdr_sge sge{addr, length, lkey};
+    set_sge_list(1, &sge);
+}
+
+void SendWqeBuilder::set_sge_list(std::size_t num_sge, const ugdr_sge *sg_list) noexcept {
+    if (ring_ == nullptr || error_ != 0) {
+        return;
+    }
+    if (current_ == nullptr || num_sge > max_sge_ || (num_sge != 0 && sg_list == nullptr)) {
+        error_ = EINVAL;
+        return;
+    }
+    copy_sges(current_ + 1, sg_list, num_sge);
+    current_->sge_count = static_cast<std::uint32_t>(num_sge);
+}
+
+int SendWqeBuilder::complete() noexcept {
+    if (ring_ == nullptr) {
+        return EINVAL;
+    }
+    const int status = error_;
+    const std::uint32_t accepted = status == 0 ? used_ : 0;
+    const int publish_status = batch_.count != 0 ? ring_->producer_publish(accepted) : 0;
+    ring_ = nullptr;
+    current_ = nullptr;
+    return status != 0 ? status : publish_status;
+}
+
+void SendWqeBuilder::abort() noexcept {
+    if (ring_ == nullptr) {
+        return;
+    }
+    if (batch_.count != 0) {
+        (void)ring_->producer_publish(0);
+    }
+    ring_ = nullptr;
+    current_ = nullptr;
+}
+
+bool SendWqeBuilder::active() const noexcept {
+    return ring_ != nullptr;
+}
+
+queue::SendWqeHeader *SendWqeBuilder::next_header(std::uint64_t wr_id,
+                                                  unsigned int send_flags) noexcept {
+    if (ring_ == nullptr || error_ != 0) {
+        return nullptr;
+    }
+    if ((send_flags & ~static_cast<unsigned int>(UGDR_SEND_SIGNALED)) != 0) {
+        error_ = EINVAL;
+        return nullptr;
+    }
+    if (span_left_ == 0) {
+        if (used_ == batch_.count) {
+            error_ = ENOMEM;
+            return nullptr;
+        }
+        cursor_ = static_cast<std::byte *>(batch_.second.data);
+        span_left_ = batch_.second.count;
+    }
+    current_ = reinterpret_cast<queue::SendWqeHeader *>(cursor_);
+    cursor_ += stride_;
+    --span_left_;
+    ++used_;
+    *current_ = {};
+    current_->wr_id = wr_id;
+    current_->send_flags = send_flags;
+    return current_;
+}
+
 }  // namespace ugdr::api
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "queue/descriptors.hpp"
 #include "queue/shared_ring.hpp"
 #include "ugdr/api.hpp"
 
+#include <cstddef>
 #include <cstdint>
 
 namespace ugdr::api {
@@ -11,5 +13,54 @@ int post_send_chain(queue::SharedRing &ring, std::uint32_t max_sge, ugdr_send_wr
                     ugdr_send_wr **bad_wr) noexcept;
 int post_receive_chain(queue::SharedRing &ring, std::uint32_t max_sge, ugdr_recv_wr *wr,
                        ugdr_recv_wr **bad_wr) noexcept;
+// Array forms ignore next. *posted counts the accepted prefix on every return.
+int post_send_array(queue::SharedRing &ring, std::uint32_t max_sge, const ugdr_send_wr *wrs,
+                    int count, int *posted) noexcept;
+int post_receive_array(queue::SharedRing &ring, std::uint32_t max_sge, const ugdr_recv_wr *wrs,
+                       int count, int *posted) noexcept;
+
+// A Send WQE validated and encoded once. Posting copies it and patches the per-WR fields.
+struct SendTemplate {
+    queue::SendWqeHeader header;
+    queue::SharedSge sge;
+};
+
+static_assert(offsetof(SendTemplate, sge) == sizeof(queue::SendWqeHeader));
+
+int make_send_template(const ugdr_send_wr &shape, std::uint32_t max_sge,
+                       SendTemplate *send_template) noexcept;
+int post_send_template(queue::SharedRing &ring, const SendTemplate &send_template,
+                       std::uint64_t wr_id, std::uint64_t local_addr,
+                       std::uint64_t remote_addr) noexcept;
+
+// Writes Send WQEs straight into slots reserved at start and publishes them together at
+// complete. Errors are latched and reported by complete, which then publishes nothing.
+class SendWqeBuilder {
+  public:
+    int start(queue::SharedRing &ring, std::uint32_t max_sge) noexcept;
+    void rdma_write(std::uint64_t wr_id, unsigned int send_flags, std::uint32_t rkey,
+                    std::uint64_t remote_addr) noexcept;
+    void rdma_write_imm(std::uint64_t wr_id, unsigned int send_flags, std::uint32_t rkey,
+                        std::uint64_t remote_addr, std::uint32_t imm_data) noexcept;
+    void set_sge(std::uint32_t lkey, std::uint64_t addr, std::uint32_t length) noexcept;
+    void set_sge_list(std::size_t num_sge, const ugdr_sge *sg_list) noexcept;
+    int complete() noexcept;
+    void abort() noexcept;
+
+    [[nodiscard]] bool active() const noexcept;
+
+  private:
+    queue::SendWqeHeader *next_header(std::uint64_t wr_id, unsigned int send_flags) noexcept;
+
+    queue::SharedRing *ring_ = nullptr;
+    queue::MutableSlotBatch batch_{};
+    std::byte *cursor_ = nullptr;
+    std::uint32_t span_left_ = 0;
+    std::uint32_t stride_ = 0;
+    std::uint32_t max_sge_ = 0;
+    std::uint32_t used_ = 0;
+    queue::SendWqeHeader *current_ = nullptr;
+    int error_ = 0;
+};
 
 }  // namespace ugdr::api
@@ -0,0 +1,330 @@
+#pragma once
+
+#include "control/object_identity.hpp"
+#include "control/object_registry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ugdr::control {
+
+// GenerationRegistry for worker threads that resolve while the control thread mutates. Lookups
+// are wait-free: slots live in fixed chunks that never move, and each live record is published
+// through one atomic pointer. Mutations are serialized by a mutex. An erased record is freed only
+// after every registered reader has passed a quiescent point (QSBR).
+template <typename Record, ObjectType Type> class ConcurrentGenerationRegistry {
+  public:
+    using ReaderId = std::uint32_t;
+
+    static constexpr std::size_t kMaxReaders = 64;
+
+    explicit ConcurrentGenerationRegistry(std::uint32_t initial_generation = 1) noexcept
+        : initial_generation_(initial_generation == 0 ? 1 : initial_generation) {
+    }
+
+    ConcurrentGenerationRegistry(const ConcurrentGenerationRegistry &) = delete;
+    ConcurrentGenerationRegistry &operator=(const ConcurrentGenerationRegistry &) = delete;
+
+    ~ConcurrentGenerationRegistry() {
+        for (const RetiredNode &entry : retired_) {
+            delete entry.node;
+        }
+        for (auto &chunk : chunks_) {
+            Chunk *const value = chunk.load(std::memory_order_relaxed);
+            if (value == nullptr) {
+                continue;
+            }
+            for (Slot &slot : value->slots) {
+                delete slot.node.load(std::memory_order_relaxed);
+            }
+            delete value;
+        }
+    }
+
+    std::optional<std::uint64_t> insert(OwnerSessionId owner_session, Record record) {
+        std::lock_guard lock(writer_mutex_);
+        reclaim_locked();
+        const auto head = session_heads_.try_emplace(owner_session, kNoSlot).first;
+        std::uint32_t slot_index = 0;
+        if (!free_slots_.empty()) {
+            slot_index = free_slots_.back();
+        } else {
+            if (slot_count_ > kMaxObjectSlot) {
+                if (head->second == kNoSlot) {
+                    session_heads_.erase(head);
+                }
+                return std::nullopt;
+            }
+            slot_index = slot_count_;
+            auto &chunk = chunks_[slot_index / kChunkSlots];
+            if (chunk.load(std::memory_order_relaxed) == nullptr) {
+                chunk.store(std::make_unique<Chunk>(initial_generation_).release(),
+                            std::memory_order_release);
+            }
+        }
+
+        Slot &slot = slot_at(slot_index);
+        const auto identity = encode_object_identity({Type, slot.generation, slot_index});
+        if (!identity.has_value()) {
+            if (head->second == kNoSlot) {
+                session_heads_.erase(head);
+            }
+            return std::nullopt;
+        }
+        auto node = std::make_unique<Node>(Node{std::move(record), owner_session, slot.generation});
+        if (!free_slots_.empty()) {
+            free_slots_.pop_back();
+        } else {
+            ++slot_count_;
+        }
+        slot.next = head->second;
+        if (head->second != kNoSlot) {
+            slot_at(head->second).previous = slot_index;
+        }
+        head->second = slot_index;
+        slot.node.store(node.release(), std::memory_order_release);
+        live_count_.fetch_add(1, std::memory_order_relaxed);
+        return identity;
+    }
+
+    Record *resolve(OwnerSessionId owner_session, std::uint64_t identity) noexcept {
+        Node *const node = find(identity);
+        return node != nullptr && node->owner_session == owner_session ? &node->record : nullptr;
+    }
+
+    const Record *resolve(OwnerSessionId owner_session, std::uint64_t identity) const noexcept {
+        return const_cast<ConcurrentGenerationRegistry *>(this)->resolve(owner_session, identity);
+    }
+
+    Record *resolve_any(std::uint64_t identity) noexcept {
+        Node *const node = find(identity);
+        return node != nullptr ? &node->record : nullptr;
+    }
+
+    const Record *resolve_any(std::uint64_t identity) const noexcept {
+        return const_cast<ConcurrentGenerationRegistry *>(this)->resolve_any(identity);
+    }
+
+    int erase(OwnerSessionId owner_session, std::uint64_t identity) noexcept {
+        std::lock_guard lock(writer_mutex_);
+        const auto parts = decode_object_identity(identity);
+        if (!parts.has_value() || resolve(owner_session, identity) == nullptr) {
+            return EINVAL;
+        }
+        release(parts->slot);
+        reclaim_locked();
+        return 0;
+    }
+
+    std::size_t erase_session(OwnerSessionId owner_session) noexcept {
+        std::lock_guard lock(writer_mutex_);
+        const auto head = session_heads_.find(owner_session);
+        std::uint32_t index = head != session_heads_.end() ? head->second : kNoSlot;
+        std::size_t erased = 0;
+        while (index != kNoSlot) {
+            const std::uint32_t next = slot_at(index).next;
+            release(index);
+            ++erased;
+            index = next;
+        }
+        reclaim_locked();
+        return erased;
+    }
+
+    // The visitor runs under the writer lock and must not mutate this registry.
+    template <typename Visitor>
+    void for_each_session(OwnerSessionId owner_session, Visitor &&visitor) noexcept {
+        std::lock_guard lock(writer_mutex_);
+        const auto head = session_heads_.find(owner_session);
+        std::uint32_t index = head != session_heads_.end() ? head->second : kNoSlot;
+        while (index != kNoSlot) {
+            const Slot &slot = slot_at(index);
+            Node *const node = slot.node.load(std::memory_order_relaxed);
+            const auto identity = encode_object_identity({Type, node->generation, index});
+            if (identity.has_value()) {
+                visitor(*identity, node->record);
+            }
+            index = slot.next;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return live_count_.load(std::memory_order_relaxed);
+    }
+
+    // A reader must call quiescent() regularly while it holds no resolved pointer, such as once
+    // per worker loop iteration. Records erased since its last quiescent point stay allocated.
+    std::optional<ReaderId> register_reader() noexcept {
+        for (ReaderId reader = 0; reader < kMaxReaders; ++reader) {
+            std::uint64_t expected = kOffline;
+            if (readers_[reader].epoch.compare_exchange_strong(
+                    expected, global_epoch_.load(std::memory_order_seq_cst),
+                    std::memory_order_seq_cst)) {
+                return reader;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void unregister_reader(ReaderId reader) noexcept {
+        if (reader < kMaxReaders) {
+            readers_[reader].epoch.store(kOffline, std::memory_order_seq_cst);
+        }
+    }
+
+    void quiescent(ReaderId reader) noexcept {
+        if (reader < kMaxReaders) {
+            readers_[reader].epoch.store(global_epoch_.load(std::memory_order_seq_cst),
+                                         std::memory_order_seq_cst);
+        }
+    }
+
+    void reclaim() noexcept {
+        std::lock_guard lock(writer_mutex_);
+        reclaim_locked();
+    }
+
+    [[nodiscard]] std::size_t retired_count() const noexcept {
+        std::lock_guard lock(writer_mutex_);
+        return retired_.size();
+    }
+
+  private:
+    static constexpr std::size_t kChunkSlots = 4096;
+    static constexpr std::size_t kChunkCount =
+        (static_cast<std::size_t>(kMaxObjectSlot) + kChunkSlots) / kChunkSlots;
+    static constexpr std::uint64_t kOffline = std::numeric_limits<std::uint64_t>::max();
+    static constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+    struct Node {
+        Record record;
+        OwnerSessionId owner_session = 0;
+        std::uint32_t generation = 1;
+    };
+
+    struct Slot {
+        std::atomic<Node *> node{nullptr};
+        std::uint32_t generation = 1;
+        bool retired = false;
+        std::uint32_t previous = kNoSlot;
+        std::uint32_t next = kNoSlot;
+    };
+
+    struct Chunk {
+        explicit Chunk(std::uint32_t initial_generation) {
+            for (Slot &slot : slots) {
+                slot.generation = initial_generation;
+            }
+        }
+
+        std::array<Slot, kChunkSlots> slots;
+    };
+
+    struct alignas(64) ReaderState {
+        std::atomic<std::uint64_t> epoch{kOffline};
+    };
+
+    struct RetiredNode {
+        std::uint64_t epoch = 0;
+        Node *node = nullptr;
+    };
+
+    Slot &slot_at(std::uint32_t index) const noexcept {
+        return chunks_[index / kChunkSlots].load(std::memory_order_relaxed)->slots[index %
+                                                                                   kChunkSlots];
+    }
+
+    Node *find(std::uint64_t identity) const noexcept {
+        const auto parts = decode_object_identity(identity);
+        if (!parts.has_value() || parts->type != Type) {
+            return nullptr;
+        }
+        Chunk *const chunk =
+            chunks_[parts->slot / kChunkSlots].load(std::memory_order_acquire);
+        if (chunk == nullptr) {
+            return nullptr;
+        }
+        Node *const node =
+            chunk->slots[parts->slot % kChunkSlots].node.load(std::memory_order_acquire);
+        return node != nullptr && node->generation == parts->generation ? node : nullptr;
+    }
+
+    void unlink(std::uint32_t index, OwnerSessionId owner_session) noexcept {
+        Slot &slot = slot_at(index);
+        if (slot.previous != kNoSlot) {
+            slot_at(slot.previous).next = slot.next;
+        } else {
+            const auto head = session_heads_.find(owner_session);
+            if (slot.next != kNoSlot) {
+                head->second = slot.next;
+            } else {
+                session_heads_.erase(head);
+            }
+        }
+        if (slot.next != kNoSlot) {
+            slot_at(slot.next).previous = slot.previous;
+        }
+        slot.previous = kNoSlot;
+        slot.next = kNoSlot;
+    }
+
+    void release(std::uint32_t index) noexcept {
+        Slot &slot = slot_at(index);
+        unlink(index, slot.node.load(std::memory_order_relaxed)->owner_session);
+        Node *const node = slot.node.exchange(nullptr, std::memory_order_acq_rel);
+        live_count_.fetch_sub(1, std::memory_order_relaxed);
+        try {
+            retired_.push_back({global_epoch_.fetch_add(1, std::memory_order_seq_cst), node});
+        } catch (...) {
+            // Without room to defer the free, leaking the record is the only safe choice.
+        }
+        if (slot.generation == std::numeric_limits<std::uint32_t>::max()) {
+            slot.retired = true;
+            return;
+        }
+        ++slot.generation;
+        try {
+            free_slots_.push_back(index);
+        } catch (...) {
+        }
+    }
+
+    void reclaim_locked() noexcept {
+        std::uint64_t safe = global_epoch_.load(std::memory_order_seq_cst);
+        for (const ReaderState &reader : readers_) {
+            safe = std::min(safe, reader.epoch.load(std::memory_order_seq_cst));
+        }
+        const auto kept = std::partition(retired_.begin(), retired_.end(),
+                                         [safe](const RetiredNode &entry) {
+                                             return entry.epoch >= safe;
+                                         });
+        for (auto entry = kept; entry != retired_.end(); ++entry) {
+            delete entry->node;
+        }
+        retired_.erase(kept, retired_.end());
+    }
+
+    std::uint32_t initial_generation_ = 1;
+    mutable std::array<std::atomic<Chunk *>, kChunkCount> chunks_{};
+    std::array<ReaderState, kMaxReaders> readers_{};
+    std::atomic<std::uint64_t> global_epoch_{0};
+    std::atomic<std::size_t> live_count_{0};
+    mutable std::mutex writer_mutex_;
+    std::uint32_t slot_count_ = 0;
+    std::vector<std::uint32_t> free_slots_;
+    std::unordered_map<OwnerSessionId, std::uint32_t> session_heads_;
+    std::vector<RetiredNode> retired_;
+};
+
+}  // namespace ugdr::control
@@ -0,0 +1,75 @@
+#include "control/cuda_ipc_mapping_cache.hpp"
+
+#include <cerrno>
+
+namespace ugdr::control {
+
+CudaIpcMappingCache::CudaIpcMappingCache(gpu::CudaIpcMemoryBackend &backend) noexcept
+    : backend_(backend) {
+}
+
+int CudaIpcMappingCache::open(const gpu::ExportedCudaMemory &memory,
+                              gpu::CudaIpcMapping *mapping) {
+    if (mapping == nullptr) {
+        return EINVAL;
+    }
+    HandleKey key{memory.gpu_uuid, memory.ipc_handle};
+    const auto cached = by_handle_.find(key);
+    if (cached != by_handle_.end()) {
+        if (cached->second.allocation_size != memory.allocation_size) {
+            return EINVAL;
+        }
+        ++cached->second.references;
+        *mapping = cached->second.mapping;
+        return 0;
+    }
+
+    gpu::CudaIpcMapping opened;
+    const int status = backend_.open(memory, &opened);
+    if (status != 0) {
+        return status;
+    }
+    auto inserted = by_handle_.end();
+    int index_status = ENOMEM;
+    try {
+        const Entry entry{opened, memory.allocation_size, 1};
+        inserted = by_handle_.emplace(std::move(key), entry).first;
+        const AddressKey address{opened.gpu_uuid, opened.daemon_base_address};
+        index_status = by_address_.emplace(address, inserted).second ? 0 : EPROTO;
+    } catch (...) {
+    }
+    if (index_status != 0) {
+        if (inserted != by_handle_.end()) {
+            by_handle_.erase(inserted);
+        }
+        (void)backend_.close(opened);
+        return index_status;
+    }
+    *mapping = opened;
+    return 0;
+}
+
+int CudaIpcMappingCache::close(const gpu::CudaIpcMapping &mapping) noexcept {
+    const auto found = by_address_.find(AddressKey{mapping.gpu_uuid, mapping.daemon_base_address});
+    if (found == by_address_.end()) {
+        return EINVAL;
+    }
+    Entry &entry = found->second->second;
+    if (entry.references > 1) {
+        --entry.references;
+        return 0;
+    }
+    const int status = backend_.close(entry.mapping);
+    if (status != 0) {
+        return status;
+    }
+    by_handle_.erase(found->second);
+    by_address_.erase(found);
+    return 0;
+}
+
+std::size_t CudaIpcMappingCache::mapping_count() const noexcept {
+    return by_handle_.size();
+}
+
+}  // namespace ugdr::control
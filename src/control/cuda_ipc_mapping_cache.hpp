@@ -0,0 +1,40 @@
+#pragma once
+
+#include "gpu/cuda_ipc_memory.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ugdr::control {
+
+// Shares one backend mapping among all MRs registered inside the same exported allocation.
+// cudaIpcOpenMemHandle is expensive and maps a whole allocation, so the mapping is opened on the
+// first registration and closed when the last MR using it goes away.
+class CudaIpcMappingCache final : public gpu::CudaIpcMemoryBackend {
+  public:
+    explicit CudaIpcMappingCache(gpu::CudaIpcMemoryBackend &backend) noexcept;
+
+    int open(const gpu::ExportedCudaMemory &memory, gpu::CudaIpcMapping *mapping) override;
+    int close(const gpu::CudaIpcMapping &mapping) noexcept override;
+
+    [[nodiscard]] std::size_t mapping_count() const noexcept;
+
+  private:
+    using HandleKey = std::pair<gpu::GpuUuid, std::vector<std::byte>>;
+    using AddressKey = std::pair<gpu::GpuUuid, std::uint64_t>;
+
+    struct Entry {
+        gpu::CudaIpcMapping mapping;
+        std::uint64_t allocation_size = 0;
+        std::size_t references = 0;
+    };
+
+    gpu::CudaIpcMemoryBackend &backend_;
+    std::map<HandleKey, Entry> by_handle_;
+    std::map<AddressKey, std::map<HandleKey, Entry>::iterator> by_address_;
+};
+
+}  // namespace ugdr::control
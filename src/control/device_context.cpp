@@ -1,5 +1,7 @@
 #include "control/device_context.hpp"
 
+#include "queue/numa.hpp"
+
 #include <arpa/inet.h>
 
 #include <cerrno>
@@ -143,10 +145,11 @@ int decode_device_list(const std::vector<std::byte> &bytes,
     return 0;
 }
 
-DeviceCatalog::DeviceCatalog() : devices_({{1, "ugdr0"}}) {
+DeviceCatalog::DeviceCatalog() : devices_({{1, "ugdr0"}}), numa_nodes_(1, queue::kNoNumaNode) {
 }
 
-DeviceCatalog::DeviceCatalog(std::vector<DeviceDescriptor> devices) : devices_(std::move(devices)) {
+DeviceCatalog::DeviceCatalog(std::vector<DeviceDescriptor> devices)
+    : devices_(std::move(devices)), numa_nodes_(devices_.size(), queue::kNoNumaNode) {
 }
 
 const std::vector<DeviceDescriptor> &DeviceCatalog::devices() const noexcept {
@@ -162,6 +165,25 @@ bool DeviceCatalog::contains(std::uint64_t identity) const noexcept {
     return false;
 }
 
+int DeviceCatalog::set_pci_address(std::uint64_t identity,
+                                   const std::string &pci_address) noexcept {
+    for (std::size_t index = 0; index < devices_.size(); ++index) {
+        if (devices_[index].identity == identity) {
+            return queue::pci_device_numa_node(pci_address, &numa_nodes_[index]);
+        }
+    }
+    return ENOENT;
+}
+
+int DeviceCatalog::numa_node(std::uint64_t identity) const noexcept {
+    for (std::size_t index = 0; index < devices_.size(); ++index) {
+        if (devices_[index].identity == identity) {
+            return numa_nodes_[index];
+        }
+    }
+    return queue::kNoNumaNode;
+}
+
 DeviceContextService::DeviceContextService() = default;
 
 DeviceContextService::DeviceContextService(DeviceCatalog catalog) : catalog_(std::move(catalog)) {
@@ -191,7 +213,7 @@ ControlServiceResult DeviceContextService::handle(ipc::SessionId session_id,
             break;
         }
         const auto identity =
-            contexts_.insert(session_id, ContextRecord{request.value.object_identity, 0});
+            contexts_.insert(session_id, ContextRecord{request.value.object_identity, 0, {}});
         if (!identity.has_value()) {
             result.response.status = ENOSPC;
             break;
@@ -225,6 +247,10 @@ std::size_t DeviceContextService::context_count() const noexcept {
     return contexts_.size();
 }
 
+const DeviceCatalog &DeviceContextService::catalog() const noexcept {
+    return catalog_;
+}
+
 ContextRecord *DeviceContextService::resolve_context(ipc::SessionId session_id,
                                                      std::uint64_t identity) noexcept {
     return contexts_.resolve(session_id, identity);
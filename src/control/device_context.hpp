@@ -9,6 +9,10 @@
 #include <string>
 #include <vector>
 
+namespace ugdr::queue {
+class SharedRingArena;
+}  // namespace ugdr::queue
+
 namespace ugdr::control {
 
 constexpr const char *kDefaultDaemonSocket = "/run/ugdr/ugdr.sock";
@@ -29,6 +33,10 @@ enum class ControlMethod : std::uint32_t {
     modify_qp = 13,
     query_qp_conn_info = 14,
     connect_qp = 15,
+    modify_cq = 16,
+    create_srq = 17,
+    destroy_srq = 18,
+    map_ring_arena = 19,
 };
 
 struct DeviceDescriptor {
@@ -52,13 +60,22 @@ class DeviceCatalog {
     [[nodiscard]] const std::vector<DeviceDescriptor> &devices() const noexcept;
     [[nodiscard]] bool contains(std::uint64_t identity) const noexcept;
 
+    // Records the NUMA node sysfs reports for the PCI device, GPU or NIC, backing identity.
+    int set_pci_address(std::uint64_t identity, const std::string &pci_address) noexcept;
+    // The node of identity's PCI device, or queue::kNoNumaNode when unknown. Daemon-side only;
+    // it is not part of the device list sent to clients.
+    [[nodiscard]] int numa_node(std::uint64_t identity) const noexcept;
+
   private:
     std::vector<DeviceDescriptor> devices_;
+    std::vector<int> numa_nodes_;
 };
 
 struct ContextRecord {
     std::uint64_t device_identity = 0;
     std::size_t child_count = 0;
+    // Set once the client maps a ring arena; later queue rings are carved from it.
+    std::shared_ptr<queue::SharedRingArena> ring_arena;
 };
 
 class DeviceContextService : public ControlService {
@@ -72,6 +89,7 @@ class DeviceContextService : public ControlService {
     [[nodiscard]] std::size_t context_count() const noexcept;
 
   protected:
+    [[nodiscard]] const DeviceCatalog &catalog() const noexcept;
     ContextRecord *resolve_context(ipc::SessionId session_id, std::uint64_t identity) noexcept;
     const ContextRecord *resolve_context(ipc::SessionId session_id,
                                          std::uint64_t identity) const noexcept;
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "control/object_registry.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace ugdr::control {
+
+constexpr std::uint32_t kAccessLocalWrite = UINT32_C(1) << 0U;
+constexpr std::uint32_t kAccessRemoteWrite = UINT32_C(1) << 1U;
+
+// An lkey/rkey is generation << 20 | index << 1 | remote. Translation is a bounds check and one
+// read of a cache-line entry, like a NIC memory translation table.
+constexpr std::uint32_t kMrKeyIndexBits = 19;
+constexpr std::uint32_t kMaxMrKeyIndex = (UINT32_C(1) << kMrKeyIndexBits) - 1;
+constexpr std::uint32_t kMrKeyGenerationShift = kMrKeyIndexBits + 1;
+constexpr std::uint16_t kMaxMrKeyGeneration = (1U << (32U - kMrKeyGenerationShift)) - 1U;
+
+struct alignas(64) MrKeyEntry {
+    OwnerSessionId owner_session = 0;
+    std::uint64_t pd_identity = 0;
+    std::uint64_t client_address = 0;
+    std::uint64_t length = 0;
+    std::uint64_t daemon_address = 0;
+    std::uint32_t access = 0;
+    std::uint16_t generation = 1;
+    bool live = false;
+};
+
+inline int translate_mr_key(const MrKeyEntry &entry, bool remote, std::uint64_t address,
+                            std::uint64_t length, std::uint64_t *daemon_address) noexcept {
+    constexpr std::uint64_t kMaxAddress = std::numeric_limits<std::uint64_t>::max();
+    if (remote && (entry.access & kAccessRemoteWrite) == 0) {
+        return EACCES;
+    }
+    if (address < entry.client_address || address > kMaxAddress - length ||
+        entry.client_address > kMaxAddress - entry.length ||
+        address + length > entry.client_address + entry.length) {
+        return EINVAL;
+    }
+    const std::uint64_t offset = address - entry.client_address;
+    if (entry.daemon_address > kMaxAddress - offset) {
+        return EINVAL;
+    }
+    *daemon_address = entry.daemon_address + offset;
+    return 0;
+}
+
+struct MrKeys {
+    std::uint32_t lkey = 0;
+    std::uint32_t rkey = 0;
+};
+
+class MrKeyTable {
+  public:
+    std::optional<MrKeys> insert(const MrKeyEntry &entry) {
+        std::uint32_t index = 0;
+        if (!free_entries_.empty()) {
+            index = free_entries_.front();
+            free_entries_.pop_front();
+        } else {
+            if (entries_.size() > kMaxMrKeyIndex) {
+                return std::nullopt;
+            }
+            index = static_cast<std::uint32_t>(entries_.size());
+            entries_.emplace_back();
+        }
+        MrKeyEntry &slot = entries_[index];
+        const std::uint16_t generation = slot.generation;
+        slot = entry;
+        slot.generation = generation;
+        slot.live = true;
+        ++live_count_;
+        const std::uint32_t key =
+            (static_cast<std::uint32_t>(generation) << kMrKeyGenerationShift) | (index << 1U);
+        return MrKeys{key, key | 1U};
+    }
+
+    [[nodiscard]] const MrKeyEntry *find(std::uint32_t key, bool remote) const noexcept {
+        const std::uint32_t index = (key >> 1U) & kMaxMrKeyIndex;
+        if (index >= entries_.size() || (key & 1U) != static_cast<std::uint32_t>(remote)) {
+            return nullptr;
+        }
+        const MrKeyEntry &entry = entries_[index];
+        if (!entry.live || entry.generation != key >> kMrKeyGenerationShift) {
+            return nullptr;
+        }
+        return &entry;
+    }
+
+    // Generations start at 1 so that no key is ever 0. A slot whose generation would wrap is
+    // retired instead of freed, so a stale key held by a peer can never name a later MR. Freed
+    // slots are reused oldest first, which spreads churn over every free slot. Each slot yields
+    // 4095 keys, so the daemon can hand out about 2^31 keys over its lifetime before insert
+    // returns nullopt, and sustained churn grows the table by one entry per 4095 registrations.
+    void erase(std::uint32_t lkey) noexcept {
+        const std::uint32_t index = (lkey >> 1U) & kMaxMrKeyIndex;
+        if (find(lkey, false) == nullptr) {
+            return;
+        }
+        MrKeyEntry &entry = entries_[index];
+        const std::uint16_t generation = entry.generation;
+        entry = MrKeyEntry{};
+        --live_count_;
+        if (generation == kMaxMrKeyGeneration) {
+            entry.generation = 0;
+            return;
+        }
+        entry.generation = static_cast<std::uint16_t>(generation + 1U);
+        try {
+            free_entries_.push_back(index);
+        } catch (...) {
+            // Without room on the free list the slot is simply never reused.
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return live_count_;
+    }
+
+  private:
+    std::vector<MrKeyEntry> entries_;
+    std::deque<std::uint32_t> free_entries_;
+    std::size_t live_count_ = 0;
+};
+
+}  // namespace ugdr::control
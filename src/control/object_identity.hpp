@@ -12,6 +12,7 @@ enum class ObjectType : std::uint8_t {
     mr = 3,
     cq = 4,
     qp = 5,
+    srq = 6,
 };
 
 constexpr std::uint32_t kMaxObjectSlot = UINT32_C(0x00ffffff);
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <limits>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -21,12 +22,16 @@ template <typename Record, ObjectType Type> class GenerationRegistry {
     }
 
     std::optional<std::uint64_t> insert(OwnerSessionId owner_session, Record record) {
+        const auto head = session_heads_.try_emplace(owner_session, kNoSlot).first;
         std::uint32_t slot_index = 0;
         if (!free_slots_.empty()) {
             slot_index = free_slots_.back();
             free_slots_.pop_back();
         } else {
             if (slots_.size() > kMaxObjectSlot) {
+                if (head->second == kNoSlot) {
+                    session_heads_.erase(head);
+                }
                 return std::nullopt;
             }
             slot_index = static_cast<std::uint32_t>(slots_.size());
@@ -41,8 +46,16 @@ template <typename Record, ObjectType Type> class GenerationRegistry {
             slot.value.reset();
             slot.owner_session = 0;
             slot.retired = true;
+            if (head->second == kNoSlot) {
+                session_heads_.erase(head);
+            }
             return std::nullopt;
         }
+        slot.next = head->second;
+        if (head->second != kNoSlot) {
+            slots_[head->second].previous = slot_index;
+        }
+        head->second = slot_index;
         ++live_count_;
         return identity;
     }
@@ -89,28 +102,33 @@ template <typename Record, ObjectType Type> class GenerationRegistry {
         return 0;
     }
 
+    // Each session's live slots form an intrusive list, so teardown costs what the session owns
+    // rather than the size of the registry.
     std::size_t erase_session(OwnerSessionId owner_session) noexcept {
+        const auto head = session_heads_.find(owner_session);
+        std::uint32_t index = head != session_heads_.end() ? head->second : kNoSlot;
         std::size_t erased = 0;
-        for (std::uint32_t index = 0; index < slots_.size(); ++index) {
-            Slot &slot = slots_[index];
-            if (slot.value.has_value() && slot.owner_session == owner_session) {
-                release(index);
-                ++erased;
-            }
+        while (index != kNoSlot) {
+            const std::uint32_t next = slots_[index].next;
+            release(index);
+            ++erased;
+            index = next;
         }
         return erased;
     }
 
     template <typename Visitor>
     void for_each_session(OwnerSessionId owner_session, Visitor &&visitor) noexcept {
-        for (std::uint32_t index = 0; index < slots_.size(); ++index) {
+        const auto head = session_heads_.find(owner_session);
+        std::uint32_t index = head != session_heads_.end() ? head->second : kNoSlot;
+        while (index != kNoSlot) {
             Slot &slot = slots_[index];
-            if (!slot.retired && slot.value.has_value() && slot.owner_session == owner_session) {
-                const auto identity = encode_object_identity({Type, slot.generation, index});
-                if (identity.has_value()) {
-                    visitor(*identity, *slot.value);
-                }
+            const std::uint32_t next = slot.next;
+            const auto identity = encode_object_identity({Type, slot.generation, index});
+            if (identity.has_value()) {
+                visitor(*identity, *slot.value);
             }
+            index = next;
         }
     }
 
@@ -119,6 +137,8 @@ template <typename Record, ObjectType Type> class GenerationRegistry {
     }
 
   private:
+    static constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
     struct Slot {
         explicit Slot(std::uint32_t initial_generation) : generation(initial_generation) {
         }
@@ -127,9 +147,31 @@ template <typename Record, ObjectType Type> class GenerationRegistry {
         OwnerSessionId owner_session = 0;
         std::optional<Record> value;
         bool retired = false;
+        std::uint32_t previous = kNoSlot;
+        std::uint32_t next = kNoSlot;
     };
 
+    void unlink(std::uint32_t index) noexcept {
+        Slot &slot = slots_[index];
+        if (slot.previous != kNoSlot) {
+            slots_[slot.previous].next = slot.next;
+        } else {
+            const auto head = session_heads_.find(slot.owner_session);
+            if (slot.next != kNoSlot) {
+                head->second = slot.next;
+            } else {
+                session_heads_.erase(head);
+            }
+        }
+        if (slot.next != kNoSlot) {
+            slots_[slot.next].previous = slot.previous;
+        }
+        slot.previous = kNoSlot;
+        slot.next = kNoSlot;
+    }
+
     void release(std::uint32_t index) noexcept {
+        unlink(index);
         Slot &slot = slots_[index];
         slot.value.reset();
         slot.owner_session = 0;
@@ -145,6 +187,7 @@ template <typename Record, ObjectType Type> class GenerationRegistry {
     std::uint32_t initial_generation_ = 1;
     std::vector<Slot> slots_;
     std::vector<std::uint32_t> free_slots_;
+    std::unordered_map<OwnerSessionId, std::uint32_t> session_heads_;
     std::size_t live_count_ = 0;
 };
 
@@ -1,6 +1,7 @@
 #include "control/pd_mr_cq.hpp"
 #include "control/queue_descriptor.hpp"
 #include "queue/descriptors.hpp"
+#include "queue/ring_arena.hpp"
 
 #include <arpa/inet.h>
 
@@ -66,6 +67,11 @@ bool valid_access(std::uint32_t access) noexcept {
            ((access & kAccessRemoteWrite) == 0 || (access & kAccessLocalWrite) != 0);
 }
 
+std::uint32_t cq_slot_stride(std::uint32_t flags) noexcept {
+    return (flags & kCqCreateCompact) != 0 ? queue::compact_completion_slot_stride()
+                                           : queue::completion_slot_stride();
+}
+
 bool empty_shape(const DecodedControlRequest &request) noexcept {
     return request.value.length == 0 && request.value.access == 0 && request.value.opaque.empty() &&
            request.value.fd_indices.empty() && request.file_descriptors.empty();
@@ -78,17 +84,6 @@ ControlServiceResult response_for(const DecodedControlRequest &request, int stat
     return result;
 }
 
-std::optional<std::pair<std::uint32_t, std::uint32_t>> allocate_keys(std::uint64_t *next_key) {
-    if (next_key == nullptr || *next_key == 0 ||
-        *next_key > static_cast<std::uint64_t>(std::numeric_limits<std::uint32_t>::max()) - 1) {
-        return std::nullopt;
-    }
-    const auto lkey = static_cast<std::uint32_t>(*next_key);
-    const auto rkey = static_cast<std::uint32_t>(*next_key + 1);
-    *next_key += 2;
-    return std::pair{lkey, rkey};
-}
-
 int validate_identity(std::uint64_t identity, ObjectType type) noexcept {
     const auto parts = decode_object_identity(identity);
     return parts.has_value() && parts->type == type ? 0 : EPROTO;
@@ -115,7 +110,7 @@ int call_identity(ControlClient &client, UgdrControlRequest request, ObjectType
     return 0;
 }
 
-int call_destroy(ControlClient &client, UgdrControlRequest request) {
+int call_empty(ControlClient &client, UgdrControlRequest request) {
     UgdrControlResponse response;
     const int call_status = client.call(std::move(request), &response);
     if (call_status != 0) {
@@ -163,11 +158,13 @@ UgdrControlRequest make_deregister_mr_request(std::uint64_t mr_identity) {
     return request;
 }
 
-UgdrControlRequest make_create_cq_request(std::uint64_t context_identity, std::uint32_t cqe) {
+UgdrControlRequest make_create_cq_request(std::uint64_t context_identity, std::uint32_t cqe,
+                                          std::uint32_t flags) {
     UgdrControlRequest request;
     request.method = static_cast<std::uint32_t>(ControlMethod::create_cq);
     request.object_identity = context_identity;
     request.length = cqe;
+    request.access = flags;
     return request;
 }
 
@@ -178,6 +175,24 @@ UgdrControlRequest make_destroy_cq_request(std::uint64_t cq_identity) {
     return request;
 }
 
+UgdrControlRequest make_modify_cq_request(std::uint64_t cq_identity,
+                                          const queue::CompletionModeration &moderation) {
+    UgdrControlRequest request;
+    request.method = static_cast<std::uint32_t>(ControlMethod::modify_cq);
+    request.object_identity = cq_identity;
+    request.length = (static_cast<std::uint64_t>(moderation.count) << 16U) | moderation.period_us;
+    return request;
+}
+
+UgdrControlRequest make_map_ring_arena_request(std::uint64_t context_identity,
+                                               std::uint64_t bytes) {
+    UgdrControlRequest request;
+    request.method = static_cast<std::uint32_t>(ControlMethod::map_ring_arena);
+    request.object_identity = context_identity;
+    request.length = bytes;
+    return request;
+}
+
 int encode_mr_registration(const gpu::ExportedCudaMemory &memory, std::vector<std::byte> *bytes) {
     if (bytes == nullptr || !valid_memory(memory)) {
         return EINVAL;
@@ -291,12 +306,91 @@ int decode_mr_registration_result(const std::vector<std::byte> &bytes,
     return 0;
 }
 
+int attach_queue_rings(const std::vector<queue::QueueDescriptor> &descriptors,
+                       const std::vector<const queue::SharedRing *> &rings,
+                       ControlServiceResult *result) {
+    if (result == nullptr || rings.empty() || rings.size() != descriptors.size()) {
+        return EINVAL;
+    }
+    const bool in_arena = rings.front()->in_arena();
+    std::vector<std::uint64_t> offsets;
+    std::vector<ipc::UniqueFd> ring_fds;
+    for (const queue::SharedRing *ring : rings) {
+        if (ring->in_arena() != in_arena) {
+            return EINVAL;
+        }
+        if (in_arena) {
+            offsets.push_back(ring->arena_offset());
+            continue;
+        }
+        int descriptor = -1;
+        const int duplicate_status = ring->duplicate_fd(&descriptor);
+        if (duplicate_status != 0) {
+            return duplicate_status;
+        }
+        ring_fds.emplace_back(descriptor);
+    }
+    std::vector<std::byte> encoded;
+    const int encode_status =
+        encode_queue_descriptors(descriptors, &encoded, in_arena ? &offsets : nullptr);
+    if (encode_status != 0) {
+        return encode_status;
+    }
+    result->response.opaque = std::move(encoded);
+    result->response.fd_indices.clear();
+    for (std::uint32_t index = 0; index < ring_fds.size(); ++index) {
+        result->response.fd_indices.push_back(index);
+    }
+    result->file_descriptors = std::move(ring_fds);
+    return 0;
+}
+
+int map_queue_rings(const DecodedControlResponse &response,
+                    const std::vector<queue::QueueDescriptor> &expected,
+                    const RingMapOptions &options, std::vector<queue::SharedRing> *rings) {
+    if (rings == nullptr || expected.empty()) {
+        return EINVAL;
+    }
+    std::vector<queue::QueueDescriptor> descriptors;
+    std::vector<std::uint64_t> offsets;
+    const int decode_status = decode_queue_descriptors(
+        response.value.opaque, &descriptors, options.arena != nullptr ? &offsets : nullptr);
+    if (decode_status != 0 || descriptors != expected) {
+        return decode_status == EPROTONOSUPPORT ? decode_status : EPROTO;
+    }
+    std::vector<std::uint32_t> expected_indices;
+    if (offsets.empty()) {
+        for (std::uint32_t index = 0; index < expected.size(); ++index) {
+            expected_indices.push_back(index);
+        }
+    }
+    if (response.value.fd_indices != expected_indices ||
+        response.file_descriptors.size() != expected_indices.size()) {
+        return EPROTO;
+    }
+    const queue::RingMemoryOptions memory{false, options.prefault};
+    std::vector<queue::SharedRing> mapped(expected.size());
+    for (std::size_t index = 0; index < expected.size(); ++index) {
+        const int map_status =
+            offsets.empty()
+                ? queue::map_shared_ring(response.file_descriptors[index].get(), expected[index],
+                                         &mapped[index], memory)
+                : queue::map_arena_ring(options.arena, offsets[index], expected[index],
+                                        &mapped[index], memory);
+        if (map_status != 0) {
+            return map_status;
+        }
+    }
+    *rings = std::move(mapped);
+    return 0;
+}
+
 PdMrCqService::PdMrCqService(gpu::CudaIpcMemoryBackend &memory_backend)
-    : memory_backend_(memory_backend) {
+    : mappings_(memory_backend) {
 }
 
 PdMrCqService::PdMrCqService(DeviceCatalog catalog, gpu::CudaIpcMemoryBackend &memory_backend)
-    : DeviceContextService(std::move(catalog)), memory_backend_(memory_backend) {
+    : DeviceContextService(std::move(catalog)), mappings_(memory_backend) {
 }
 
 ControlServiceResult PdMrCqService::handle(ipc::SessionId session_id,
@@ -314,6 +408,10 @@ ControlServiceResult PdMrCqService::handle(ipc::SessionId session_id,
         return handle_create_cq(session_id, request);
     case ControlMethod::destroy_cq:
         return handle_destroy_cq(session_id, request);
+    case ControlMethod::modify_cq:
+        return handle_modify_cq(session_id, request);
+    case ControlMethod::map_ring_arena:
+        return handle_map_ring_arena(session_id, request);
     default:
         return DeviceContextService::handle(session_id, std::move(request));
     }
@@ -329,7 +427,7 @@ ControlServiceResult PdMrCqService::handle_create_pd(ipc::SessionId session_id,
         return response_for(request, EINVAL);
     }
     const auto identity =
-        pds_.insert(session_id, PdRecord{request.value.object_identity, {}, {}, {}, 0});
+        pds_.insert(session_id, PdRecord{request.value.object_identity, {}, 0});
     if (!identity.has_value()) {
         return response_for(request, ENOSPC);
     }
@@ -348,7 +446,7 @@ ControlServiceResult PdMrCqService::handle_destroy_pd(ipc::SessionId session_id,
     if (pd == nullptr) {
         return response_for(request, EINVAL);
     }
-    if (!pd->mr_identities.empty() || pd->qp_count != 0) {
+    if (!pd->mr_identities.empty() || pd->qp_count != 0 || pd->srq_count != 0) {
         return response_for(request, EBUSY);
     }
     ContextRecord *const context = resolve_context(session_id, pd->context_identity);
@@ -379,27 +477,41 @@ ControlServiceResult PdMrCqService::handle_register_mr(ipc::SessionId session_id
         return response_for(request, decode_status);
     }
     gpu::CudaIpcMapping mapping;
-    const int open_status = memory_backend_.open(memory, &mapping);
+    const int open_status = mappings_.open(memory, &mapping);
     if (open_status != 0) {
         return response_for(request, open_status);
     }
     if (mapping.daemon_base_address == 0 || mapping.gpu_uuid != memory.gpu_uuid ||
         mapping.daemon_base_address >
             std::numeric_limits<std::uint64_t>::max() - memory.allocation_offset) {
-        (void)memory_backend_.close(mapping);
+        (void)mappings_.close(mapping);
         return response_for(request, EPROTO);
     }
 
-    const auto keys = allocate_keys(&next_key_);
+    MrKeyEntry key_entry;
+    key_entry.owner_session = session_id;
+    key_entry.pd_identity = request.value.object_identity;
+    key_entry.client_address = memory.client_address;
+    key_entry.length = memory.length;
+    key_entry.daemon_address = mapping.daemon_base_address + memory.allocation_offset;
+    key_entry.access = request.value.access;
+    std::optional<MrKeys> keys;
+    try {
+        keys = mr_keys_.insert(key_entry);
+    } catch (...) {
+        (void)mappings_.close(mapping);
+        return response_for(request, ENOMEM);
+    }
     if (!keys.has_value()) {
-        (void)memory_backend_.close(mapping);
+        (void)mappings_.close(mapping);
         return response_for(request, ENOSPC);
     }
-    MrRegistrationResult accepted{memory.client_address, memory.length, keys->first, keys->second};
+    MrRegistrationResult accepted{memory.client_address, memory.length, keys->lkey, keys->rkey};
     std::vector<std::byte> encoded_result;
     const int encode_status = encode_mr_registration_result(accepted, &encoded_result);
     if (encode_status != 0) {
-        (void)memory_backend_.close(mapping);
+        mr_keys_.erase(keys->lkey);
+        (void)mappings_.close(mapping);
         return response_for(request, encode_status);
     }
 
@@ -410,33 +522,29 @@ ControlServiceResult PdMrCqService::handle_register_mr(ipc::SessionId session_id
     record.client_address = memory.client_address;
     record.allocation_size = memory.allocation_size;
     record.allocation_offset = memory.allocation_offset;
-    record.daemon_address = mapping.daemon_base_address + memory.allocation_offset;
+    record.daemon_address = key_entry.daemon_address;
     record.length = memory.length;
     record.access = request.value.access;
-    record.lkey = keys->first;
-    record.rkey = keys->second;
+    record.lkey = keys->lkey;
+    record.rkey = keys->rkey;
     record.mapping = mapping;
     const auto identity = mrs_.insert(session_id, std::move(record));
     if (!identity.has_value()) {
-        (void)memory_backend_.close(mapping);
+        mr_keys_.erase(keys->lkey);
+        (void)mappings_.close(mapping);
         return response_for(request, ENOSPC);
     }
 
     bool relation_added = false;
-    bool local_added = false;
-    bool remote_added = false;
     try {
         relation_added = pd->mr_identities.insert(*identity).second;
-        local_added = pd->local_key_index.emplace(keys->first, *identity).second;
-        remote_added = pd->remote_key_index.emplace(keys->second, *identity).second;
     } catch (...) {
     }
-    if (!relation_added || !local_added || !remote_added) {
+    if (!relation_added) {
         pd->mr_identities.erase(*identity);
-        pd->local_key_index.erase(keys->first);
-        pd->remote_key_index.erase(keys->second);
+        mr_keys_.erase(keys->lkey);
         (void)mrs_.erase(session_id, *identity);
-        (void)memory_backend_.close(mapping);
+        (void)mappings_.close(mapping);
         return response_for(request, ENOMEM);
     }
 
@@ -458,7 +566,7 @@ ControlServiceResult PdMrCqService::handle_deregister_mr(ipc::SessionId session_
     if (mr->work_request_references != 0) {
         return response_for(request, EBUSY);
     }
-    const int close_status = memory_backend_.close(mr->mapping);
+    const int close_status = mappings_.close(mr->mapping);
     if (close_status != 0) {
         return response_for(request, close_status);
     }
@@ -466,8 +574,8 @@ ControlServiceResult PdMrCqService::handle_deregister_mr(ipc::SessionId session_
     if (pd == nullptr) {
         return response_for(request, EINVAL);
     }
-    pd->local_key_index.erase(mr->lkey);
-    pd->remote_key_index.erase(mr->rkey);
+    mr_keys_.erase(mr->lkey);
+    mr_key_epoch_.fetch_add(1, std::memory_order_release);
     pd->mr_identities.erase(request.value.object_identity);
     return response_for(request, mrs_.erase(session_id, request.value.object_identity));
 }
@@ -476,7 +584,7 @@ ControlServiceResult PdMrCqService::handle_create_cq(ipc::SessionId session_id,
                                                      DecodedControlRequest &request) {
     if (request.value.length == 0 ||
         request.value.length > std::numeric_limits<std::uint32_t>::max() ||
-        request.value.access != 0 || !request.value.opaque.empty() ||
+        (request.value.access & ~kCqCreateCompact) != 0 || !request.value.opaque.empty() ||
         !request.value.fd_indices.empty() || !request.file_descriptors.empty()) {
         return response_for(request, EINVAL);
     }
@@ -486,27 +594,17 @@ ControlServiceResult PdMrCqService::handle_create_cq(ipc::SessionId session_id,
     }
     const queue::QueueDescriptor descriptor{queue::QueueKind::completion,
                                             static_cast<std::uint32_t>(request.value.length),
-                                            queue::completion_slot_stride()};
+                                            cq_slot_stride(request.value.access)};
     queue::SharedRing completions;
-    const int create_status = queue::create_shared_ring(descriptor, &completions);
+    const int create_status = create_ring(*context, descriptor, &completions);
     if (create_status != 0) {
         return response_for(request, create_status);
     }
-    int response_fd = -1;
-    const int duplicate_status = completions.duplicate_fd(&response_fd);
-    if (duplicate_status != 0) {
-        return response_for(request, duplicate_status);
-    }
-    ipc::UniqueFd response_descriptor(response_fd);
-    std::vector<std::byte> encoded_descriptor;
-    const int encode_status = encode_queue_descriptors({descriptor}, &encoded_descriptor);
-    if (encode_status != 0) {
-        return response_for(request, encode_status);
-    }
     ControlServiceResult result = response_for(request);
-    result.response.opaque = std::move(encoded_descriptor);
-    result.response.fd_indices = {0};
-    result.file_descriptors.push_back(std::move(response_descriptor));
+    const int attach_status = attach_queue_rings({descriptor}, {&completions}, &result);
+    if (attach_status != 0) {
+        return response_for(request, attach_status);
+    }
     CqRecord record;
     record.context_identity = request.value.object_identity;
     record.cqe = static_cast<std::uint32_t>(request.value.length);
@@ -543,10 +641,67 @@ ControlServiceResult PdMrCqService::handle_destroy_cq(ipc::SessionId session_id,
     return response_for(request, status);
 }
 
+ControlServiceResult PdMrCqService::handle_modify_cq(ipc::SessionId session_id,
+                                                     DecodedControlRequest &request) {
+    if (request.value.length > std::numeric_limits<std::uint32_t>::max() ||
+        request.value.access != 0 || !request.value.opaque.empty() ||
+        !request.value.fd_indices.empty() || !request.file_descriptors.empty()) {
+        return response_for(request, EINVAL);
+    }
+    CqRecord *const cq = cqs_.resolve(session_id, request.value.object_identity);
+    if (cq == nullptr) {
+        return response_for(request, EINVAL);
+    }
+    // Compact CQs publish through phase bits rather than the tail, so there is nothing to batch.
+    if (queue::compact_completions(cq->completions.descriptor())) {
+        return response_for(request, EOPNOTSUPP);
+    }
+    const queue::CompletionModeration moderation{
+        static_cast<std::uint16_t>(request.value.length >> 16U),
+        static_cast<std::uint16_t>(request.value.length & UINT16_MAX)};
+    if (moderation.count > cq->cqe) {
+        return response_for(request, EINVAL);
+    }
+    cq->moderator.configure(moderation);
+    return response_for(request);
+}
+
+ControlServiceResult PdMrCqService::handle_map_ring_arena(ipc::SessionId session_id,
+                                                          DecodedControlRequest &request) {
+    if (request.value.length == 0 || request.value.access != 0 || !request.value.opaque.empty() ||
+        !request.value.fd_indices.empty() || !request.file_descriptors.empty()) {
+        return response_for(request, EINVAL);
+    }
+    ContextRecord *const context = resolve_context(session_id, request.value.object_identity);
+    if (context == nullptr) {
+        return response_for(request, EINVAL);
+    }
+    if (context->ring_arena != nullptr) {
+        return response_for(request, EEXIST);
+    }
+    std::shared_ptr<queue::SharedRingArena> arena;
+    int status = queue::SharedRingArena::create(request.value.length, &arena,
+                                                catalog().numa_node(context->device_identity));
+    int descriptor = -1;
+    if (status == 0) {
+        status = arena->duplicate_fd(&descriptor);
+    }
+    if (status != 0) {
+        return response_for(request, status);
+    }
+    ControlServiceResult result = response_for(request);
+    result.response.fd_indices = {0};
+    result.file_descriptors.emplace_back(descriptor);
+    context->ring_arena = std::move(arena);
+    return result;
+}
+
 void PdMrCqService::on_disconnect(ipc::SessionId session_id) noexcept {
     mrs_.for_each_session(session_id, [this](std::uint64_t, MrRecord &mr) {
-        (void)memory_backend_.close(mr.mapping);
+        mr_keys_.erase(mr.lkey);
+        (void)mappings_.close(mr.mapping);
     });
+    mr_key_epoch_.fetch_add(1, std::memory_order_release);
     (void)mrs_.erase_session(session_id);
     (void)cqs_.erase_session(session_id);
     (void)pds_.erase_session(session_id);
@@ -559,36 +714,29 @@ int PdMrCqService::resolve_key(ipc::SessionId session_id, std::uint64_t pd_ident
     if (key == 0 || length == 0 || daemon_address == nullptr) {
         return EINVAL;
     }
-    const PdRecord *const pd = pds_.resolve(session_id, pd_identity);
-    if (pd == nullptr) {
-        return EINVAL;
-    }
-    const auto &index = remote ? pd->remote_key_index : pd->local_key_index;
-    const auto found = index.find(key);
-    if (found == index.end()) {
-        return EINVAL;
-    }
-    const MrRecord *const mr = mrs_.resolve(session_id, found->second);
-    if (mr == nullptr || mr->pd_identity != pd_identity) {
-        return EINVAL;
-    }
-    if (remote && (mr->access & kAccessRemoteWrite) == 0) {
-        return EACCES;
-    }
-    if (address < mr->client_address ||
-        address > std::numeric_limits<std::uint64_t>::max() - length ||
-        mr->client_address > std::numeric_limits<std::uint64_t>::max() - mr->length ||
-        address + length > mr->client_address + mr->length) {
+    // A live entry implies a live PD: PD destroy is refused while it still has MRs.
+    const MrKeyEntry *const mr = mr_keys_.find(key, remote);
+    if (mr == nullptr || mr->owner_session != session_id || mr->pd_identity != pd_identity) {
         return EINVAL;
     }
-    const std::uint64_t offset = address - mr->client_address;
-    if (mr->daemon_address > std::numeric_limits<std::uint64_t>::max() - offset) {
+    return translate_mr_key(*mr, remote, address, length, daemon_address);
+}
+
+int PdMrCqService::find_mr_key(ipc::SessionId session_id, std::uint64_t pd_identity,
+                               std::uint32_t key, bool remote, MrKeyEntry *entry) const noexcept {
+    const MrKeyEntry *const mr = mr_keys_.find(key, remote);
+    if (entry == nullptr || mr == nullptr || mr->owner_session != session_id ||
+        mr->pd_identity != pd_identity) {
         return EINVAL;
     }
-    *daemon_address = mr->daemon_address + offset;
+    *entry = *mr;
     return 0;
 }
 
+std::uint64_t PdMrCqService::mr_key_epoch() const noexcept {
+    return mr_key_epoch_.load(std::memory_order_acquire);
+}
+
 int PdMrCqService::resolve_lkey(ipc::SessionId session_id, std::uint64_t pd_identity,
                                 std::uint32_t lkey, std::uint64_t address, std::uint64_t length,
                                 std::uint64_t *daemon_address) const noexcept {
@@ -613,6 +761,29 @@ std::size_t PdMrCqService::cq_count() const noexcept {
     return cqs_.size();
 }
 
+void PdMrCqService::set_ring_pool(queue::SharedRingPool *pool) noexcept {
+    ring_pool_ = pool;
+}
+
+void PdMrCqService::set_ring_memory_options(const queue::RingMemoryOptions &options) noexcept {
+    ring_memory_options_ = options;
+}
+
+int PdMrCqService::create_ring(const ContextRecord &context,
+                               const queue::QueueDescriptor &descriptor,
+                               queue::SharedRing *ring) noexcept {
+    if (context.ring_arena != nullptr) {
+        return queue::create_arena_ring(context.ring_arena, descriptor, ring);
+    }
+    // The pool fills rings on one node; a device on another node gets its rings created inline.
+    queue::RingMemoryOptions options = ring_memory_options_;
+    options.numa_node = catalog().numa_node(context.device_identity);
+    queue::SharedRingPool *const pool =
+        ring_pool_ != nullptr && ring_pool_->options().numa_node == options.numa_node ? ring_pool_
+                                                                                     : nullptr;
+    return queue::create_pooled_ring(pool, descriptor, ring, options);
+}
+
 PdRecord *PdMrCqService::resolve_pd(ipc::SessionId session_id, std::uint64_t identity) noexcept {
     return pds_.resolve(session_id, identity);
 }
@@ -639,7 +810,7 @@ int client_create_pd(ControlClient &client, std::uint64_t context_identity,
 }
 
 int client_destroy_pd(ControlClient &client, std::uint64_t pd_identity) {
-    return pd_identity == 0 ? EINVAL : call_destroy(client, make_destroy_pd_request(pd_identity));
+    return pd_identity == 0 ? EINVAL : call_empty(client, make_destroy_pd_request(pd_identity));
 }
 
 int client_register_mr(ControlClient &client, std::uint64_t pd_identity,
@@ -677,18 +848,19 @@ int client_register_mr(ControlClient &client, std::uint64_t pd_identity,
 }
 
 int client_deregister_mr(ControlClient &client, std::uint64_t mr_identity) {
-    return mr_identity == 0 ? EINVAL
-                            : call_destroy(client, make_deregister_mr_request(mr_identity));
+    return mr_identity == 0 ? EINVAL : call_empty(client, make_deregister_mr_request(mr_identity));
 }
 
 int client_create_cq(ControlClient &client, std::uint64_t context_identity, std::uint32_t cqe,
-                     std::uint64_t *cq_identity, queue::SharedRing *completions) {
+                     std::uint64_t *cq_identity, queue::SharedRing *completions,
+                     std::uint32_t flags, const RingMapOptions &options) {
     if (context_identity == 0 || cqe == 0 || cq_identity == nullptr || completions == nullptr ||
-        completions->valid()) {
+        completions->valid() || (flags & ~kCqCreateCompact) != 0) {
         return EINVAL;
     }
     DecodedControlResponse response;
-    const int call_status = client.call(make_create_cq_request(context_identity, cqe), &response);
+    const int call_status =
+        client.call(make_create_cq_request(context_identity, cqe, flags), &response);
     if (call_status != 0) {
         return call_status;
     }
@@ -698,28 +870,16 @@ int client_create_cq(ControlClient &client, std::uint64_t context_identity, std:
     if (validate_identity(response.value.object_identity, ObjectType::cq) != 0) {
         return EPROTO;
     }
-    if (response.value.fd_indices != std::vector<std::uint32_t>{0} ||
-        response.file_descriptors.size() != 1) {
-        (void)client_destroy_cq(client, response.value.object_identity);
-        return EPROTO;
-    }
-    std::vector<queue::QueueDescriptor> descriptors;
-    const int decode_status = decode_queue_descriptors(response.value.opaque, &descriptors);
     const queue::QueueDescriptor expected{queue::QueueKind::completion, cqe,
-                                          queue::completion_slot_stride()};
-    if (decode_status != 0 || descriptors.size() != 1 || descriptors[0] != expected) {
-        (void)client_destroy_cq(client, response.value.object_identity);
-        return decode_status == EPROTONOSUPPORT ? decode_status : EPROTO;
-    }
-    queue::SharedRing mapped;
-    const int map_status =
-        queue::map_shared_ring(response.file_descriptors[0].get(), expected, &mapped);
+                                          cq_slot_stride(flags)};
+    std::vector<queue::SharedRing> mapped;
+    const int map_status = map_queue_rings(response, {expected}, options, &mapped);
     if (map_status != 0) {
         (void)client_destroy_cq(client, response.value.object_identity);
         return map_status;
     }
     *cq_identity = response.value.object_identity;
-    *completions = std::move(mapped);
+    *completions = std::move(mapped[0]);
     return 0;
 }
 
@@ -730,7 +890,45 @@ int client_create_cq(ControlClient &client, std::uint64_t context_identity, std:
 }
 
 int client_destroy_cq(ControlClient &client, std::uint64_t cq_identity) {
-    return cq_identity == 0 ? EINVAL : call_destroy(client, make_destroy_cq_request(cq_identity));
+    return cq_identity == 0 ? EINVAL : call_empty(client, make_destroy_cq_request(cq_identity));
+}
+
+int client_modify_cq(ControlClient &client, std::uint64_t cq_identity,
+                     const queue::CompletionModeration &moderation) {
+    return cq_identity == 0 ? EINVAL
+                            : call_empty(client, make_modify_cq_request(cq_identity, moderation));
+}
+
+int client_map_ring_arena(ControlClient &client, std::uint64_t context_identity,
+                          std::uint64_t bytes, std::shared_ptr<queue::SharedRingArena> *arena) {
+    if (context_identity == 0 || bytes == 0 || bytes > queue::kMaxRingArenaBytes ||
+        arena == nullptr) {
+        return EINVAL;
+    }
+    DecodedControlResponse response;
+    const int call_status =
+        client.call(make_map_ring_arena_request(context_identity, bytes), &response);
+    if (call_status != 0) {
+        return call_status;
+    }
+    if (response.value.status != 0) {
+        return response.value.status;
+    }
+    if (response.value.object_identity != 0 || !response.value.opaque.empty() ||
+        response.value.fd_indices != std::vector<std::uint32_t>{0} ||
+        response.file_descriptors.size() != 1) {
+        return EPROTO;
+    }
+    std::shared_ptr<queue::SharedRingArena> mapped;
+    const int map_status = queue::SharedRingArena::map(response.file_descriptors[0].get(), &mapped);
+    if (map_status != 0) {
+        return map_status;
+    }
+    if (mapped->size() < bytes) {
+        return EPROTO;
+    }
+    *arena = std::move(mapped);
+    return 0;
 }
 
 }  // namespace ugdr::control
@@ -1,20 +1,25 @@
 #pragma once
 
+#include "control/cuda_ipc_mapping_cache.hpp"
 #include "control/device_context.hpp"
+#include "control/mr_key_table.hpp"
 #include "control/object_registry.hpp"
 #include "gpu/cuda_ipc_memory.hpp"
+#include "queue/completion_queue.hpp"
+#include "queue/ring_pool.hpp"
 #include "queue/shared_ring.hpp"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <unordered_map>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 namespace ugdr::control {
 
 constexpr std::uint16_t kMrPayloadVersion = 1;
-constexpr std::uint32_t kAccessLocalWrite = UINT32_C(1) << 0U;
-constexpr std::uint32_t kAccessRemoteWrite = UINT32_C(1) << 1U;
+constexpr std::uint32_t kCqCreateCompact = UINT32_C(1) << 0U;
 
 struct MrRegistrationResult {
     std::uint64_t client_address = 0;
@@ -29,8 +34,13 @@ UgdrControlRequest make_register_mr_request(std::uint64_t pd_identity,
                                             const gpu::ExportedCudaMemory &memory,
                                             std::uint32_t access);
 UgdrControlRequest make_deregister_mr_request(std::uint64_t mr_identity);
-UgdrControlRequest make_create_cq_request(std::uint64_t context_identity, std::uint32_t cqe);
+UgdrControlRequest make_create_cq_request(std::uint64_t context_identity, std::uint32_t cqe,
+                                          std::uint32_t flags = 0);
 UgdrControlRequest make_destroy_cq_request(std::uint64_t cq_identity);
+UgdrControlRequest make_modify_cq_request(std::uint64_t cq_identity,
+                                          const queue::CompletionModeration &moderation);
+UgdrControlRequest make_map_ring_arena_request(std::uint64_t context_identity,
+                                               std::uint64_t bytes);
 
 int encode_mr_registration(const gpu::ExportedCudaMemory &memory, std::vector<std::byte> *bytes);
 int decode_mr_registration(const std::vector<std::byte> &bytes, std::uint64_t length,
@@ -40,12 +50,28 @@ int encode_mr_registration_result(const MrRegistrationResult &result,
 int decode_mr_registration_result(const std::vector<std::byte> &bytes,
                                   MrRegistrationResult *result);
 
+// How a client maps the rings of a create response: offsets resolve against arena, and prefault
+// populates each mapping before it is handed out.
+struct RingMapOptions {
+    std::shared_ptr<queue::SharedRingArena> arena;
+    bool prefault = false;
+};
+
+// Describes rings in a create response: by arena offset when they live in the context's arena,
+// otherwise by one fd each. map_queue_rings is the client side and only accepts offsets when
+// it has the arena to resolve them against.
+int attach_queue_rings(const std::vector<queue::QueueDescriptor> &descriptors,
+                       const std::vector<const queue::SharedRing *> &rings,
+                       ControlServiceResult *result);
+int map_queue_rings(const DecodedControlResponse &response,
+                    const std::vector<queue::QueueDescriptor> &expected,
+                    const RingMapOptions &options, std::vector<queue::SharedRing> *rings);
+
 struct PdRecord {
     std::uint64_t context_identity = 0;
     std::unordered_set<std::uint64_t> mr_identities;
-    std::unordered_map<std::uint32_t, std::uint64_t> local_key_index;
-    std::unordered_map<std::uint32_t, std::uint64_t> remote_key_index;
     std::size_t qp_count = 0;
+    std::size_t srq_count = 0;
 };
 
 struct MrRecord {
@@ -69,6 +95,7 @@ struct CqRecord {
     std::uint32_t cqe = 0;
     std::size_t qp_references = 0;
     queue::SharedRing completions;
+    queue::CompletionModerator moderator;
 };
 
 class PdMrCqService : public DeviceContextService {
@@ -85,6 +112,15 @@ class PdMrCqService : public DeviceContextService {
     int resolve_rkey(ipc::SessionId session_id, std::uint64_t pd_identity, std::uint32_t rkey,
                      std::uint64_t address, std::uint64_t length,
                      std::uint64_t *daemon_address) const noexcept;
+    int find_mr_key(ipc::SessionId session_id, std::uint64_t pd_identity, std::uint32_t key,
+                    bool remote, MrKeyEntry *entry) const noexcept;
+    // Bumped whenever a key stops resolving, so worker-side translation caches can drop entries.
+    [[nodiscard]] std::uint64_t mr_key_epoch() const noexcept;
+    // Queue rings come from pool when set. The pool must outlive the service.
+    void set_ring_pool(queue::SharedRingPool *pool) noexcept;
+    // Backs rings created without a pool; a pool applies its own options. The NUMA node always
+    // comes from the catalog.
+    void set_ring_memory_options(const queue::RingMemoryOptions &options) noexcept;
 
     [[nodiscard]] std::size_t pd_count() const noexcept;
     [[nodiscard]] std::size_t mr_count() const noexcept;
@@ -95,6 +131,10 @@ class PdMrCqService : public DeviceContextService {
     const PdRecord *resolve_pd(ipc::SessionId session_id, std::uint64_t identity) const noexcept;
     CqRecord *resolve_cq(ipc::SessionId session_id, std::uint64_t identity) noexcept;
     const CqRecord *resolve_cq(ipc::SessionId session_id, std::uint64_t identity) const noexcept;
+    // Carves the ring from the context's arena when it has one, otherwise uses the pool. Either
+    // way the ring's pages prefer the NUMA node of the context's device.
+    int create_ring(const ContextRecord &context, const queue::QueueDescriptor &descriptor,
+                    queue::SharedRing *ring) noexcept;
 
   private:
     ControlServiceResult handle_create_pd(ipc::SessionId session_id,
@@ -109,15 +149,22 @@ class PdMrCqService : public DeviceContextService {
                                           DecodedControlRequest &request);
     ControlServiceResult handle_destroy_cq(ipc::SessionId session_id,
                                            DecodedControlRequest &request);
+    ControlServiceResult handle_modify_cq(ipc::SessionId session_id,
+                                          DecodedControlRequest &request);
+    ControlServiceResult handle_map_ring_arena(ipc::SessionId session_id,
+                                               DecodedControlRequest &request);
     int resolve_key(ipc::SessionId session_id, std::uint64_t pd_identity, std::uint32_t key,
                     std::uint64_t address, std::uint64_t length, bool remote,
                     std::uint64_t *daemon_address) const noexcept;
 
-    gpu::CudaIpcMemoryBackend &memory_backend_;
+    CudaIpcMappingCache mappings_;
     GenerationRegistry<PdRecord, ObjectType::pd> pds_;
     GenerationRegistry<MrRecord, ObjectType::mr> mrs_;
     GenerationRegistry<CqRecord, ObjectType::cq> cqs_;
-    std::uint64_t next_key_ = 1;
+    MrKeyTable mr_keys_;
+    std::atomic<std::uint64_t> mr_key_epoch_{0};
+    queue::SharedRingPool *ring_pool_ = nullptr;
+    queue::RingMemoryOptions ring_memory_options_;
 };
 
 int client_create_pd(ControlClient &client, std::uint64_t context_identity,
@@ -128,9 +175,15 @@ int client_register_mr(ControlClient &client, std::uint64_t pd_identity,
                        std::uint64_t *mr_identity, MrRegistrationResult *result);
 int client_deregister_mr(ControlClient &client, std::uint64_t mr_identity);
 int client_create_cq(ControlClient &client, std::uint64_t context_identity, std::uint32_t cqe,
-                     std::uint64_t *cq_identity, queue::SharedRing *completions);
+                     std::uint64_t *cq_identity, queue::SharedRing *completions,
+                     std::uint32_t flags = 0, const RingMapOptions &options = {});
 int client_create_cq(ControlClient &client, std::uint64_t context_identity, std::uint32_t cqe,
                      std::uint64_t *cq_identity);
 int client_destroy_cq(ControlClient &client, std::uint64_t cq_identity);
+int client_modify_cq(ControlClient &client, std::uint64_t cq_identity,
+                     const queue::CompletionModeration &moderation);
+// Asks the daemon for a ring arena of at least bytes on context and maps it.
+int client_map_ring_arena(ControlClient &client, std::uint64_t context_identity,
+                          std::uint64_t bytes, std::shared_ptr<queue::SharedRingArena> *arena);
 
 }  // namespace ugdr::control
@@ -11,12 +11,13 @@
 namespace ugdr::control {
 namespace {
 
-constexpr std::size_t kQpCreatePayloadSize = 44;
+constexpr std::size_t kQpCreatePayloadSize = 52;
 constexpr std::size_t kQpQueryPayloadSize = 8;
 constexpr std::size_t kQpModifyPayloadSize = 24;
 constexpr std::size_t kQpConnectPayloadSize = 16;
-constexpr std::size_t kQpSnapshotPayloadSize = 64;
+constexpr std::size_t kQpSnapshotPayloadSize = 72;
 constexpr std::size_t kQpConnInfoPayloadSize = 8;
+constexpr std::size_t kSrqCreatePayloadSize = 12;
 
 std::uint64_t host_to_network64(std::uint64_t value) noexcept {
 #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
@@ -227,6 +228,36 @@ int decode_conn_info(const std::vector<std::byte> &bytes, std::uint32_t *qp_num)
     return decode_query_payload(bytes, qp_num);
 }
 
+std::vector<std::byte> encode_srq_payload(std::uint32_t max_wr, std::uint32_t max_sge) {
+    std::vector<std::byte> bytes;
+    bytes.reserve(kSrqCreatePayloadSize);
+    append_header(&bytes);
+    append(&bytes, htonl(max_wr));
+    append(&bytes, htonl(max_sge));
+    return bytes;
+}
+
+int decode_srq_payload(const std::vector<std::byte> &bytes, RqMetadata *rq) {
+    std::size_t offset = 0;
+    const int status = read_header(bytes, kSrqCreatePayloadSize, &offset);
+    std::uint32_t max_wr = 0, max_sge = 0;
+    if (status != 0 || rq == nullptr || !read(bytes, &offset, &max_wr) ||
+        !read(bytes, &offset, &max_sge)) {
+        return status != 0 ? status : EPROTO;
+    }
+    *rq = {ntohl(max_wr), ntohl(max_sge)};
+    return 0;
+}
+
+int receive_descriptor(const RqMetadata &rq, queue::QueueDescriptor *descriptor) noexcept {
+    std::uint32_t stride = 0;
+    const int status = queue::receive_slot_stride(rq.max_sge, &stride);
+    if (status == 0) {
+        *descriptor = {queue::QueueKind::receive, rq.max_wr, stride};
+    }
+    return status;
+}
+
 std::vector<std::byte> encode_snapshot(const QpRecord &record) {
     std::vector<std::byte> bytes;
     bytes.reserve(kQpSnapshotPayloadSize);
@@ -234,6 +265,7 @@ std::vector<std::byte> encode_snapshot(const QpRecord &record) {
     append(&bytes, htonl(record.qp_num));
     append(&bytes, host_to_network64(record.send_cq_identity));
     append(&bytes, host_to_network64(record.recv_cq_identity));
+    append(&bytes, host_to_network64(record.srq_identity));
     append(&bytes, htonl(record.sq.max_wr));
     append(&bytes, htonl(record.rq.max_wr));
     append(&bytes, htonl(record.sq.max_sge));
@@ -258,10 +290,11 @@ int decode_snapshot(const std::vector<std::byte> &bytes, QpSnapshot *snapshot) {
     }
     std::uint32_t qp_num = 0, max_send_wr = 0, max_recv_wr = 0, max_send_sge = 0, max_recv_sge = 0,
                   qp_type = 0, sq_sig_all = 0, state = 0, current = 0, access = 0;
-    std::uint64_t send_cq = 0, recv_cq = 0;
+    std::uint64_t send_cq = 0, recv_cq = 0, srq = 0;
     QpSnapshot decoded;
     if (!read(bytes, &offset, &qp_num) || !read(bytes, &offset, &send_cq) ||
-        !read(bytes, &offset, &recv_cq) || !read(bytes, &offset, &max_send_wr) ||
+        !read(bytes, &offset, &recv_cq) || !read(bytes, &offset, &srq) ||
+        !read(bytes, &offset, &max_send_wr) ||
         !read(bytes, &offset, &max_recv_wr) || !read(bytes, &offset, &max_send_sge) ||
         !read(bytes, &offset, &max_recv_sge) || !read(bytes, &offset, &qp_type) ||
         !read(bytes, &offset, &sq_sig_all) || !read(bytes, &offset, &state) ||
@@ -280,7 +313,8 @@ int decode_snapshot(const std::vector<std::byte> &bytes, QpSnapshot *snapshot) {
                         ntohl(max_send_sge),
                         ntohl(max_recv_sge),
                         ntohl(qp_type),
-                        ntohl(sq_sig_all)};
+                        ntohl(sq_sig_all),
+                        network_to_host64(srq)};
     decoded.attributes.state = ntohl(state);
     decoded.attributes.current_state = ntohl(current);
     decoded.attributes.access_flags = ntohl(access);
@@ -302,9 +336,12 @@ bool valid_retry_attributes(const QpAttributes &attributes) noexcept {
 }  // namespace
 
 bool valid_qp_create_attributes(const QpCreateAttributes &attributes) noexcept {
+    // A QP attached to an SRQ has no receive ring of its own, so it carries no RQ capacities.
+    const bool valid_receive = attributes.srq_identity != 0
+                                   ? attributes.max_recv_wr == 0 && attributes.max_recv_sge == 0
+                                   : attributes.max_recv_wr != 0 && attributes.max_recv_sge != 0;
     return attributes.send_cq_identity != 0 && attributes.recv_cq_identity != 0 &&
-           attributes.max_send_wr != 0 && attributes.max_recv_wr != 0 &&
-           attributes.max_send_sge != 0 && attributes.max_recv_sge != 0 &&
+           attributes.max_send_wr != 0 && attributes.max_send_sge != 0 && valid_receive &&
            attributes.qp_type == kQpTypeRc && attributes.sq_sig_all <= 1;
 }
 
@@ -325,6 +362,7 @@ int encode_qp_create_attributes(const QpCreateAttributes &attributes,
     append(&encoded, htonl(attributes.max_recv_sge));
     append(&encoded, htonl(attributes.qp_type));
     append(&encoded, htonl(attributes.sq_sig_all));
+    append(&encoded, host_to_network64(attributes.srq_identity));
     *bytes = std::move(encoded);
     return 0;
 }
@@ -345,11 +383,13 @@ int decode_qp_create_attributes(const std::vector<std::byte> &bytes,
     std::uint32_t max_recv_sge = 0;
     std::uint32_t qp_type = 0;
     std::uint32_t sq_sig_all = 0;
+    std::uint64_t srq = 0;
     if (!read(bytes, &offset, &version) || !read(bytes, &offset, &reserved) ||
         !read(bytes, &offset, &send_cq) || !read(bytes, &offset, &recv_cq) ||
         !read(bytes, &offset, &max_send_wr) || !read(bytes, &offset, &max_recv_wr) ||
         !read(bytes, &offset, &max_send_sge) || !read(bytes, &offset, &max_recv_sge) ||
-        !read(bytes, &offset, &qp_type) || !read(bytes, &offset, &sq_sig_all)) {
+        !read(bytes, &offset, &qp_type) || !read(bytes, &offset, &sq_sig_all) ||
+        !read(bytes, &offset, &srq)) {
         return EPROTO;
     }
     if (ntohs(version) != kQpPayloadVersion) {
@@ -367,6 +407,7 @@ int decode_qp_create_attributes(const std::vector<std::byte> &bytes,
     decoded.max_recv_sge = ntohl(max_recv_sge);
     decoded.qp_type = ntohl(qp_type);
     decoded.sq_sig_all = ntohl(sq_sig_all);
+    decoded.srq_identity = network_to_host64(srq);
     *attributes = decoded;
     return 0;
 }
@@ -421,6 +462,22 @@ UgdrControlRequest make_connect_qp_request(std::uint64_t qp_identity, std::uint3
     return request;
 }
 
+UgdrControlRequest make_create_srq_request(std::uint64_t pd_identity, std::uint32_t max_wr,
+                                           std::uint32_t max_sge) {
+    UgdrControlRequest request;
+    request.method = static_cast<std::uint32_t>(ControlMethod::create_srq);
+    request.object_identity = pd_identity;
+    request.opaque = encode_srq_payload(max_wr, max_sge);
+    return request;
+}
+
+UgdrControlRequest make_destroy_srq_request(std::uint64_t srq_identity) {
+    UgdrControlRequest request;
+    request.method = static_cast<std::uint32_t>(ControlMethod::destroy_srq);
+    request.object_identity = srq_identity;
+    return request;
+}
+
 QpService::QpService(gpu::CudaIpcMemoryBackend &memory_backend) : PdMrCqService(memory_backend) {
 }
 
@@ -442,6 +499,10 @@ ControlServiceResult QpService::handle(ipc::SessionId session_id, DecodedControl
         return handle_query_qp_conn_info(session_id, request);
     case ControlMethod::connect_qp:
         return handle_connect_qp(session_id, request);
+    case ControlMethod::create_srq:
+        return handle_create_srq(session_id, request);
+    case ControlMethod::destroy_srq:
+        return handle_destroy_srq(session_id, request);
     default:
         return PdMrCqService::handle(session_id, std::move(request));
     }
@@ -463,11 +524,20 @@ ControlServiceResult QpService::handle_create_qp(ipc::SessionId session_id,
     PdRecord *const pd = resolve_pd(session_id, request.value.object_identity);
     CqRecord *const send_cq = resolve_cq(session_id, attributes.send_cq_identity);
     CqRecord *const recv_cq = resolve_cq(session_id, attributes.recv_cq_identity);
-    if (pd == nullptr || send_cq == nullptr || recv_cq == nullptr ||
+    const ContextRecord *const context =
+        pd == nullptr ? nullptr : resolve_context(session_id, pd->context_identity);
+    if (context == nullptr || send_cq == nullptr || recv_cq == nullptr ||
         pd->context_identity != send_cq->context_identity ||
         pd->context_identity != recv_cq->context_identity) {
         return response_for(request, EINVAL);
     }
+    SrqRecord *srq = nullptr;
+    if (attributes.srq_identity != 0) {
+        srq = srqs_.resolve(session_id, attributes.srq_identity);
+        if (srq == nullptr || srq->context_identity != pd->context_identity) {
+            return response_for(request, EINVAL);
+        }
+    }
 
     QpRecord record;
     record.owner_session = session_id;
@@ -475,52 +545,37 @@ ControlServiceResult QpService::handle_create_qp(ipc::SessionId session_id,
     record.pd_identity = request.value.object_identity;
     record.send_cq_identity = attributes.send_cq_identity;
     record.recv_cq_identity = attributes.recv_cq_identity;
+    record.srq_identity = attributes.srq_identity;
     record.sq = {attributes.max_send_wr, attributes.max_send_sge};
     record.rq = {attributes.max_recv_wr, attributes.max_recv_sge};
     record.qp_type = attributes.qp_type;
     record.sq_sig_all = attributes.sq_sig_all;
     std::uint32_t send_stride = 0;
-    std::uint32_t receive_stride = 0;
     int queue_status = queue::send_slot_stride(attributes.max_send_sge, &send_stride);
-    if (queue_status == 0) {
-        queue_status = queue::receive_slot_stride(attributes.max_recv_sge, &receive_stride);
+    std::vector<queue::QueueDescriptor> descriptors{
+        {queue::QueueKind::send, attributes.max_send_wr, send_stride}};
+    if (queue_status == 0 && srq == nullptr) {
+        descriptors.emplace_back();
+        queue_status = receive_descriptor(record.rq, &descriptors.back());
     }
     if (queue_status != 0) {
         return response_for(request, queue_status);
     }
-    const queue::QueueDescriptor send_descriptor{queue::QueueKind::send, attributes.max_send_wr,
-                                                 send_stride};
-    const queue::QueueDescriptor receive_descriptor{queue::QueueKind::receive,
-                                                    attributes.max_recv_wr, receive_stride};
-    queue_status = queue::create_shared_ring(send_descriptor, &record.send_queue);
-    if (queue_status == 0) {
-        queue_status = queue::create_shared_ring(receive_descriptor, &record.receive_queue);
-    }
-    if (queue_status != 0) {
-        return response_for(request, queue_status);
+    queue_status = create_ring(*context, descriptors[0], &record.send_queue);
+    if (queue_status == 0 && srq == nullptr) {
+        queue_status = create_ring(*context, descriptors[1], &record.receive_queue);
     }
-    int send_fd = -1;
-    int receive_fd = -1;
-    queue_status = record.send_queue.duplicate_fd(&send_fd);
+    ControlServiceResult result = response_for(request);
     if (queue_status == 0) {
-        queue_status = record.receive_queue.duplicate_fd(&receive_fd);
+        std::vector<const queue::SharedRing *> rings{&record.send_queue};
+        if (srq == nullptr) {
+            rings.push_back(&record.receive_queue);
+        }
+        queue_status = attach_queue_rings(descriptors, rings, &result);
     }
-    ipc::UniqueFd send_response_fd(send_fd);
-    ipc::UniqueFd receive_response_fd(receive_fd);
     if (queue_status != 0) {
         return response_for(request, queue_status);
     }
-    std::vector<std::byte> encoded_descriptors;
-    queue_status =
-        encode_queue_descriptors({send_descriptor, receive_descriptor}, &encoded_descriptors);
-    if (queue_status != 0) {
-        return response_for(request, queue_status);
-    }
-    ControlServiceResult result = response_for(request);
-    result.response.opaque = std::move(encoded_descriptors);
-    result.response.fd_indices = {0, 1};
-    result.file_descriptors.push_back(std::move(send_response_fd));
-    result.file_descriptors.push_back(std::move(receive_response_fd));
     if (next_qp_num_ == 0) {
         return response_for(request, ENOSPC);
     }
@@ -546,6 +601,9 @@ ControlServiceResult QpService::handle_create_qp(ipc::SessionId session_id,
     if (recv_cq != send_cq) {
         ++recv_cq->qp_references;
     }
+    if (srq != nullptr) {
+        ++srq->qp_references;
+    }
 
     result.response.object_identity = *identity;
     return result;
@@ -563,8 +621,11 @@ ControlServiceResult QpService::handle_destroy_qp(ipc::SessionId session_id,
     PdRecord *const pd = resolve_pd(session_id, qp->pd_identity);
     CqRecord *const send_cq = resolve_cq(session_id, qp->send_cq_identity);
     CqRecord *const recv_cq = resolve_cq(session_id, qp->recv_cq_identity);
+    SrqRecord *const srq =
+        qp->srq_identity == 0 ? nullptr : srqs_.resolve(session_id, qp->srq_identity);
     if (pd == nullptr || send_cq == nullptr || recv_cq == nullptr || pd->qp_count == 0 ||
-        send_cq->qp_references == 0 || (recv_cq != send_cq && recv_cq->qp_references == 0)) {
+        send_cq->qp_references == 0 || (recv_cq != send_cq && recv_cq->qp_references == 0) ||
+        (qp->srq_identity != 0 && (srq == nullptr || srq->qp_references == 0))) {
         return response_for(request, EINVAL);
     }
     --pd->qp_count;
@@ -572,6 +633,9 @@ ControlServiceResult QpService::handle_destroy_qp(ipc::SessionId session_id,
     if (recv_cq != send_cq) {
         --recv_cq->qp_references;
     }
+    if (srq != nullptr) {
+        --srq->qp_references;
+    }
     const std::uint32_t qp_num = qp->qp_num;
     const int status = qps_.erase(session_id, request.value.object_identity);
     if (status == 0) {
@@ -702,11 +766,74 @@ ControlServiceResult QpService::handle_connect_qp(ipc::SessionId session_id,
     return response_for(request);
 }
 
+ControlServiceResult QpService::handle_create_srq(ipc::SessionId session_id,
+                                                  DecodedControlRequest &request) {
+    if (!empty_shape_except_payload(request)) {
+        return response_for(request, EINVAL);
+    }
+    SrqRecord record;
+    const int decode_status = decode_srq_payload(request.value.opaque, &record.rq);
+    if (decode_status != 0) {
+        return response_for(request, decode_status);
+    }
+    PdRecord *const pd = resolve_pd(session_id, request.value.object_identity);
+    const ContextRecord *const context =
+        pd == nullptr ? nullptr : resolve_context(session_id, pd->context_identity);
+    if (context == nullptr || record.rq.max_wr == 0 || record.rq.max_sge == 0) {
+        return response_for(request, EINVAL);
+    }
+    queue::QueueDescriptor descriptor;
+    int queue_status = receive_descriptor(record.rq, &descriptor);
+    if (queue_status == 0) {
+        queue_status = create_ring(*context, descriptor, &record.receive_queue);
+    }
+    ControlServiceResult result = response_for(request);
+    if (queue_status == 0) {
+        queue_status = attach_queue_rings({descriptor}, {&record.receive_queue}, &result);
+    }
+    if (queue_status != 0) {
+        return response_for(request, queue_status);
+    }
+    record.context_identity = pd->context_identity;
+    record.pd_identity = request.value.object_identity;
+    const auto identity = srqs_.insert(session_id, std::move(record));
+    if (!identity.has_value()) {
+        return response_for(request, ENOSPC);
+    }
+    ++pd->srq_count;
+    result.response.object_identity = *identity;
+    return result;
+}
+
+ControlServiceResult QpService::handle_destroy_srq(ipc::SessionId session_id,
+                                                   DecodedControlRequest &request) {
+    if (!empty_shape(request)) {
+        return response_for(request, EINVAL);
+    }
+    SrqRecord *const srq = srqs_.resolve(session_id, request.value.object_identity);
+    if (srq == nullptr) {
+        return response_for(request, EINVAL);
+    }
+    if (srq->qp_references != 0) {
+        return response_for(request, EBUSY);
+    }
+    PdRecord *const pd = resolve_pd(session_id, srq->pd_identity);
+    if (pd == nullptr || pd->srq_count == 0) {
+        return response_for(request, EINVAL);
+    }
+    const int status = srqs_.erase(session_id, request.value.object_identity);
+    if (status == 0) {
+        --pd->srq_count;
+    }
+    return response_for(request, status);
+}
+
 void QpService::on_disconnect(ipc::SessionId session_id) noexcept {
     qps_.for_each_session(session_id, [this](std::uint64_t, const QpRecord &record) {
         qp_num_index_.erase(record.qp_num);
     });
     (void)qps_.erase_session(session_id);
+    (void)srqs_.erase_session(session_id);
     PdMrCqService::on_disconnect(session_id);
 }
 
@@ -714,6 +841,10 @@ std::size_t QpService::qp_count() const noexcept {
     return qps_.size();
 }
 
+std::size_t QpService::srq_count() const noexcept {
+    return srqs_.size();
+}
+
 int QpService::worker_qp_view(std::uint32_t qp_num, WorkerQpView *view) noexcept {
     if (qp_num == 0 || view == nullptr) {
         return EINVAL;
@@ -731,18 +862,45 @@ int QpService::worker_qp_view(std::uint32_t qp_num, WorkerQpView *view) noexcept
     if (send_cq == nullptr || receive_cq == nullptr) {
         return EINVAL;
     }
+    const RqMetadata *rq = &qp->rq;
+    queue::SharedRing *receive_queue = &qp->receive_queue;
+    if (qp->srq_identity != 0) {
+        SrqRecord *const srq = srqs_.resolve(qp->owner_session, qp->srq_identity);
+        if (srq == nullptr) {
+            return EINVAL;
+        }
+        rq = &srq->rq;
+        receive_queue = &srq->receive_queue;
+    }
     *view = {
         qp->owner_session,     qp->pd_identity,          qp->qp_num,
-        qp->peer_qp_num,       qp->sq.max_sge,           qp->rq.max_sge,
-        qp->sq_sig_all,        &qp->send_queue,          &qp->receive_queue,
-        &send_cq->completions, &receive_cq->completions,
+        qp->peer_qp_num,       qp->sq.max_sge,           rq->max_sge,
+        qp->sq_sig_all,        &qp->send_queue,          receive_queue,
+        &send_cq->completions, &receive_cq->completions, qp->timeout,
+        qp->retry_count,       qp->rnr_retry,            qp->min_rnr_timer,
+        &send_cq->moderator,   &receive_cq->moderator,   qp->srq_identity != 0,
+        qp->state,
     };
     return 0;
 }
 
+int QpService::worker_enter_error(std::uint32_t qp_num) noexcept {
+    const auto indexed = qp_num_index_.find(qp_num);
+    if (indexed == qp_num_index_.end()) {
+        return ENOENT;
+    }
+    QpRecord *const qp = qps_.resolve_any(indexed->second);
+    if (qp == nullptr) {
+        return ENOENT;
+    }
+    qp->state = kQpStateErr;
+    return 0;
+}
+
 int client_create_qp(ControlClient &client, std::uint64_t pd_identity,
                      const QpCreateAttributes &attributes, std::uint64_t *qp_identity,
-                     queue::SharedRing *send_queue, queue::SharedRing *receive_queue) {
+                     queue::SharedRing *send_queue, queue::SharedRing *receive_queue,
+                     const RingMapOptions &options) {
     if (pd_identity == 0 || !valid_qp_create_attributes(attributes) || qp_identity == nullptr ||
         send_queue == nullptr || receive_queue == nullptr || send_queue->valid() ||
         receive_queue->valid()) {
@@ -759,47 +917,29 @@ int client_create_qp(ControlClient &client, std::uint64_t pd_identity,
     if (validate_identity(response.value.object_identity, ObjectType::qp) != 0) {
         return EPROTO;
     }
-    if (response.value.fd_indices != std::vector<std::uint32_t>{0, 1} ||
-        response.file_descriptors.size() != 2) {
-        (void)client_destroy_qp(client, response.value.object_identity);
-        return EPROTO;
-    }
+    const bool shared_receive = attributes.srq_identity != 0;
     std::uint32_t send_stride = 0;
-    std::uint32_t receive_stride = 0;
     int status = queue::send_slot_stride(attributes.max_send_sge, &send_stride);
+    std::vector<queue::QueueDescriptor> expected{
+        {queue::QueueKind::send, attributes.max_send_wr, send_stride}};
+    if (status == 0 && !shared_receive) {
+        expected.emplace_back();
+        status = receive_descriptor({attributes.max_recv_wr, attributes.max_recv_sge},
+                                    &expected.back());
+    }
+    std::vector<queue::SharedRing> mapped;
     if (status == 0) {
-        status = queue::receive_slot_stride(attributes.max_recv_sge, &receive_stride);
-    }
-    if (status != 0) {
-        (void)client_destroy_qp(client, response.value.object_identity);
-        return status;
-    }
-    const queue::QueueDescriptor expected_send{queue::QueueKind::send, attributes.max_send_wr,
-                                               send_stride};
-    const queue::QueueDescriptor expected_receive{queue::QueueKind::receive, attributes.max_recv_wr,
-                                                  receive_stride};
-    std::vector<queue::QueueDescriptor> descriptors;
-    const int decode_status = decode_queue_descriptors(response.value.opaque, &descriptors);
-    if (decode_status != 0 || descriptors.size() != 2 || descriptors[0] != expected_send ||
-        descriptors[1] != expected_receive) {
-        (void)client_destroy_qp(client, response.value.object_identity);
-        return decode_status == EPROTONOSUPPORT ? decode_status : EPROTO;
-    }
-    queue::SharedRing mapped_send;
-    queue::SharedRing mapped_receive;
-    status =
-        queue::map_shared_ring(response.file_descriptors[0].get(), expected_send, &mapped_send);
-    if (status == 0) {
-        status = queue::map_shared_ring(response.file_descriptors[1].get(), expected_receive,
-                                        &mapped_receive);
+        status = map_queue_rings(response, expected, options, &mapped);
     }
     if (status != 0) {
         (void)client_destroy_qp(client, response.value.object_identity);
         return status;
     }
     *qp_identity = response.value.object_identity;
-    *send_queue = std::move(mapped_send);
-    *receive_queue = std::move(mapped_receive);
+    *send_queue = std::move(mapped[0]);
+    if (!shared_receive) {
+        *receive_queue = std::move(mapped[1]);
+    }
     return 0;
 }
 
@@ -879,4 +1019,43 @@ int client_connect_qp(ControlClient &client, std::uint64_t qp_identity, std::uin
                                                             attr_mask));
 }
 
+int client_create_srq(ControlClient &client, std::uint64_t pd_identity, std::uint32_t max_wr,
+                      std::uint32_t max_sge, std::uint64_t *srq_identity,
+                      queue::SharedRing *receive_queue, const RingMapOptions &options) {
+    if (pd_identity == 0 || max_wr == 0 || max_sge == 0 || srq_identity == nullptr ||
+        receive_queue == nullptr || receive_queue->valid()) {
+        return EINVAL;
+    }
+    DecodedControlResponse response;
+    const int call_status =
+        client.call(make_create_srq_request(pd_identity, max_wr, max_sge), &response);
+    if (call_status != 0) {
+        return call_status;
+    }
+    if (response.value.status != 0) {
+        return response.value.status;
+    }
+    if (validate_identity(response.value.object_identity, ObjectType::srq) != 0) {
+        return EPROTO;
+    }
+    queue::QueueDescriptor expected;
+    int status = receive_descriptor({max_wr, max_sge}, &expected);
+    std::vector<queue::SharedRing> mapped;
+    if (status == 0) {
+        status = map_queue_rings(response, {expected}, options, &mapped);
+    }
+    if (status != 0) {
+        (void)client_destroy_srq(client, response.value.object_identity);
+        return status;
+    }
+    *srq_identity = response.value.object_identity;
+    *receive_queue = std::move(mapped[0]);
+    return 0;
+}
+
+int client_destroy_srq(ControlClient &client, std::uint64_t srq_identity) {
+    return srq_identity == 0 ? EINVAL
+                             : call_destroy(client, make_destroy_srq_request(srq_identity));
+}
+
 }  // namespace ugdr::control
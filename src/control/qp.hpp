@@ -38,6 +38,7 @@ struct QpCreateAttributes {
     std::uint32_t max_recv_sge = 0;
     std::uint32_t qp_type = 0;
     std::uint32_t sq_sig_all = 0;
+    std::uint64_t srq_identity = 0;
 
     bool operator==(const QpCreateAttributes &) const = default;
 };
@@ -78,6 +79,7 @@ struct QpRecord {
     std::uint64_t pd_identity = 0;
     std::uint64_t send_cq_identity = 0;
     std::uint64_t recv_cq_identity = 0;
+    std::uint64_t srq_identity = 0;
     SqMetadata sq;
     RqMetadata rq;
     std::uint32_t qp_type = 0;
@@ -95,6 +97,16 @@ struct QpRecord {
     queue::SharedRing receive_queue;
 };
 
+// An SRQ replaces the receive rings of every QP attached to it. The worker claims a WQE from it
+// as soon as the first WRITE_WITH_IMM chunk arrives, so QPs never hold a slot across calls.
+struct SrqRecord {
+    std::uint64_t context_identity = 0;
+    std::uint64_t pd_identity = 0;
+    RqMetadata rq;
+    std::size_t qp_references = 0;
+    queue::SharedRing receive_queue;
+};
+
 struct WorkerQpView {
     ipc::SessionId session_id = 0;
     std::uint64_t pd_identity = 0;
@@ -107,6 +119,14 @@ struct WorkerQpView {
     queue::SharedRing *receive_queue = nullptr;
     queue::SharedRing *send_cq = nullptr;
     queue::SharedRing *receive_cq = nullptr;
+    std::uint8_t timeout = 0;
+    std::uint8_t retry_count = 0;
+    std::uint8_t rnr_retry = 0;
+    std::uint8_t min_rnr_timer = 0;
+    queue::CompletionModerator *send_cq_moderator = nullptr;
+    queue::CompletionModerator *receive_cq_moderator = nullptr;
+    bool shared_receive_queue = false;
+    std::uint32_t state = kQpStateReset;
 };
 
 bool valid_qp_create_attributes(const QpCreateAttributes &attributes) noexcept;
@@ -123,6 +143,9 @@ UgdrControlRequest make_modify_qp_request(std::uint64_t qp_identity, const QpAtt
 UgdrControlRequest make_query_qp_conn_info_request(std::uint64_t qp_identity);
 UgdrControlRequest make_connect_qp_request(std::uint64_t qp_identity, std::uint32_t remote_qp_num,
                                            const QpAttributes &attributes, std::uint32_t attr_mask);
+UgdrControlRequest make_create_srq_request(std::uint64_t pd_identity, std::uint32_t max_wr,
+                                           std::uint32_t max_sge);
+UgdrControlRequest make_destroy_srq_request(std::uint64_t srq_identity);
 
 class QpService final : public PdMrCqService {
   public:
@@ -133,7 +156,10 @@ class QpService final : public PdMrCqService {
     void on_disconnect(ipc::SessionId session_id) noexcept override;
 
     [[nodiscard]] std::size_t qp_count() const noexcept;
+    [[nodiscard]] std::size_t srq_count() const noexcept;
     int worker_qp_view(std::uint32_t qp_num, WorkerQpView *view) noexcept;
+    // Moves the QP to ERR after the worker exhausts its retries; ERR is terminal.
+    int worker_enter_error(std::uint32_t qp_num) noexcept;
 
   private:
     ControlServiceResult handle_create_qp(ipc::SessionId session_id,
@@ -147,15 +173,21 @@ class QpService final : public PdMrCqService {
                                                    DecodedControlRequest &request);
     ControlServiceResult handle_connect_qp(ipc::SessionId session_id,
                                            DecodedControlRequest &request);
+    ControlServiceResult handle_create_srq(ipc::SessionId session_id,
+                                           DecodedControlRequest &request);
+    ControlServiceResult handle_destroy_srq(ipc::SessionId session_id,
+                                            DecodedControlRequest &request);
 
     GenerationRegistry<QpRecord, ObjectType::qp> qps_;
+    GenerationRegistry<SrqRecord, ObjectType::srq> srqs_;
     std::unordered_map<std::uint32_t, std::uint64_t> qp_num_index_;
     std::uint32_t next_qp_num_ = 1;
 };
 
 int client_create_qp(ControlClient &client, std::uint64_t pd_identity,
                      const QpCreateAttributes &attributes, std::uint64_t *qp_identity,
-                     queue::SharedRing *send_queue, queue::SharedRing *receive_queue);
+                     queue::SharedRing *send_queue, queue::SharedRing *receive_queue,
+                     const RingMapOptions &options = {});
 int client_create_qp(ControlClient &client, std::uint64_t pd_identity,
                      const QpCreateAttributes &attributes, std::uint64_t *qp_identity);
 int client_destroy_qp(ControlClient &client, std::uint64_t qp_identity);
@@ -167,5 +199,9 @@ int client_query_qp_conn_info(ControlClient &client, std::uint64_t qp_identity,
                               std::uint32_t *qp_num);
 int client_connect_qp(ControlClient &client, std::uint64_t qp_identity, std::uint32_t remote_qp_num,
                       const QpAttributes &attributes, std::uint32_t attr_mask);
+int client_create_srq(ControlClient &client, std::uint64_t pd_identity, std::uint32_t max_wr,
+                      std::uint32_t max_sge, std::uint64_t *srq_identity,
+                      queue::SharedRing *receive_queue, const RingMapOptions &options = {});
+int client_destroy_srq(ControlClient &client, std::uint64_t srq_identity);
 
 }  // namespace ugdr::control
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "queue/descriptors.hpp"
 #include "queue/shared_ring.hpp"
 
 #include <arpa/inet.h>
@@ -13,33 +14,49 @@
 namespace ugdr::control {
 
 constexpr std::uint16_t kQueueDescriptorPayloadVersion = 1;
+// Version 2 follows each descriptor with the ring's offset in the context's ring arena.
+constexpr std::uint16_t kArenaQueueDescriptorPayloadVersion = 2;
 constexpr std::size_t kQueueDescriptorWireSize = 16;
+constexpr std::size_t kArenaOffsetWireSize = 8;
 
 inline int encode_queue_descriptors(const std::vector<queue::QueueDescriptor> &descriptors,
-                                    std::vector<std::byte> *bytes) {
-    if (bytes == nullptr || descriptors.empty() || descriptors.size() > UINT16_MAX) {
+                                    std::vector<std::byte> *bytes,
+                                    const std::vector<std::uint64_t> *offsets = nullptr) {
+    if (bytes == nullptr || descriptors.empty() || descriptors.size() > UINT16_MAX ||
+        (offsets != nullptr && offsets->size() != descriptors.size())) {
         return EINVAL;
     }
+    const std::size_t wire_size =
+        kQueueDescriptorWireSize + (offsets != nullptr ? kArenaOffsetWireSize : 0);
     std::vector<std::byte> encoded;
-    encoded.reserve(4 + descriptors.size() * kQueueDescriptorWireSize);
+    encoded.reserve(4 + descriptors.size() * wire_size);
     const auto append = [&encoded](auto value) {
         const auto *begin = reinterpret_cast<const std::byte *>(&value);
         encoded.insert(encoded.end(), begin, begin + sizeof(value));
     };
-    append(htons(kQueueDescriptorPayloadVersion));
+    append(htons(offsets != nullptr ? kArenaQueueDescriptorPayloadVersion
+                                    : kQueueDescriptorPayloadVersion));
     append(htons(static_cast<std::uint16_t>(descriptors.size())));
-    for (const queue::QueueDescriptor &descriptor : descriptors) {
+    for (std::size_t index = 0; index < descriptors.size(); ++index) {
+        const queue::QueueDescriptor &descriptor = descriptors[index];
         append(htonl(static_cast<std::uint32_t>(descriptor.kind)));
         append(htonl(descriptor.capacity));
         append(htonl(descriptor.slot_stride));
-        append(std::uint32_t{0});
+        append(htonl(static_cast<std::uint32_t>(descriptor.ownership)));
+        if (offsets != nullptr) {
+            append(htonl(static_cast<std::uint32_t>((*offsets)[index] >> 32U)));
+            append(htonl(static_cast<std::uint32_t>((*offsets)[index])));
+        }
     }
     *bytes = std::move(encoded);
     return 0;
 }
 
+// offsets receives the arena offsets of a version 2 payload and is cleared for version 1; a
+// version 2 payload is rejected when the caller has no arena to resolve offsets against.
 inline int decode_queue_descriptors(const std::vector<std::byte> &bytes,
-                                    std::vector<queue::QueueDescriptor> *descriptors) {
+                                    std::vector<queue::QueueDescriptor> *descriptors,
+                                    std::vector<std::uint64_t> *offsets = nullptr) {
     if (descriptors == nullptr || bytes.size() < 4) {
         return EPROTO;
     }
@@ -57,35 +74,61 @@ inline int decode_queue_descriptors(const std::vector<std::byte> &bytes,
     if (!read(&version) || !read(&count)) {
         return EPROTO;
     }
-    if (ntohs(version) != kQueueDescriptorPayloadVersion) {
+    version = ntohs(version);
+    if (version != kQueueDescriptorPayloadVersion &&
+        version != kArenaQueueDescriptorPayloadVersion) {
         return EPROTONOSUPPORT;
     }
+    const bool in_arena = version == kArenaQueueDescriptorPayloadVersion;
+    if (in_arena && offsets == nullptr) {
+        return EPROTO;
+    }
+    const std::size_t wire_size = kQueueDescriptorWireSize + (in_arena ? kArenaOffsetWireSize : 0);
     count = ntohs(count);
-    if (count == 0 ||
-        bytes.size() != 4 + static_cast<std::size_t>(count) * kQueueDescriptorWireSize) {
+    if (count == 0 || bytes.size() != 4 + static_cast<std::size_t>(count) * wire_size) {
         return EPROTO;
     }
     std::vector<queue::QueueDescriptor> decoded;
+    std::vector<std::uint64_t> decoded_offsets;
     decoded.reserve(count);
     for (std::uint16_t index = 0; index < count; ++index) {
         std::uint32_t kind = 0;
         std::uint32_t capacity = 0;
         std::uint32_t stride = 0;
-        std::uint32_t reserved = 0;
-        if (!read(&kind) || !read(&capacity) || !read(&stride) || !read(&reserved)) {
+        std::uint32_t ownership = 0;
+        if (!read(&kind) || !read(&capacity) || !read(&stride) || !read(&ownership)) {
             return EPROTO;
         }
         kind = ntohl(kind);
         capacity = ntohl(capacity);
         stride = ntohl(stride);
-        if (reserved != 0 || kind < static_cast<std::uint32_t>(queue::QueueKind::send) ||
+        ownership = ntohl(ownership);
+        if (ownership > static_cast<std::uint32_t>(queue::RingOwnership::phase) ||
+            kind < static_cast<std::uint32_t>(queue::QueueKind::send) ||
             kind > static_cast<std::uint32_t>(queue::QueueKind::completion) || capacity == 0 ||
-            stride == 0 || stride % queue::kSharedRingCacheLine != 0) {
+            stride == 0 ||
+            (stride % queue::kSharedRingCacheLine != 0 &&
+             (kind != static_cast<std::uint32_t>(queue::QueueKind::completion) ||
+              stride != queue::compact_completion_slot_stride())) ||
+            (ownership != 0 && (kind != static_cast<std::uint32_t>(queue::QueueKind::completion) ||
+                                stride % queue::kSharedRingCacheLine != 0))) {
             return EPROTO;
         }
-        decoded.push_back({static_cast<queue::QueueKind>(kind), capacity, stride});
+        decoded.push_back({static_cast<queue::QueueKind>(kind), capacity, stride,
+                           static_cast<queue::RingOwnership>(ownership)});
+        if (in_arena) {
+            std::uint32_t high = 0;
+            std::uint32_t low = 0;
+            if (!read(&high) || !read(&low)) {
+                return EPROTO;
+            }
+            decoded_offsets.push_back(static_cast<std::uint64_t>(ntohl(high)) << 32U | ntohl(low));
+        }
     }
     *descriptors = std::move(decoded);
+    if (offsets != nullptr) {
+        *offsets = std::move(decoded_offsets);
+    }
     return 0;
 }
 
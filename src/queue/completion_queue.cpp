@@ -1,5 +1,6 @@
 #include "queue/completion_queue.hpp"
 
+#include <atomic>
 #include <cerrno>
 #include <cstddef>
 #include <cstring>
@@ -7,29 +8,76 @@
 namespace ugdr::queue {
 namespace {
 
-void copy_entries(const MutableSlotSpan &span, const CompletionEntry *entries, std::size_t *offset,
-                  std::uint32_t slot_stride) noexcept {
+constexpr std::size_t kCompletionFlagsOffset = offsetof(CompletionEntry, flags);
+
+static_assert(kCompletionFlagsOffset + sizeof(std::uint32_t) == sizeof(CompletionEntry));
+static_assert(std::atomic_ref<std::uint32_t>::is_always_lock_free);
+
+std::uint32_t owner_flag(const QueueDescriptor &descriptor, std::uint64_t position) noexcept {
+    return ((position / descriptor.capacity) & 1U) == 0 ? kCompletionOwnerFlag : 0;
+}
+
+// The owner bit is stored last with release semantics so a consumer that observes it also
+// observes the rest of the entry.
+void store_entry(void *slot, const CompletionEntry &entry, std::uint32_t owner) noexcept {
+    auto *bytes = static_cast<std::byte *>(slot);
+    std::memcpy(bytes, &entry, kCompletionFlagsOffset);
+    std::atomic_ref<std::uint32_t> flags(
+        *reinterpret_cast<std::uint32_t *>(bytes + kCompletionFlagsOffset));
+    flags.store((entry.flags & ~kCompletionOwnerFlag) | owner, std::memory_order_release);
+}
+
+bool owned_entry(const void *slot, std::uint32_t owner) noexcept {
+    auto *bytes = static_cast<std::byte *>(const_cast<void *>(slot));
+    std::atomic_ref<std::uint32_t> flags(
+        *reinterpret_cast<std::uint32_t *>(bytes + kCompletionFlagsOffset));
+    return (flags.load(std::memory_order_acquire) & kCompletionOwnerFlag) == owner;
+}
+
+// A span never crosses the end of the ring, so every slot in it shares one owner value.
+void copy_entries(const QueueDescriptor &descriptor, const MutableSlotSpan &span,
+                  const CompletionEntry *entries, std::size_t *offset,
+                  std::uint32_t owner) noexcept {
     auto *slots = static_cast<std::byte *>(span.data);
+    const bool compact = compact_completions(descriptor);
     for (std::uint32_t index = 0; index < span.count; ++index) {
-        std::memcpy(slots + static_cast<std::size_t>(index) * slot_stride, entries + *offset,
-                    sizeof(CompletionEntry));
+        void *slot = slots + static_cast<std::size_t>(index) * descriptor.slot_stride;
+        if (compact) {
+            store_entry(slot, entries[*offset], owner);
+        } else {
+            std::memcpy(slot, entries + *offset, sizeof(CompletionEntry));
+        }
         ++*offset;
     }
 }
 
-}  // namespace
+bool valid_completion_ring(const SharedRing &ring) noexcept {
+    const QueueDescriptor &descriptor = ring.descriptor();
+    return ring.valid() && descriptor.kind == QueueKind::completion &&
+           (descriptor.slot_stride == completion_slot_stride() || compact_completions(descriptor));
+}
 
-int produce_completions(SharedRing &ring, const CompletionEntry *entries,
-                        int num_entries) noexcept {
+std::uint32_t owned_prefix(const QueueDescriptor &descriptor, const ConstSlotSpan &span,
+                           std::uint32_t owner) noexcept {
+    const auto *slots = static_cast<const std::byte *>(span.data);
+    std::uint32_t owned = 0;
+    while (owned < span.count &&
+           owned_entry(slots + static_cast<std::size_t>(owned) * descriptor.slot_stride, owner)) {
+        ++owned;
+    }
+    return owned;
+}
+
+template <typename Commit>
+int produce(SharedRing &ring, const CompletionEntry *entries, int num_entries,
+            Commit commit) noexcept {
     if (num_entries < 0 || (num_entries > 0 && entries == nullptr)) {
         return -EINVAL;
     }
     if (num_entries == 0) {
         return 0;
     }
-    const QueueDescriptor &descriptor = ring.descriptor();
-    if (!ring.valid() || descriptor.kind != QueueKind::completion ||
-        descriptor.slot_stride != completion_slot_stride()) {
+    if (!valid_completion_ring(ring)) {
         return -EINVAL;
     }
 
@@ -44,10 +92,152 @@ int produce_completions(SharedRing &ring, const CompletionEntry *entries,
     }
 
     std::size_t offset = 0;
-    copy_entries(batch.first, entries, &offset, descriptor.slot_stride);
-    copy_entries(batch.second, entries, &offset, descriptor.slot_stride);
-    const int publish_status = ring.producer_publish(batch.count);
-    return publish_status == 0 ? static_cast<int>(batch.count) : -publish_status;
+    const std::uint32_t owner = owner_flag(ring.descriptor(), ring.producer_position());
+    copy_entries(ring.descriptor(), batch.first, entries, &offset, owner);
+    copy_entries(ring.descriptor(), batch.second, entries, &offset, owner ^ kCompletionOwnerFlag);
+    const int commit_status = commit(batch.count);
+    return commit_status == 0 ? static_cast<int>(batch.count) : -commit_status;
+}
+
+}  // namespace
+
+void CompletionModerator::configure(const CompletionModeration &moderation) noexcept {
+    moderation_ = moderation;
+    deadline_ = {};
+}
+
+int CompletionModerator::commit(SharedRing &ring, std::uint32_t count) noexcept {
+    if (compact_completions(ring.descriptor())) {
+        return ring.producer_stage(count);
+    }
+    if (moderation_.count <= 1) {
+        return ring.producer_publish(count);
+    }
+    const bool idle = ring.producer_staged() == 0;
+    const int status = ring.producer_stage(count);
+    if (status != 0 || count == 0) {
+        return status;
+    }
+    if (idle) {
+        deadline_ = Clock::now() + std::chrono::microseconds(moderation_.period_us);
+    }
+    if (ring.producer_staged() >= moderation_.count) {
+        (void)ring.producer_flush();
+    }
+    return 0;
+}
+
+bool CompletionModerator::flush_if_due(SharedRing &ring) noexcept {
+    if (compact_completions(ring.descriptor()) || ring.producer_staged() == 0 ||
+        Clock::now() < deadline_) {
+        return false;
+    }
+    return ring.producer_flush() != 0;
+}
+
+int produce_completions(SharedRing &ring, const CompletionEntry *entries,
+                        int num_entries) noexcept {
+    return produce(ring, entries, num_entries, [&ring](std::uint32_t count) {
+        return compact_completions(ring.descriptor()) ? ring.producer_stage(count)
+                                                      : ring.producer_publish(count);
+    });
+}
+
+int produce_completions(SharedRing &ring, CompletionModerator &moderator,
+                        const CompletionEntry *entries, int num_entries) noexcept {
+    return produce(ring, entries, num_entries, [&ring, &moderator](std::uint32_t count) {
+        return moderator.commit(ring, count);
+    });
+}
+
+int write_completion(SharedRing &ring, void *slot, const CompletionEntry &entry,
+                     std::uint32_t reserved_index) noexcept {
+    if (slot == nullptr || !valid_completion_ring(ring)) {
+        return EINVAL;
+    }
+    if (compact_completions(ring.descriptor())) {
+        store_entry(slot, entry,
+                    owner_flag(ring.descriptor(), ring.producer_position() + reserved_index));
+    } else {
+        std::memcpy(slot, &entry, sizeof(entry));
+    }
+    return 0;
+}
+
+int peek_completions(SharedRing &ring, std::uint32_t max_count, ConstSlotBatch *batch) noexcept {
+    if (!valid_completion_ring(ring)) {
+        return EINVAL;
+    }
+    const QueueDescriptor &descriptor = ring.descriptor();
+    if (!compact_completions(descriptor)) {
+        return ring.consumer_peek(max_count, batch);
+    }
+    const int view_status = ring.consumer_view(max_count, batch);
+    if (view_status != 0) {
+        return view_status;
+    }
+    const std::uint32_t owner = owner_flag(descriptor, ring.consumer_position());
+    const std::uint32_t first_owned = owned_prefix(descriptor, batch->first, owner);
+    std::uint32_t second_owned = 0;
+    if (first_owned == batch->first.count && batch->second.count != 0) {
+        second_owned = owned_prefix(descriptor, batch->second, owner ^ kCompletionOwnerFlag);
+    }
+    batch->first.count = first_owned;
+    batch->second =
+        second_owned == 0 ? ConstSlotSpan{} : ConstSlotSpan{batch->second.data, second_owned};
+    batch->count = first_owned + second_owned;
+    if (batch->count == 0) {
+        (void)ring.consumer_release(0);
+        return EAGAIN;
+    }
+    return 0;
+}
+
+int CompletionReader::start(SharedRing &ring) noexcept {
+    if (ring_ != nullptr) {
+        return EINVAL;
+    }
+    const QueueDescriptor &descriptor = ring.descriptor();
+    const int peek_status = peek_completions(ring, descriptor.capacity, &batch_);
+    if (peek_status != 0) {
+        return peek_status == EAGAIN ? ENOENT : peek_status;
+    }
+    ring_ = &ring;
+    cursor_ = static_cast<const std::byte *>(batch_.first.data);
+    span_left_ = batch_.first.count;
+    stride_ = descriptor.slot_stride;
+    visited_ = 0;
+    advance();
+    return 0;
+}
+
+int CompletionReader::next() noexcept {
+    if (ring_ == nullptr || visited_ == batch_.count) {
+        return ENOENT;
+    }
+    advance();
+    return 0;
+}
+
+int CompletionReader::end() noexcept {
+    if (ring_ == nullptr) {
+        return EINVAL;
+    }
+    const int status = ring_->consumer_release(visited_);
+    ring_ = nullptr;
+    current_ = nullptr;
+    return status;
+}
+
+void CompletionReader::advance() noexcept {
+    if (span_left_ == 0) {
+        cursor_ = static_cast<const std::byte *>(batch_.second.data);
+        span_left_ = batch_.second.count;
+    }
+    current_ = reinterpret_cast<const CompletionEntry *>(cursor_);
+    cursor_ += stride_;
+    --span_left_;
+    ++visited_;
 }
 
 }  // namespace ugdr::queue
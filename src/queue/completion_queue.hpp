@@ -3,8 +3,79 @@
 #include "queue/descriptors.hpp"
 #include "queue/shared_ring.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
 namespace ugdr::queue {
 
+struct CompletionModeration {
+    std::uint16_t count = 0;
+    std::uint16_t period_us = 0;
+
+    bool operator==(const CompletionModeration &) const = default;
+};
+
+// Coalesces completion publishes for one CQ. Entries are staged on the ring and become visible
+// once count of them are pending or period_us has passed since the oldest one was staged; a
+// count of 0 or 1 publishes every entry immediately.
+class CompletionModerator {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    void configure(const CompletionModeration &moderation) noexcept;
+    [[nodiscard]] const CompletionModeration &moderation() const noexcept {
+        return moderation_;
+    }
+    int commit(SharedRing &ring, std::uint32_t count) noexcept;
+    bool flush_if_due(SharedRing &ring) noexcept;
+
+  private:
+    CompletionModeration moderation_{};
+    Clock::time_point deadline_{};
+};
+
+inline bool compact_completions(const QueueDescriptor &descriptor) noexcept {
+    return descriptor.kind == QueueKind::completion &&
+           descriptor.slot_stride == compact_completion_slot_stride();
+}
+
+// Compact CQs never publish the shared tail: each entry becomes visible through its owner bit,
+// so producers only stage and consumers find the end of the batch by scanning slots.
 int produce_completions(SharedRing &ring, const CompletionEntry *entries, int num_entries) noexcept;
+int produce_completions(SharedRing &ring, CompletionModerator &moderator,
+                        const CompletionEntry *entries, int num_entries) noexcept;
+// Fills the slot at reserved_index of the current producer reservation before it is committed.
+int write_completion(SharedRing &ring, void *slot, const CompletionEntry &entry,
+                     std::uint32_t reserved_index = 0) noexcept;
+// consumer_peek for either CQ format. Callers mask kCompletionOwnerFlag out of entry flags.
+int peek_completions(SharedRing &ring, std::uint32_t max_count, ConstSlotBatch *batch) noexcept;
+
+// Walks the published completions in place. start and next return ENOENT when nothing is left;
+// end releases every entry visited so far with a single consumer_release.
+class CompletionReader {
+  public:
+    int start(SharedRing &ring) noexcept;
+    int next() noexcept;
+    int end() noexcept;
+
+    [[nodiscard]] bool active() const noexcept {
+        return ring_ != nullptr;
+    }
+    [[nodiscard]] const CompletionEntry &current() const noexcept {
+        return *current_;
+    }
+
+  private:
+    void advance() noexcept;
+
+    SharedRing *ring_ = nullptr;
+    ConstSlotBatch batch_{};
+    const std::byte *cursor_ = nullptr;
+    std::uint32_t span_left_ = 0;
+    std::uint32_t stride_ = 0;
+    std::uint32_t visited_ = 0;
+    const CompletionEntry *current_ = nullptr;
+};
 
 }  // namespace ugdr::queue
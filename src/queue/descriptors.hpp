@@ -80,4 +80,14 @@ inline constexpr std::uint32_t completion_slot_stride() noexcept {
     return kSlotAlignment;
 }
 
+// Compact CQs pack two entries per cache line and mark ownership in the top bit of flags, which
+// the producer sets on even laps of the ring and clears on odd ones.
+constexpr std::uint32_t kCompletionOwnerFlag = UINT32_C(1) << 31U;
+
+inline constexpr std::uint32_t compact_completion_slot_stride() noexcept {
+    return sizeof(CompletionEntry);
+}
+
+static_assert(kSlotAlignment % compact_completion_slot_stride() == 0);
+
 }  // namespace ugdr::queue
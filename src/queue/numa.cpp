@@ -0,0 +1,162 @@
+#include "queue/numa.hpp"
+
+#include <linux/mempolicy.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ugdr::queue {
+namespace {
+
+constexpr int kMaxNumaNodes = 1024;
+
+// Reads a small sysfs attribute into a NUL-terminated buffer.
+int read_attribute(const std::string &path, char *buffer, std::size_t size) noexcept {
+    const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        return errno;
+    }
+    const ssize_t count = ::read(descriptor, buffer, size - 1);
+    const int status = count < 0 ? errno : 0;
+    (void)::close(descriptor);
+    if (status != 0) {
+        return status;
+    }
+    buffer[count] = '\0';
+    return 0;
+}
+
+int read_cpu_list(const std::string &path, cpu_set_t *cpus) noexcept {
+    char buffer[4096];
+    const int status = read_attribute(path, buffer, sizeof(buffer));
+    if (status != 0) {
+        return status;
+    }
+    try {
+        return parse_cpu_list(buffer, cpus);
+    } catch (...) {
+        return ENOMEM;
+    }
+}
+
+}  // namespace
+
+int numa_node_count() noexcept {
+    cpu_set_t nodes;
+    if (read_cpu_list("/sys/devices/system/node/online", &nodes) != 0) {
+        return 1;
+    }
+    const int count = CPU_COUNT(&nodes);
+    return count > 0 ? count : 1;
+}
+
+int pci_device_numa_node(const std::string &pci_address, int *node) noexcept {
+    if (node == nullptr || pci_address.empty() || pci_address.find('/') != std::string::npos ||
+        pci_address.front() == '.') {
+        return EINVAL;
+    }
+    char buffer[32];
+    int status = 0;
+    try {
+        status = read_attribute("/sys/bus/pci/devices/" + pci_address + "/numa_node", buffer,
+                                sizeof(buffer));
+    } catch (...) {
+        return ENOMEM;
+    }
+    if (status != 0) {
+        return status;
+    }
+    char *end = nullptr;
+    const long value = std::strtol(buffer, &end, 10);
+    if (end == buffer || (*end != '\0' && *end != '\n') || value >= kMaxNumaNodes) {
+        return EPROTO;
+    }
+    *node = value < 0 ? kNoNumaNode : static_cast<int>(value);
+    return 0;
+}
+
+int parse_cpu_list(const std::string &list, cpu_set_t *cpus) noexcept {
+    if (cpus == nullptr) {
+        return EINVAL;
+    }
+    CPU_ZERO(cpus);
+    const char *cursor = list.c_str();
+    bool any = false;
+    while (*cursor != '\0' && *cursor != '\n') {
+        char *end = nullptr;
+        const unsigned long first = std::strtoul(cursor, &end, 10);
+        unsigned long last = first;
+        if (end == cursor) {
+            return EINVAL;
+        }
+        if (*end == '-') {
+            cursor = end + 1;
+            last = std::strtoul(cursor, &end, 10);
+            if (end == cursor) {
+                return EINVAL;
+            }
+        }
+        if (last < first || last >= CPU_SETSIZE) {
+            return EINVAL;
+        }
+        for (unsigned long cpu = first; cpu <= last; ++cpu) {
+            CPU_SET(cpu, cpus);
+        }
+        if (*end != ',' && *end != '\0' && *end != '\n') {
+            return EINVAL;
+        }
+        any = true;
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return any ? 0 : EINVAL;
+}
+
+int bind_memory_to_numa_node(void *address, std::size_t bytes, int node) noexcept {
+    if (node == kNoNumaNode) {
+        return 0;
+    }
+    if (address == nullptr || bytes == 0 || node < 0 || node >= kMaxNumaNodes) {
+        return EINVAL;
+    }
+#ifdef SYS_mbind
+    constexpr std::size_t word_bits = sizeof(unsigned long) * CHAR_BIT;
+    const auto bit = static_cast<std::size_t>(node);
+    unsigned long mask[kMaxNumaNodes / word_bits] = {};
+    mask[bit / word_bits] = 1UL << (bit % word_bits);
+    // Preferred rather than bound, so a full node spills over instead of failing the fault.
+    if (syscall(SYS_mbind, address, bytes, MPOL_PREFERRED, mask, kMaxNumaNodes + 1, 0) != 0) {
+        return errno;
+    }
+    return 0;
+#else
+    return ENOSYS;
+#endif
+}
+
+int pin_thread_to_numa_node(int node) noexcept {
+    if (node == kNoNumaNode) {
+        return 0;
+    }
+    if (node < 0 || node >= kMaxNumaNodes) {
+        return EINVAL;
+    }
+    cpu_set_t cpus;
+    int status = 0;
+    try {
+        status = read_cpu_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist",
+                               &cpus);
+    } catch (...) {
+        return ENOMEM;
+    }
+    if (status != 0) {
+        return status;
+    }
+    return sched_setaffinity(0, sizeof(cpus), &cpus) == 0 ? 0 : errno;
+}
+
+}  // namespace ugdr::queue
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <sched.h>
+
+#include <cstddef>
+#include <string>
+
+namespace ugdr::queue {
+
+// No affinity: memory and threads stay wherever the kernel puts them.
+constexpr int kNoNumaNode = -1;
+
+// Number of online NUMA nodes; 1 on single-node hosts and kernels without NUMA.
+int numa_node_count() noexcept;
+
+// Reads the node sysfs reports for a PCI device such as "0000:3b:00.0". A device without
+// affinity yields kNoNumaNode.
+int pci_device_numa_node(const std::string &pci_address, int *node) noexcept;
+
+// Parses a sysfs cpulist such as "0-3,8,10-11".
+int parse_cpu_list(const std::string &list, cpu_set_t *cpus) noexcept;
+
+// Prefers node for pages of [address, address + bytes) that are not yet allocated. On a memfd
+// mapping the policy is shared, so it also holds for pages another process faults in later.
+int bind_memory_to_numa_node(void *address, std::size_t bytes, int node) noexcept;
+
+// Restricts the calling thread to the CPUs of node. kNoNumaNode leaves the thread alone.
+int pin_thread_to_numa_node(int node) noexcept;
+
+}  // namespace ugdr::queue
@@ -0,0 +1,207 @@
+#include "queue/ring_arena.hpp"
+
+#include "queue/numa.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ugdr::queue {
+namespace {
+
+int page_size(std::size_t *value) noexcept {
+    const long result = sysconf(_SC_PAGESIZE);
+    if (result <= 0) {
+        return errno == 0 ? EINVAL : errno;
+    }
+    *value = static_cast<std::size_t>(result);
+    return 0;
+}
+
+int create_arena_memfd() noexcept {
+#ifdef SYS_memfd_create
+    return static_cast<int>(
+        syscall(SYS_memfd_create, "ugdr-ring-arena", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+}  // namespace
+
+SharedRingArena::SharedRingArena(void *mapping, std::size_t size, int descriptor) noexcept
+    : mapping_(mapping), size_(size), descriptor_(descriptor) {
+}
+
+SharedRingArena::~SharedRingArena() {
+    (void)munmap(mapping_, size_);
+    if (descriptor_ >= 0) {
+        (void)::close(descriptor_);
+    }
+}
+
+int SharedRingArena::create(std::size_t bytes, std::shared_ptr<SharedRingArena> *arena,
+                            int numa_node) noexcept {
+    std::size_t page = 0;
+    int status = page_size(&page);
+    if (status != 0) {
+        return status;
+    }
+    if (arena == nullptr || bytes == 0 || bytes > kMaxRingArenaBytes) {
+        return EINVAL;
+    }
+    const std::size_t size = (bytes + page - 1) / page * page;
+    const int descriptor = create_arena_memfd();
+    if (descriptor < 0) {
+        return errno;
+    }
+    void *mapping = MAP_FAILED;
+    if (ftruncate(descriptor, static_cast<off_t>(size)) == 0) {
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    }
+    if (mapping == MAP_FAILED ||
+        fcntl(descriptor, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        status = errno;
+        if (mapping != MAP_FAILED) {
+            (void)munmap(mapping, size);
+        }
+        (void)::close(descriptor);
+        return status;
+    }
+    (void)bind_memory_to_numa_node(mapping, size, numa_node);
+    auto *const created = new (std::nothrow) SharedRingArena(mapping, size, descriptor);
+    if (created == nullptr) {
+        (void)munmap(mapping, size);
+        (void)::close(descriptor);
+        return ENOMEM;
+    }
+    try {
+        arena->reset(created);
+        (*arena)->free_ranges_.emplace(0, size);
+    } catch (...) {
+        arena->reset();
+        return ENOMEM;
+    }
+    return 0;
+}
+
+int SharedRingArena::map(int descriptor, std::shared_ptr<SharedRingArena> *arena) noexcept {
+    std::size_t page = 0;
+    int status = page_size(&page);
+    if (status != 0) {
+        return status;
+    }
+    if (descriptor < 0 || arena == nullptr) {
+        return EINVAL;
+    }
+    struct stat status_buffer {};
+    if (fstat(descriptor, &status_buffer) != 0) {
+        return errno;
+    }
+    if (status_buffer.st_size <= 0 ||
+        static_cast<std::uintmax_t>(status_buffer.st_size) > kMaxRingArenaBytes ||
+        static_cast<std::size_t>(status_buffer.st_size) % page != 0) {
+        return EPROTO;
+    }
+    const auto size = static_cast<std::size_t>(status_buffer.st_size);
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    if (mapping == MAP_FAILED) {
+        return errno;
+    }
+    auto *const mapped = new (std::nothrow) SharedRingArena(mapping, size, -1);
+    if (mapped == nullptr) {
+        (void)munmap(mapping, size);
+        return ENOMEM;
+    }
+    try {
+        arena->reset(mapped);
+    } catch (...) {
+        return ENOMEM;
+    }
+    return 0;
+}
+
+int SharedRingArena::duplicate_fd(int *descriptor) const noexcept {
+    if (descriptor == nullptr || descriptor_ < 0) {
+        return EINVAL;
+    }
+    const int copy = fcntl(descriptor_, F_DUPFD_CLOEXEC, 0);
+    if (copy < 0) {
+        return errno;
+    }
+    *descriptor = copy;
+    return 0;
+}
+
+std::size_t SharedRingArena::size() const noexcept {
+    return size_;
+}
+
+std::size_t SharedRingArena::allocated_bytes() const noexcept {
+    std::lock_guard lock(mutex_);
+    return allocated_bytes_;
+}
+
+int SharedRingArena::allocate(std::size_t bytes, std::uint64_t *offset) noexcept {
+    if (bytes == 0 || offset == nullptr) {
+        return EINVAL;
+    }
+    std::lock_guard lock(mutex_);
+    for (auto range = free_ranges_.begin(); range != free_ranges_.end(); ++range) {
+        if (range->second < bytes) {
+            continue;
+        }
+        *offset = range->first;
+        if (range->second == bytes) {
+            free_ranges_.erase(range);
+        } else {
+            // Reusing the node keeps allocate from touching the heap.
+            auto node = free_ranges_.extract(range);
+            node.key() += bytes;
+            node.mapped() -= bytes;
+            free_ranges_.insert(std::move(node));
+        }
+        allocated_bytes_ += bytes;
+        return 0;
+    }
+    return ENOMEM;
+}
+
+void SharedRingArena::release(std::uint64_t offset, std::size_t bytes) noexcept {
+    std::lock_guard lock(mutex_);
+    allocated_bytes_ -= bytes;
+    auto next = free_ranges_.lower_bound(offset);
+    if (next != free_ranges_.begin()) {
+        const auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            bytes += previous->second;
+            free_ranges_.erase(previous);
+        }
+    }
+    if (next != free_ranges_.end() && offset + bytes == next->first) {
+        bytes += next->second;
+        next = free_ranges_.erase(next);
+    }
+    try {
+        free_ranges_.emplace_hint(next, offset, bytes);
+    } catch (...) {
+        // Losing track of a range only shrinks the arena.
+    }
+}
+
+void *SharedRingArena::address(std::uint64_t offset) const noexcept {
+    return static_cast<std::byte *>(mapping_) + offset;
+}
+
+}  // namespace ugdr::queue
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "queue/shared_ring.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace ugdr::queue {
+
+constexpr std::size_t kMaxRingArenaBytes = std::size_t{1} << 30U;
+
+// One sealed memfd that holds many rings, so a context costs one fd and one mapping per process
+// instead of one per queue. The memfd is sparse: pages are only allocated once a ring touches
+// them. Ranges are page aligned and allocated first fit; released ranges are coalesced.
+class SharedRingArena {
+  public:
+    // numa_node, when set, is preferred for every page of the arena whichever process faults it.
+    static int create(std::size_t bytes, std::shared_ptr<SharedRingArena> *arena,
+                      int numa_node = kNoNumaNode) noexcept;
+    static int map(int descriptor, std::shared_ptr<SharedRingArena> *arena) noexcept;
+
+    ~SharedRingArena();
+
+    SharedRingArena(const SharedRingArena &) = delete;
+    SharedRingArena &operator=(const SharedRingArena &) = delete;
+
+    int duplicate_fd(int *descriptor) const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::size_t allocated_bytes() const noexcept;
+
+    int allocate(std::size_t bytes, std::uint64_t *offset) noexcept;
+    void release(std::uint64_t offset, std::size_t bytes) noexcept;
+    [[nodiscard]] void *address(std::uint64_t offset) const noexcept;
+
+  private:
+    SharedRingArena(void *mapping, std::size_t size, int descriptor) noexcept;
+
+    void *mapping_ = nullptr;
+    std::size_t size_ = 0;
+    int descriptor_ = -1;
+    mutable std::mutex mutex_;
+    std::map<std::uint64_t, std::size_t> free_ranges_;
+    std::size_t allocated_bytes_ = 0;
+};
+
+}  // namespace ugdr::queue
@@ -0,0 +1,169 @@
+#include "queue/ring_pool.hpp"
+
+#include "queue/numa.hpp"
+
+#include <cerrno>
+#include <utility>
+
+namespace ugdr::queue {
+
+SharedRingPool::SharedRingPool(std::size_t depth, RingMemoryOptions options)
+    : depth_(depth), options_(options) {
+    shapes_.reserve(kMaxShapes);
+}
+
+SharedRingPool::~SharedRingPool() {
+    stop();
+}
+
+int SharedRingPool::start() noexcept {
+    std::lock_guard lock(mutex_);
+    if (refiller_.joinable()) {
+        return EBUSY;
+    }
+    stopping_ = false;
+    try {
+        refiller_ = std::thread([this] { run(); });
+    } catch (...) {
+        return EAGAIN;
+    }
+    return 0;
+}
+
+void SharedRingPool::stop() noexcept {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (refiller_.joinable()) {
+        refiller_.join();
+    }
+}
+
+int SharedRingPool::acquire(const QueueDescriptor &descriptor, SharedRing *ring) noexcept {
+    if (ring == nullptr || ring->valid()) {
+        return EINVAL;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        Shape *const shape = find_shape(descriptor);
+        if (shape != nullptr) {
+            shape->last_used = ++clock_;
+        }
+        if (shape != nullptr && !shape->rings.empty()) {
+            *ring = std::move(shape->rings.back());
+            shape->rings.pop_back();
+            ++hits_;
+            refill_requested_ = true;
+        } else {
+            ++misses_;
+        }
+    }
+    if (ring->valid()) {
+        wake_.notify_one();
+        return 0;
+    }
+    const int status = create_shared_ring(descriptor, ring, options_);
+    std::size_t bytes = 0;
+    if (status != 0 || depth_ == 0 || shared_ring_mapping_size(descriptor, 1, &bytes) != 0 ||
+        bytes > kMaxPooledRingBytes) {
+        return status;
+    }
+    std::vector<SharedRing> evicted;
+    {
+        // Only shapes that were created successfully are pooled. shapes_ has room for
+        // kMaxShapes reserved, so the push never allocates.
+        std::lock_guard lock(mutex_);
+        if (find_shape(descriptor) == nullptr) {
+            if (shapes_.size() < kMaxShapes) {
+                shapes_.push_back({descriptor, {}, ++clock_});
+            } else {
+                Shape *victim = &shapes_.front();
+                for (Shape &shape : shapes_) {
+                    victim = shape.last_used < victim->last_used ? &shape : victim;
+                }
+                evicted = std::move(victim->rings);
+                *victim = {descriptor, {}, ++clock_};
+            }
+        }
+        refill_requested_ = true;
+    }
+    wake_.notify_one();
+    return 0;
+}
+
+void SharedRingPool::refill() noexcept {
+    std::unique_lock lock(mutex_);
+    refill_requested_ = false;
+    for (std::size_t index = 0; index < shapes_.size() && !stopping_; ++index) {
+        while (shapes_[index].rings.size() < depth_ && !stopping_) {
+            const QueueDescriptor descriptor = shapes_[index].descriptor;
+            lock.unlock();
+            SharedRing ring;
+            const int status = create_shared_ring(descriptor, &ring, options_);
+            lock.lock();
+            if (status != 0) {
+                // Out of memory or descriptors; the next acquire retries.
+                return;
+            }
+            if (!(shapes_[index].descriptor == descriptor)) {
+                // An acquire evicted the shape while the ring was being created.
+                break;
+            }
+            try {
+                shapes_[index].rings.push_back(std::move(ring));
+            } catch (...) {
+                return;
+            }
+        }
+    }
+}
+
+const RingMemoryOptions &SharedRingPool::options() const noexcept {
+    return options_;
+}
+
+std::size_t SharedRingPool::available(const QueueDescriptor &descriptor) const noexcept {
+    std::lock_guard lock(mutex_);
+    const Shape *const shape = const_cast<SharedRingPool *>(this)->find_shape(descriptor);
+    return shape != nullptr ? shape->rings.size() : 0;
+}
+
+std::uint64_t SharedRingPool::hits() const noexcept {
+    std::lock_guard lock(mutex_);
+    return hits_;
+}
+
+std::uint64_t SharedRingPool::misses() const noexcept {
+    std::lock_guard lock(mutex_);
+    return misses_;
+}
+
+SharedRingPool::Shape *SharedRingPool::find_shape(const QueueDescriptor &descriptor) noexcept {
+    for (Shape &shape : shapes_) {
+        if (shape.descriptor == descriptor) {
+            return &shape;
+        }
+    }
+    return nullptr;
+}
+
+void SharedRingPool::run() noexcept {
+    (void)pin_thread_to_numa_node(options_.numa_node);
+    std::unique_lock lock(mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        refill();
+        lock.lock();
+        wake_.wait(lock, [this] { return stopping_ || refill_requested_; });
+    }
+}
+
+int create_pooled_ring(SharedRingPool *pool, const QueueDescriptor &descriptor, SharedRing *ring,
+                       const RingMemoryOptions &options) noexcept {
+    return pool != nullptr ? pool->acquire(descriptor, ring)
+                           : create_shared_ring(descriptor, ring, options);
+}
+
+}  // namespace ugdr::queue
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "queue/shared_ring.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ugdr::queue {
+
+// Keeps freshly created, already faulted rings of each requested shape, so that QP, SRQ, and CQ
+// creation on the IPC thread skips memfd_create, ftruncate, mmap, and the zeroing pass. A shape
+// of at most kMaxPooledRingBytes is pooled after its first request; with kMaxShapes pooled, a new
+// shape replaces the least recently requested one. Pooled rings are never recycled: a destroyed
+// ring may still be mapped by its Client, so every acquire hands out a ring nobody has seen. The
+// background thread runs on the node of options.numa_node, next to the memory it fills.
+class SharedRingPool {
+  public:
+    static constexpr std::size_t kMaxShapes = 16;
+    static constexpr std::size_t kMaxPooledRingBytes = std::size_t{1} << 20U;
+
+    explicit SharedRingPool(std::size_t depth = 4, RingMemoryOptions options = {});
+    ~SharedRingPool();
+
+    SharedRingPool(const SharedRingPool &) = delete;
+    SharedRingPool &operator=(const SharedRingPool &) = delete;
+
+    // Starts the background thread that keeps each shape at depth rings.
+    int start() noexcept;
+    void stop() noexcept;
+
+    // Moves a pooled ring into *ring, or creates one inline when none of that shape is ready.
+    int acquire(const QueueDescriptor &descriptor, SharedRing *ring) noexcept;
+    // Creates rings until every known shape holds depth. The background thread runs this.
+    void refill() noexcept;
+
+    [[nodiscard]] const RingMemoryOptions &options() const noexcept;
+    [[nodiscard]] std::size_t available(const QueueDescriptor &descriptor) const noexcept;
+    [[nodiscard]] std::uint64_t hits() const noexcept;
+    [[nodiscard]] std::uint64_t misses() const noexcept;
+
+  private:
+    struct Shape {
+        QueueDescriptor descriptor;
+        std::vector<SharedRing> rings;
+        std::uint64_t last_used = 0;
+    };
+
+    Shape *find_shape(const QueueDescriptor &descriptor) noexcept;
+    void run() noexcept;
+
+    std::size_t depth_ = 0;
+    RingMemoryOptions options_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<Shape> shapes_;
+    std::thread refiller_;
+    bool stopping_ = false;
+    bool refill_requested_ = false;
+    std::uint64_t clock_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+
+// Uses pool when it is not null and falls back to create_shared_ring with options otherwise.
+int create_pooled_ring(SharedRingPool *pool, const QueueDescriptor &descriptor, SharedRing *ring,
+                       const RingMemoryOptions &options = {}) noexcept;
+
+}  // namespace ugdr::queue
@@ -1,5 +1,9 @@
 #include "queue/shared_ring.hpp"
 
+#include "queue/descriptors.hpp"
+#include "queue/numa.hpp"
+#include "queue/ring_arena.hpp"
+
 #include <algorithm>
 #include <atomic>
 #include <cerrno>
@@ -18,12 +22,25 @@ namespace ugdr::queue {
 namespace {
 
 static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free);
+static_assert(std::atomic_ref<std::uint32_t>::is_always_lock_free);
 
 bool valid_descriptor(const QueueDescriptor &descriptor) noexcept {
     const auto kind = static_cast<std::uint16_t>(descriptor.kind);
+    const bool phase = descriptor.ownership == RingOwnership::phase;
     return kind >= static_cast<std::uint16_t>(QueueKind::send) &&
-           kind <= static_cast<std::uint16_t>(QueueKind::completion) && descriptor.capacity != 0 &&
-           descriptor.slot_stride != 0 && descriptor.slot_stride % kSharedRingCacheLine == 0;
+           kind <= static_cast<std::uint16_t>(QueueKind::transport) && descriptor.capacity != 0 &&
+           descriptor.slot_stride != 0 &&
+           (descriptor.slot_stride % kSharedRingCacheLine == 0 ||
+            (descriptor.kind == QueueKind::completion &&
+             descriptor.slot_stride == compact_completion_slot_stride())) &&
+           (descriptor.ownership == RingOwnership::counters ||
+            (phase && descriptor.kind == QueueKind::completion &&
+             descriptor.slot_stride % kSharedRingCacheLine == 0));
+}
+
+// Slots start zeroed, so the first lap marks owned slots with 1 and the next lap with 0.
+std::uint32_t lap_phase(std::uint64_t position, std::uint32_t capacity) noexcept {
+    return ((position / capacity) & 1U) == 0 ? 1U : 0U;
 }
 
 int system_page_size(std::size_t *page_size) noexcept {
@@ -35,16 +52,58 @@ int system_page_size(std::size_t *page_size) noexcept {
     return 0;
 }
 
-int create_memfd() noexcept {
+int create_memfd(unsigned int flags) noexcept {
 #ifdef SYS_memfd_create
     return static_cast<int>(
-        syscall(SYS_memfd_create, "ugdr-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+        syscall(SYS_memfd_create, "ugdr-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING | flags));
 #else
     errno = ENOSYS;
     return -1;
 #endif
 }
 
+// Flags selecting 2 MiB hugetlb pages, or 0 when the platform has no hugetlb memfds. The
+// MFD_HUGE_2MB encoding is spelled out because linux/memfd.h clashes with the glibc definitions.
+unsigned int huge_page_memfd_flags() noexcept {
+#ifdef MFD_HUGETLB
+    constexpr unsigned int huge_2mb = 21U << 26U;
+    return MFD_HUGETLB | huge_2mb;
+#else
+    return 0;
+#endif
+}
+
+// Creates, sizes, maps, and seals a memfd for one ring. A ring with a node is not populated by
+// mmap, so its pages are only allocated once the policy is set; format_ring touches them next.
+int create_ring_memory(std::size_t mapping_size, unsigned int memfd_flags,
+                       const RingMemoryOptions &options, void **mapping,
+                       int *descriptor_fd) noexcept {
+    const int descriptor = create_memfd(memfd_flags);
+    if (descriptor < 0) {
+        return errno;
+    }
+    const bool populate = options.prefault && options.numa_node == kNoNumaNode;
+    void *mapped = MAP_FAILED;
+    if (ftruncate(descriptor, static_cast<off_t>(mapping_size)) == 0) {
+        mapped = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | (populate ? MAP_POPULATE : 0), descriptor, 0);
+    }
+    if (mapped == MAP_FAILED ||
+        fcntl(descriptor, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        const int status = errno;
+        if (mapped != MAP_FAILED) {
+            (void)munmap(mapped, mapping_size);
+        }
+        (void)::close(descriptor);
+        return status;
+    }
+    // Placement is best effort: a kernel without NUMA support still gets a working ring.
+    (void)bind_memory_to_numa_node(mapped, mapping_size, options.numa_node);
+    *mapping = mapped;
+    *descriptor_fd = descriptor;
+    return 0;
+}
+
 bool reserved_is_zero(const SharedRingHeader &header) noexcept {
     if (header.metadata.reserved0 != 0) {
         return false;
@@ -67,6 +126,53 @@ bool reserved_is_zero(const SharedRingHeader &header) noexcept {
     return true;
 }
 
+void format_ring(void *mapping, std::size_t mapping_size,
+                 const QueueDescriptor &descriptor) noexcept {
+    std::memset(mapping, 0, mapping_size);
+    auto *header = static_cast<SharedRingHeader *>(mapping);
+    header->metadata.magic = kSharedRingMagic;
+    header->metadata.version = kSharedRingVersion;
+    header->metadata.kind = static_cast<std::uint16_t>(descriptor.kind);
+    header->metadata.header_bytes = sizeof(SharedRingHeader);
+    header->metadata.ownership = static_cast<std::uint16_t>(descriptor.ownership);
+    header->metadata.mapping_bytes = mapping_size;
+    header->metadata.capacity = descriptor.capacity;
+    header->metadata.slot_stride = descriptor.slot_stride;
+}
+
+int validate_ring(const void *mapping, std::size_t mapping_size,
+                  const QueueDescriptor &expected) noexcept {
+    const auto *header = static_cast<const SharedRingHeader *>(mapping);
+    if (header->metadata.magic == kSharedRingMagic &&
+        header->metadata.version != kSharedRingVersion) {
+        return EPROTONOSUPPORT;
+    }
+    if (header->metadata.magic != kSharedRingMagic ||
+        header->metadata.kind != static_cast<std::uint16_t>(expected.kind) ||
+        header->metadata.header_bytes != sizeof(SharedRingHeader) ||
+        header->metadata.ownership != static_cast<std::uint16_t>(expected.ownership) ||
+        header->metadata.mapping_bytes != mapping_size ||
+        header->metadata.capacity != expected.capacity ||
+        header->metadata.slot_stride != expected.slot_stride || !reserved_is_zero(*header)) {
+        return EPROTO;
+    }
+    // The creator may have rounded the ring to either normal or huge pages.
+    std::size_t page_size = 0;
+    std::size_t expected_size = 0;
+    std::size_t huge_size = 0;
+    int status = system_page_size(&page_size);
+    if (status == 0) {
+        status = shared_ring_mapping_size(expected, page_size, &expected_size);
+    }
+    if (status == 0) {
+        status = shared_ring_mapping_size(expected, kSharedRingHugePageBytes, &huge_size);
+    }
+    if (status == 0 && expected_size != mapping_size && huge_size != mapping_size) {
+        status = EPROTO;
+    }
+    return status;
+}
+
 }  // namespace
 
 SharedRing::SharedRing(void *mapping, std::size_t mapping_size, int descriptor,
@@ -94,12 +200,20 @@ SharedRing &SharedRing::operator=(SharedRing &&other) noexcept {
         consumer_ = other.consumer_;
         other.producer_ = {};
         other.consumer_ = {};
+        arena_ = std::move(other.arena_);
+        arena_offset_ = std::exchange(other.arena_offset_, 0);
+        owns_arena_range_ = std::exchange(other.owns_arena_range_, false);
     }
     return *this;
 }
 
 void SharedRing::reset() noexcept {
-    if (mapping_ != nullptr) {
+    if (arena_ != nullptr) {
+        if (owns_arena_range_) {
+            arena_->release(arena_offset_, mapping_size_);
+        }
+        arena_.reset();
+    } else if (mapping_ != nullptr) {
         (void)munmap(mapping_, mapping_size_);
     }
     if (descriptor_ >= 0) {
@@ -111,6 +225,8 @@ void SharedRing::reset() noexcept {
     queue_descriptor_ = {};
     producer_ = {};
     consumer_ = {};
+    arena_offset_ = 0;
+    owns_arena_range_ = false;
 }
 
 bool SharedRing::valid() const noexcept {
@@ -141,6 +257,14 @@ int SharedRing::duplicate_fd(int *descriptor) const noexcept {
     return 0;
 }
 
+bool SharedRing::in_arena() const noexcept {
+    return arena_ != nullptr;
+}
+
+std::uint64_t SharedRing::arena_offset() const noexcept {
+    return arena_offset_;
+}
+
 SharedRingHeader *SharedRing::header() noexcept {
     return static_cast<SharedRingHeader *>(mapping_);
 }
@@ -155,6 +279,15 @@ void *SharedRing::slot_at(std::uint32_t index) noexcept {
            static_cast<std::size_t>(index) * queue_descriptor_.slot_stride;
 }
 
+std::uint32_t *SharedRing::slot_marker(std::uint32_t index) noexcept {
+    return reinterpret_cast<std::uint32_t *>(static_cast<std::byte *>(slot_at(index)) +
+                                             queue_descriptor_.slot_stride - kSlotMarkerBytes);
+}
+
+bool SharedRing::phase_ownership() const noexcept {
+    return queue_descriptor_.ownership == RingOwnership::phase;
+}
+
 int SharedRing::producer_reserve(std::uint32_t max_count, MutableSlotBatch *batch) noexcept {
     if (!valid() || max_count == 0 || batch == nullptr || producer_.reserved != 0) {
         return EINVAL;
@@ -162,10 +295,13 @@ int SharedRing::producer_reserve(std::uint32_t max_count, MutableSlotBatch *batc
     std::atomic_ref<std::uint64_t> shared_tail(header()->tail.value);
     std::atomic_ref<std::uint64_t> shared_head(header()->head.value);
     if (!producer_.initialized) {
-        producer_.local_tail = shared_tail.load(std::memory_order_relaxed);
         producer_.cached_head = shared_head.load(std::memory_order_acquire);
+        producer_.local_tail = phase_ownership() ? recover_owned_tail(producer_.cached_head)
+                                                 : shared_tail.load(std::memory_order_relaxed);
+        producer_.published_tail = producer_.local_tail;
         producer_.local_index =
             static_cast<std::uint32_t>(producer_.local_tail % queue_descriptor_.capacity);
+        producer_.phase = lap_phase(producer_.local_tail, queue_descriptor_.capacity);
         producer_.initialized = true;
     }
     std::uint64_t used = producer_.local_tail - producer_.cached_head;
@@ -196,21 +332,76 @@ int SharedRing::producer_reserve(std::uint32_t max_count, MutableSlotBatch *batc
     return 0;
 }
 
+// The shared tail is never written under phase ownership, so a producer mapping a live ring walks
+// the markers from the consumer head to find the first slot not yet written on its lap.
+std::uint64_t SharedRing::recover_owned_tail(std::uint64_t head) noexcept {
+    std::uint64_t tail = head;
+    while (tail - head < queue_descriptor_.capacity) {
+        const auto index = static_cast<std::uint32_t>(tail % queue_descriptor_.capacity);
+        std::atomic_ref<std::uint32_t> marker(*slot_marker(index));
+        if (marker.load(std::memory_order_acquire) !=
+            lap_phase(tail, queue_descriptor_.capacity)) {
+            break;
+        }
+        ++tail;
+    }
+    return tail;
+}
+
 int SharedRing::producer_publish(std::uint32_t count) noexcept {
+    const int status = producer_stage(count);
+    if (status == 0 && producer_.published_tail != producer_.local_tail) {
+        (void)producer_flush();
+    }
+    return status;
+}
+
+int SharedRing::producer_stage(std::uint32_t count) noexcept {
     if (!valid() || producer_.reserved == 0 || count > producer_.reserved) {
         return EINVAL;
     }
-    if (count != 0) {
-        producer_.local_tail += count;
-        producer_.local_index += count;
-        if (producer_.local_index >= queue_descriptor_.capacity) {
-            producer_.local_index -= queue_descriptor_.capacity;
+    producer_.reserved = 0;
+    if (phase_ownership()) {
+        for (std::uint32_t index = 0; index < count; ++index) {
+            std::atomic_ref<std::uint32_t> marker(*slot_marker(producer_.local_index));
+            marker.store(producer_.phase, std::memory_order_release);
+            if (++producer_.local_index == queue_descriptor_.capacity) {
+                producer_.local_index = 0;
+                producer_.phase ^= 1U;
+            }
         }
+        producer_.local_tail += count;
+        producer_.published_tail = producer_.local_tail;
+        return 0;
+    }
+    producer_.local_tail += count;
+    producer_.local_index += count;
+    if (producer_.local_index >= queue_descriptor_.capacity) {
+        producer_.local_index -= queue_descriptor_.capacity;
+    }
+    return 0;
+}
+
+std::uint32_t SharedRing::producer_flush() noexcept {
+    const auto staged = producer_staged();
+    if (staged != 0) {
         std::atomic_ref<std::uint64_t> shared_tail(header()->tail.value);
         shared_tail.store(producer_.local_tail, std::memory_order_release);
+        producer_.published_tail = producer_.local_tail;
     }
-    producer_.reserved = 0;
-    return 0;
+    return staged;
+}
+
+std::uint32_t SharedRing::producer_staged() const noexcept {
+    return static_cast<std::uint32_t>(producer_.local_tail - producer_.published_tail);
+}
+
+std::uint64_t SharedRing::producer_position() const noexcept {
+    return producer_.local_tail;
+}
+
+std::uint64_t SharedRing::consumer_position() const noexcept {
+    return consumer_.local_head;
 }
 
 int SharedRing::consumer_peek(std::uint32_t max_count, ConstSlotBatch *batch) noexcept {
@@ -221,16 +412,22 @@ int SharedRing::consumer_peek(std::uint32_t max_count, ConstSlotBatch *batch) no
     std::atomic_ref<std::uint64_t> shared_head(header()->head.value);
     if (!consumer_.initialized) {
         consumer_.local_head = shared_head.load(std::memory_order_relaxed);
-        consumer_.cached_tail = shared_tail.load(std::memory_order_acquire);
+        consumer_.cached_tail = phase_ownership() ? consumer_.local_head
+                                                  : shared_tail.load(std::memory_order_acquire);
         consumer_.local_index =
             static_cast<std::uint32_t>(consumer_.local_head % queue_descriptor_.capacity);
+        consumer_.tail_index = consumer_.local_index;
+        consumer_.tail_phase = lap_phase(consumer_.local_head, queue_descriptor_.capacity);
         consumer_.initialized = true;
     }
     std::uint64_t available = consumer_.cached_tail - consumer_.local_head;
     if (available > queue_descriptor_.capacity) {
         return EPROTO;
     }
-    if (available < max_count) {
+    if (available < max_count && phase_ownership()) {
+        refresh_owned_tail(max_count);
+        available = consumer_.cached_tail - consumer_.local_head;
+    } else if (available < max_count) {
         consumer_.cached_tail = shared_tail.load(std::memory_order_acquire);
         available = consumer_.cached_tail - consumer_.local_head;
         if (available > queue_descriptor_.capacity) {
@@ -252,6 +449,49 @@ int SharedRing::consumer_peek(std::uint32_t max_count, ConstSlotBatch *batch) no
     return 0;
 }
 
+// Extends cached_tail over slots whose marker shows the current lap, stopping at the first slot
+// the producer has not written yet or once wanted slots are visible.
+void SharedRing::refresh_owned_tail(std::uint32_t wanted) noexcept {
+    const std::uint64_t limit = consumer_.local_head + std::min(wanted, queue_descriptor_.capacity);
+    while (consumer_.cached_tail < limit) {
+        std::atomic_ref<std::uint32_t> marker(*slot_marker(consumer_.tail_index));
+        if (marker.load(std::memory_order_acquire) != consumer_.tail_phase) {
+            break;
+        }
+        ++consumer_.cached_tail;
+        if (++consumer_.tail_index == queue_descriptor_.capacity) {
+            consumer_.tail_index = 0;
+            consumer_.tail_phase ^= 1U;
+        }
+    }
+}
+
+int SharedRing::consumer_view(std::uint32_t max_count, ConstSlotBatch *batch) noexcept {
+    if (!valid() || max_count == 0 || batch == nullptr || consumer_.peeked != 0) {
+        return EINVAL;
+    }
+    if (!consumer_.initialized) {
+        std::atomic_ref<std::uint64_t> shared_head(header()->head.value);
+        consumer_.local_head = shared_head.load(std::memory_order_relaxed);
+        consumer_.cached_tail = consumer_.local_head;
+        consumer_.local_index =
+            static_cast<std::uint32_t>(consumer_.local_head % queue_descriptor_.capacity);
+        consumer_.tail_index = consumer_.local_index;
+        consumer_.tail_phase = lap_phase(consumer_.local_head, queue_descriptor_.capacity);
+        consumer_.initialized = true;
+    }
+    const auto count = std::min(max_count, queue_descriptor_.capacity);
+    const auto start = consumer_.local_index;
+    const auto first_count = std::min(count, queue_descriptor_.capacity - start);
+    ConstSlotBatch viewed;
+    viewed.first = {slot_at(start), first_count};
+    viewed.second = {first_count == count ? nullptr : slot_at(0), count - first_count};
+    viewed.count = count;
+    consumer_.peeked = count;
+    *batch = viewed;
+    return 0;
+}
+
 int SharedRing::consumer_release(std::uint32_t count) noexcept {
     if (!valid() || consumer_.peeked == 0 || count > consumer_.peeked) {
         return EINVAL;
@@ -320,58 +560,50 @@ int shared_ring_mapping_size(const QueueDescriptor &descriptor, std::size_t page
     return 0;
 }
 
-int create_shared_ring(const QueueDescriptor &descriptor, SharedRing *ring) noexcept {
+int create_shared_ring(const QueueDescriptor &descriptor, SharedRing *ring,
+                       const RingMemoryOptions &options) noexcept {
     if (ring == nullptr || ring->valid()) {
         return EINVAL;
     }
     std::size_t page_size = 0;
     int status = system_page_size(&page_size);
     std::size_t mapping_size = 0;
+    std::size_t huge_size = 0;
     if (status == 0) {
         status = shared_ring_mapping_size(descriptor, page_size, &mapping_size);
     }
+    if (status == 0) {
+        status = shared_ring_mapping_size(descriptor, kSharedRingHugePageBytes, &huge_size);
+    }
     if (status != 0) {
         return status;
     }
-    if (mapping_size > static_cast<std::size_t>(std::numeric_limits<off_t>::max())) {
+    if (huge_size > static_cast<std::size_t>(std::numeric_limits<off_t>::max())) {
         return EOVERFLOW;
     }
-    const int descriptor_fd = create_memfd();
-    if (descriptor_fd < 0) {
-        return errno;
-    }
-    if (ftruncate(descriptor_fd, static_cast<off_t>(mapping_size)) != 0) {
-        status = errno;
-        (void)::close(descriptor_fd);
-        return status;
-    }
-    void *mapping =
-        mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor_fd, 0);
-    if (mapping == MAP_FAILED) {
-        status = errno;
-        (void)::close(descriptor_fd);
-        return status;
-    }
-    std::memset(mapping, 0, mapping_size);
-    auto *header = static_cast<SharedRingHeader *>(mapping);
-    header->metadata.magic = kSharedRingMagic;
-    header->metadata.version = kSharedRingVersion;
-    header->metadata.kind = static_cast<std::uint16_t>(descriptor.kind);
-    header->metadata.header_bytes = sizeof(SharedRingHeader);
-    header->metadata.mapping_bytes = mapping_size;
-    header->metadata.capacity = descriptor.capacity;
-    header->metadata.slot_stride = descriptor.slot_stride;
-    if (fcntl(descriptor_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
-        status = errno;
-        (void)munmap(mapping, mapping_size);
-        (void)::close(descriptor_fd);
-        return status;
+    void *mapping = MAP_FAILED;
+    int descriptor_fd = -1;
+    // Rings under half a huge page would mostly waste one, so they stay on normal pages. Any
+    // hugetlb failure, usually an empty pool of reserved huge pages, falls back the same way.
+    const unsigned int huge_flags = huge_page_memfd_flags();
+    const bool try_huge =
+        options.huge_pages && huge_flags != 0 && mapping_size >= kSharedRingHugePageBytes / 2;
+    if (try_huge &&
+        create_ring_memory(huge_size, huge_flags, options, &mapping, &descriptor_fd) == 0) {
+        mapping_size = huge_size;
+    } else {
+        status = create_ring_memory(mapping_size, 0, options, &mapping, &descriptor_fd);
+        if (status != 0) {
+            return status;
+        }
     }
+    format_ring(mapping, mapping_size, descriptor);
     *ring = SharedRing(mapping, mapping_size, descriptor_fd, descriptor);
     return 0;
 }
 
-int map_shared_ring(int descriptor_fd, const QueueDescriptor &expected, SharedRing *ring) noexcept {
+int map_shared_ring(int descriptor_fd, const QueueDescriptor &expected, SharedRing *ring,
+                    const RingMemoryOptions &options) noexcept {
     if (descriptor_fd < 0 || ring == nullptr || ring->valid() || !valid_descriptor(expected)) {
         return EINVAL;
     }
@@ -385,40 +617,82 @@ int map_shared_ring(int descriptor_fd, const QueueDescriptor &expected, SharedRi
         return EPROTO;
     }
     const std::size_t mapping_size = static_cast<std::size_t>(status_buffer.st_size);
-    void *mapping =
-        mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor_fd, 0);
+    void *mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | (options.prefault ? MAP_POPULATE : 0), descriptor_fd, 0);
     if (mapping == MAP_FAILED) {
         return errno;
     }
-    const auto *header = static_cast<const SharedRingHeader *>(mapping);
-    int validation = 0;
-    if (header->metadata.magic == kSharedRingMagic &&
-        header->metadata.version != kSharedRingVersion) {
-        validation = EPROTONOSUPPORT;
-    } else if (header->metadata.magic != kSharedRingMagic ||
-               header->metadata.kind != static_cast<std::uint16_t>(expected.kind) ||
-               header->metadata.header_bytes != sizeof(SharedRingHeader) ||
-               header->metadata.mapping_bytes != mapping_size ||
-               header->metadata.capacity != expected.capacity ||
-               header->metadata.slot_stride != expected.slot_stride || !reserved_is_zero(*header)) {
-        validation = EPROTO;
+    const int validation = validate_ring(mapping, mapping_size, expected);
+    if (validation != 0) {
+        (void)munmap(mapping, mapping_size);
+        return validation;
+    }
+    *ring = SharedRing(mapping, mapping_size, -1, expected);
+    return 0;
+}
+
+int create_arena_ring(const std::shared_ptr<SharedRingArena> &arena,
+                      const QueueDescriptor &descriptor, SharedRing *ring) noexcept {
+    if (arena == nullptr || ring == nullptr || ring->valid()) {
+        return EINVAL;
     }
     std::size_t page_size = 0;
-    std::size_t expected_size = 0;
-    if (validation == 0) {
-        validation = system_page_size(&page_size);
+    int status = system_page_size(&page_size);
+    std::size_t mapping_size = 0;
+    if (status == 0) {
+        status = shared_ring_mapping_size(descriptor, page_size, &mapping_size);
     }
-    if (validation == 0) {
-        validation = shared_ring_mapping_size(expected, page_size, &expected_size);
+    std::uint64_t offset = 0;
+    if (status == 0) {
+        status = arena->allocate(mapping_size, &offset);
     }
-    if (validation == 0 && expected_size != mapping_size) {
-        validation = EPROTO;
+    if (status != 0) {
+        return status;
     }
-    if (validation != 0) {
-        (void)munmap(mapping, mapping_size);
-        return validation;
+    void *const mapping = arena->address(offset);
+    format_ring(mapping, mapping_size, descriptor);
+    *ring = SharedRing(mapping, mapping_size, -1, descriptor);
+    ring->arena_ = arena;
+    ring->arena_offset_ = offset;
+    ring->owns_arena_range_ = true;
+    return 0;
+}
+
+int map_arena_ring(const std::shared_ptr<SharedRingArena> &arena, std::uint64_t offset,
+                   const QueueDescriptor &expected, SharedRing *ring,
+                   const RingMemoryOptions &options) noexcept {
+    if (arena == nullptr || ring == nullptr || ring->valid() || !valid_descriptor(expected)) {
+        return EINVAL;
+    }
+    std::size_t page_size = 0;
+    int status = system_page_size(&page_size);
+    std::size_t mapping_size = 0;
+    if (status == 0) {
+        status = shared_ring_mapping_size(expected, page_size, &mapping_size);
+    }
+    if (status != 0) {
+        return status;
+    }
+    if (offset % page_size != 0 || offset > arena->size() ||
+        mapping_size > arena->size() - offset) {
+        return EPROTO;
+    }
+    void *const mapping = arena->address(offset);
+    status = validate_ring(mapping, mapping_size, expected);
+    if (status != 0) {
+        return status;
+    }
+#ifdef MADV_POPULATE_WRITE
+    if (options.prefault) {
+        // Best effort: a kernel without MADV_POPULATE_WRITE leaves the ring to fault lazily.
+        (void)madvise(mapping, mapping_size, MADV_POPULATE_WRITE);
     }
+#else
+    (void)options;
+#endif
     *ring = SharedRing(mapping, mapping_size, -1, expected);
+    ring->arena_ = arena;
+    ring->arena_offset_ = offset;
     return 0;
 }
 
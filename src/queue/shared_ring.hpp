@@ -1,34 +1,73 @@
 #pragma once
 
+#include "queue/numa.hpp"
+
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace ugdr::queue {
 
+class SharedRingArena;
+
 constexpr std::uint32_t kSharedRingMagic = UINT32_C(0x55475251);
 constexpr std::uint16_t kSharedRingVersion = 1;
 constexpr std::size_t kSharedRingCacheLine = 64;
+constexpr std::size_t kSharedRingHugePageBytes = std::size_t{2} << 20U;
 
 enum class QueueKind : std::uint16_t {
     send = 1,
     receive = 2,
     completion = 3,
+    transport = 4,
 };
 
+// With counters ownership the producer publishes a shared tail. With phase ownership the last
+// kSlotMarkerBytes of every slot hold a marker that the producer flips on each lap, so the consumer
+// only reads the slots it is about to process and the shared tail is never written. Only
+// completion rings with full cache-line slots take phase ownership, because their writers stay
+// within slot_payload_bytes; WQE encoders fill the whole slot.
+enum class RingOwnership : std::uint16_t {
+    counters = 0,
+    phase = 1,
+};
+
+constexpr std::uint32_t kSlotMarkerBytes = 4;
+
 struct QueueDescriptor {
     QueueKind kind = QueueKind::send;
     std::uint32_t capacity = 0;
     std::uint32_t slot_stride = 0;
+    RingOwnership ownership = RingOwnership::counters;
 
     bool operator==(const QueueDescriptor &) const = default;
 };
 
+// Opt-in backing for rings. huge_pages puts rings of at least half a huge page on 2 MiB
+// MFD_HUGETLB pages, falling back to normal pages when no huge pages are reserved. prefault
+// populates a mapping's page tables up front, so first posts and polls take no page faults.
+// numa_node prefers that node for a new ring's pages, normally the node of the ring's device.
+struct RingMemoryOptions {
+    bool huge_pages = false;
+    bool prefault = false;
+    int numa_node = kNoNumaNode;
+
+    bool operator==(const RingMemoryOptions &) const = default;
+};
+
+inline std::uint32_t slot_payload_bytes(const QueueDescriptor &descriptor) noexcept {
+    return descriptor.ownership == RingOwnership::phase
+               ? descriptor.slot_stride - kSlotMarkerBytes
+               : descriptor.slot_stride;
+}
+
 struct alignas(kSharedRingCacheLine) SharedRingMetadata {
     std::uint32_t magic = 0;
     std::uint16_t version = 0;
     std::uint16_t kind = 0;
     std::uint32_t header_bytes = 0;
-    std::uint32_t reserved0 = 0;
+    std::uint16_t ownership = 0;
+    std::uint16_t reserved0 = 0;
     std::uint64_t mapping_bytes = 0;
     std::uint32_t capacity = 0;
     std::uint32_t slot_stride = 0;
@@ -88,10 +127,21 @@ class SharedRing {
     [[nodiscard]] std::size_t mapping_size() const noexcept;
     [[nodiscard]] const void *mapping_address() const noexcept;
     int duplicate_fd(int *descriptor) const noexcept;
+    // A ring carved from a SharedRingArena has no fd of its own and lives at arena_offset.
+    [[nodiscard]] bool in_arena() const noexcept;
+    [[nodiscard]] std::uint64_t arena_offset() const noexcept;
 
     int producer_reserve(std::uint32_t max_count, MutableSlotBatch *batch) noexcept;
     int producer_publish(std::uint32_t count) noexcept;
+    // Commits reserved slots without moving the shared tail; producer_flush later makes every
+    // staged slot visible to the consumer with one release store.
+    int producer_stage(std::uint32_t count) noexcept;
+    std::uint32_t producer_flush() noexcept;
+    [[nodiscard]] std::uint32_t producer_staged() const noexcept;
     int consumer_peek(std::uint32_t max_count, ConstSlotBatch *batch) noexcept;
+    // Exposes up to max_count slots from the consumer position without consulting the shared
+    // tail, for rings whose slots carry their own ownership marker.
+    int consumer_view(std::uint32_t max_count, ConstSlotBatch *batch) noexcept;
     int consumer_release(std::uint32_t count) noexcept;
 
     int producer_reserve(void **slot) noexcept;
@@ -99,21 +149,40 @@ class SharedRing {
     int consumer_peek(const void **slot) noexcept;
     int consumer_release() noexcept;
 
+    // Ring positions of the next slot to reserve and the next slot to consume.
+    [[nodiscard]] std::uint64_t producer_position() const noexcept;
+    [[nodiscard]] std::uint64_t consumer_position() const noexcept;
+
   private:
-    friend int create_shared_ring(const QueueDescriptor &, SharedRing *) noexcept;
-    friend int map_shared_ring(int, const QueueDescriptor &, SharedRing *) noexcept;
+    friend int create_shared_ring(const QueueDescriptor &, SharedRing *,
+                                  const RingMemoryOptions &) noexcept;
+    friend int map_shared_ring(int, const QueueDescriptor &, SharedRing *,
+                               const RingMemoryOptions &) noexcept;
+    friend int create_arena_ring(const std::shared_ptr<SharedRingArena> &,
+                                 const QueueDescriptor &, SharedRing *) noexcept;
+    friend int map_arena_ring(const std::shared_ptr<SharedRingArena> &, std::uint64_t,
+                              const QueueDescriptor &, SharedRing *,
+                              const RingMemoryOptions &) noexcept;
 
     SharedRing(void *mapping, std::size_t mapping_size, int descriptor,
                QueueDescriptor queue_descriptor) noexcept;
     [[nodiscard]] SharedRingHeader *header() noexcept;
     [[nodiscard]] const SharedRingHeader *header() const noexcept;
     [[nodiscard]] void *slot_at(std::uint32_t index) noexcept;
+    [[nodiscard]] std::uint32_t *slot_marker(std::uint32_t index) noexcept;
+    [[nodiscard]] bool phase_ownership() const noexcept;
+    void refresh_owned_tail(std::uint32_t wanted) noexcept;
+    std::uint64_t recover_owned_tail(std::uint64_t head) noexcept;
 
+    // phase and tail_phase are the marker values of the current lap at local_index and
+    // tail_index; they are only maintained for phase ownership.
     struct alignas(kSharedRingCacheLine) ProducerState {
         std::uint64_t local_tail = 0;
+        std::uint64_t published_tail = 0;
         std::uint64_t cached_head = 0;
         std::uint32_t local_index = 0;
         std::uint32_t reserved = 0;
+        std::uint32_t phase = 0;
         bool initialized = false;
     };
 
@@ -122,6 +191,8 @@ class SharedRing {
         std::uint64_t cached_tail = 0;
         std::uint32_t local_index = 0;
         std::uint32_t peeked = 0;
+        std::uint32_t tail_index = 0;
+        std::uint32_t tail_phase = 0;
         bool initialized = false;
     };
 
@@ -131,11 +202,26 @@ class SharedRing {
     QueueDescriptor queue_descriptor_{};
     ProducerState producer_;
     ConsumerState consumer_;
+    // Arena rings keep the arena mapped; the creating side also returns the range on reset.
+    std::shared_ptr<SharedRingArena> arena_;
+    std::uint64_t arena_offset_ = 0;
+    bool owns_arena_range_ = false;
 };
 
+// page_size is the system page size, or kSharedRingHugePageBytes for a huge-page ring.
 int shared_ring_mapping_size(const QueueDescriptor &descriptor, std::size_t page_size,
                              std::size_t *mapping_size) noexcept;
-int create_shared_ring(const QueueDescriptor &descriptor, SharedRing *ring) noexcept;
-int map_shared_ring(int descriptor, const QueueDescriptor &expected, SharedRing *ring) noexcept;
+int create_shared_ring(const QueueDescriptor &descriptor, SharedRing *ring,
+                       const RingMemoryOptions &options = {}) noexcept;
+// Only options.prefault applies; the creator already chose page size and placement.
+int map_shared_ring(int descriptor, const QueueDescriptor &expected, SharedRing *ring,
+                    const RingMemoryOptions &options = {}) noexcept;
+// Allocates and formats a ring inside arena, or returns ENOMEM when the arena is full.
+int create_arena_ring(const std::shared_ptr<SharedRingArena> &arena,
+                      const QueueDescriptor &descriptor, SharedRing *ring) noexcept;
+// Validates and attaches the ring another process created at offset in the same arena.
+int map_arena_ring(const std::shared_ptr<SharedRingArena> &arena, std::uint64_t offset,
+                   const QueueDescriptor &expected, SharedRing *ring,
+                   const RingMemoryOptions &options = {}) noexcept;
 
 }  // namespace ugdr::queue
@@ -0,0 +1,136 @@
+#include "worker/flow_control.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace ugdr::worker {
+namespace {
+
+constexpr std::uint32_t kUnlimitedWindow = std::numeric_limits<std::uint32_t>::max();
+constexpr double kDefaultCongestionWindow = 64.0;
+constexpr double kMaximumCongestionWindow = 1U << 20U;
+
+}  // namespace
+
+FlowController::FlowController(const FlowControlOptions &options) noexcept : options_(options) {
+    options_.minimum_window = std::max<std::uint32_t>(options_.minimum_window, 1);
+    options_.decrease_factor = std::clamp(options_.decrease_factor, 0.0, 1.0);
+    counters_.advertised_credits = options_.credit_window;
+    congestion_window_ = options_.credit_window != 0 ? options_.credit_window
+                                                     : kDefaultCongestionWindow;
+    record_window();
+}
+
+bool FlowController::enabled() const noexcept {
+    return options_.credit_window != 0 || options_.congestion_control != CongestionControl::none;
+}
+
+bool FlowController::try_admit(std::uint32_t payload_units) noexcept {
+    payload_units = std::max<std::uint32_t>(payload_units, 1);
+    const std::uint64_t outstanding = counters_.outstanding_payloads;
+    if (outstanding != 0 && outstanding + payload_units > window()) {
+        if (!stalled_) {
+            stalled_ = true;
+            ++counters_.credit_stalls;
+        }
+        return false;
+    }
+    stalled_ = false;
+    counters_.outstanding_payloads = static_cast<std::uint32_t>(
+        std::min<std::uint64_t>(outstanding + payload_units, kUnlimitedWindow));
+    counters_.peak_outstanding_payloads =
+        std::max(counters_.peak_outstanding_payloads, counters_.outstanding_payloads);
+    ++counters_.admitted_parents;
+    return true;
+}
+
+void FlowController::on_response(std::uint32_t payload_units, std::uint32_t advertised_credits,
+                                 bool congested, std::chrono::nanoseconds delay) noexcept {
+    payload_units = std::max<std::uint32_t>(payload_units, 1);
+    counters_.outstanding_payloads -= std::min(payload_units, counters_.outstanding_payloads);
+    take_credits(advertised_credits);
+    if (options_.congestion_control == CongestionControl::delay) {
+        const double delay_ns = static_cast<double>(std::max<std::int64_t>(delay.count(), 0));
+        const double target_ns = static_cast<double>(options_.target_delay.count());
+        counters_.last_delay_ns = static_cast<std::uint64_t>(delay_ns);
+        acknowledged_since_decrease_ += payload_units;
+        if (congested || delay_ns > target_ns) {
+            if (acknowledged_since_decrease_ >= congestion_window_) {
+                decrease_window(congested ? options_.decrease_factor
+                                          : options_.decrease_factor *
+                                                (1.0 - target_ns / delay_ns));
+            }
+        } else {
+            const double cap = options_.credit_window != 0 ? options_.credit_window
+                                                           : kMaximumCongestionWindow;
+            congestion_window_ = std::min(
+                cap, congestion_window_ + options_.additive_increase * payload_units /
+                                              congestion_window_);
+            ++counters_.window_increases;
+        }
+    }
+    record_window();
+}
+
+void FlowController::on_rnr(std::uint32_t advertised_credits) noexcept {
+    take_credits(advertised_credits);
+    if (options_.congestion_control == CongestionControl::delay) {
+        decrease_window(options_.decrease_factor);
+    }
+    record_window();
+}
+
+void FlowController::on_flush(std::uint32_t payload_units) noexcept {
+    payload_units = std::max<std::uint32_t>(payload_units, 1);
+    counters_.outstanding_payloads -= std::min(payload_units, counters_.outstanding_payloads);
+}
+
+std::uint32_t FlowController::advertise(std::size_t backlog) const noexcept {
+    if (options_.credit_window == 0) {
+        return 0;
+    }
+    if (static_cast<std::uint64_t>(backlog) + options_.minimum_window >= options_.credit_window) {
+        return std::min(options_.minimum_window, options_.credit_window);
+    }
+    return options_.credit_window - static_cast<std::uint32_t>(backlog);
+}
+
+const FlowControlCounters &FlowController::counters() const noexcept {
+    return counters_;
+}
+
+std::uint32_t FlowController::window() const noexcept {
+    std::uint32_t limit = kUnlimitedWindow;
+    if (options_.credit_window != 0) {
+        limit = counters_.advertised_credits;
+    }
+    if (options_.congestion_control == CongestionControl::delay) {
+        limit = std::min(limit, std::max(options_.minimum_window,
+                                         static_cast<std::uint32_t>(congestion_window_)));
+    }
+    return limit;
+}
+
+void FlowController::take_credits(std::uint32_t advertised_credits) noexcept {
+    if (options_.credit_window != 0 && advertised_credits != 0) {
+        counters_.advertised_credits = std::min(advertised_credits, options_.credit_window);
+    }
+}
+
+void FlowController::decrease_window(double factor) noexcept {
+    congestion_window_ =
+        std::max<double>(options_.minimum_window, congestion_window_ * (1.0 - factor));
+    acknowledged_since_decrease_ = 0;
+    ++counters_.window_decreases;
+}
+
+void FlowController::record_window() noexcept {
+    const std::uint32_t current = window();
+    counters_.window = current == kUnlimitedWindow ? 0 : current;
+    if (counters_.minimum_window == 0 || counters_.window < counters_.minimum_window) {
+        counters_.minimum_window = counters_.window;
+    }
+    counters_.peak_window = std::max(counters_.peak_window, counters_.window);
+}
+
+}  // namespace ugdr::worker
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ugdr::worker {
+
+enum class CongestionControl {
+    none,
+    delay,
+};
+
+struct FlowControlOptions {
+    std::uint32_t credit_window = 0;
+    CongestionControl congestion_control = CongestionControl::none;
+    std::chrono::nanoseconds target_delay = std::chrono::microseconds(50);
+    std::uint32_t minimum_window = 1;
+    double additive_increase = 1.0;
+    double decrease_factor = 0.5;
+};
+
+struct FlowControlCounters {
+    std::uint64_t admitted_parents = 0;
+    std::uint64_t credit_stalls = 0;
+    std::uint64_t window_increases = 0;
+    std::uint64_t window_decreases = 0;
+    std::uint64_t last_delay_ns = 0;
+    std::uint32_t window = 0;
+    std::uint32_t minimum_window = 0;
+    std::uint32_t peak_window = 0;
+    std::uint32_t advertised_credits = 0;
+    std::uint32_t outstanding_payloads = 0;
+    std::uint32_t peak_outstanding_payloads = 0;
+};
+
+class FlowController {
+  public:
+    explicit FlowController(const FlowControlOptions &options = {}) noexcept;
+
+    [[nodiscard]] bool enabled() const noexcept;
+    bool try_admit(std::uint32_t payload_units) noexcept;
+    void on_response(std::uint32_t payload_units, std::uint32_t advertised_credits, bool congested,
+                     std::chrono::nanoseconds delay) noexcept;
+    // A retried RNR NAK: the parent stays outstanding, but the peer is congested.
+    void on_rnr(std::uint32_t advertised_credits) noexcept;
+    // A flushed parent: its payloads stop being outstanding without saying anything about delay.
+    void on_flush(std::uint32_t payload_units) noexcept;
+    [[nodiscard]] std::uint32_t advertise(std::size_t backlog) const noexcept;
+    [[nodiscard]] const FlowControlCounters &counters() const noexcept;
+
+  private:
+    [[nodiscard]] std::uint32_t window() const noexcept;
+    void take_credits(std::uint32_t advertised_credits) noexcept;
+    void decrease_window(double factor) noexcept;
+    void record_window() noexcept;
+
+    FlowControlOptions options_;
+    FlowControlCounters counters_;
+    double congestion_window_ = 0.0;
+    double acknowledged_since_decrease_ = 0.0;
+    bool stalled_ = false;
+};
+
+}  // namespace ugdr::worker
@@ -18,6 +18,7 @@ enum class DatagramResult {
     remote_access_error,
     remote_operation_error,
     backend_error,
+    retry_exceeded,
 };
 
 struct RequestDatagram {
@@ -34,6 +35,10 @@ struct RequestDatagram {
     std::uint32_t payload_length = 0;
     std::uint32_t payload_index = 0;
     std::uint32_t payload_count = 0;
+    std::uint32_t epoch = 0;
+    // Set on receipt when the transport could not map source_daemon_address into this process;
+    // the responder then fails the parent with remote_access_error.
+    bool source_unmapped = false;
 
     bool operator==(const RequestDatagram &) const = default;
 };
@@ -42,19 +47,32 @@ struct ResponseDatagram {
     std::uint64_t parent_request_id = 0;
     DatagramResult result = DatagramResult::success;
     std::uint8_t rnr_delay = 0;
+    std::uint32_t credits = 0;
+    std::uint32_t epoch = 0;
 
     bool operator==(const ResponseDatagram &) const = default;
 };
 
-class LocalTransport {
+class DatagramTransport {
+  public:
+    virtual ~DatagramTransport() = default;
+
+    virtual bool try_push_request(const RequestDatagram &request) = 0;
+    virtual bool try_pop_request(RequestDatagram &request) = 0;
+
+    virtual bool try_push_response(const ResponseDatagram &response) = 0;
+    virtual bool try_pop_response(ResponseDatagram &response) = 0;
+};
+
+class LocalTransport final : public DatagramTransport {
   public:
     LocalTransport(std::size_t request_capacity, std::size_t response_capacity);
 
-    bool try_push_request(const RequestDatagram &request);
-    bool try_pop_request(RequestDatagram &request);
+    bool try_push_request(const RequestDatagram &request) override;
+    bool try_pop_request(RequestDatagram &request) override;
 
-    bool try_push_response(const ResponseDatagram &response);
-    bool try_pop_response(ResponseDatagram &response);
+    bool try_push_response(const ResponseDatagram &response) override;
+    bool try_pop_response(ResponseDatagram &response) override;
 
   private:
     std::size_t request_capacity_ = 0;
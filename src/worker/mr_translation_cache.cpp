@@ -0,0 +1,47 @@
+#include "worker/mr_translation_cache.hpp"
+
+#include <cerrno>
+
+namespace ugdr::worker {
+
+int MrTranslationCache::resolve(const control::PdMrCqService &service, ipc::SessionId session_id,
+                                std::uint64_t pd_identity, std::uint32_t key, bool remote,
+                                std::uint64_t address, std::uint64_t length,
+                                std::uint64_t *daemon_address) noexcept {
+    if (key == 0 || length == 0 || daemon_address == nullptr) {
+        return EINVAL;
+    }
+    const std::uint64_t epoch = service.mr_key_epoch();
+    if (epoch != epoch_) {
+        entries_.fill(Entry{});
+        epoch_ = epoch;
+    }
+    // The low key bits are the table index and the local/remote bit.
+    Entry &entry = entries_[key % kEntries];
+    if (entry.key == key && entry.remote == remote &&
+        entry.translation.owner_session == session_id &&
+        entry.translation.pd_identity == pd_identity) {
+        ++hits_;
+        return control::translate_mr_key(entry.translation, remote, address, length,
+                                         daemon_address);
+    }
+    ++misses_;
+    control::MrKeyEntry translation;
+    if (service.find_mr_key(session_id, pd_identity, key, remote, &translation) != 0) {
+        return EINVAL;
+    }
+    entry.key = key;
+    entry.remote = remote;
+    entry.translation = translation;
+    return control::translate_mr_key(translation, remote, address, length, daemon_address);
+}
+
+std::uint64_t MrTranslationCache::hits() const noexcept {
+    return hits_;
+}
+
+std::uint64_t MrTranslationCache::misses() const noexcept {
+    return misses_;
+}
+
+}  // namespace ugdr::worker
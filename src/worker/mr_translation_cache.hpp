@@ -0,0 +1,38 @@
+#pragma once
+
+#include "control/pd_mr_cq.hpp"
+#include "ipc/ipc.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ugdr::worker {
+
+// Direct-mapped cache of MR key translations owned by one worker. Any deregistration or session
+// teardown bumps the service's key epoch, which empties the cache on its next lookup.
+class MrTranslationCache {
+  public:
+    int resolve(const control::PdMrCqService &service, ipc::SessionId session_id,
+                std::uint64_t pd_identity, std::uint32_t key, bool remote, std::uint64_t address,
+                std::uint64_t length, std::uint64_t *daemon_address) noexcept;
+
+    [[nodiscard]] std::uint64_t hits() const noexcept;
+    [[nodiscard]] std::uint64_t misses() const noexcept;
+
+  private:
+    static constexpr std::size_t kEntries = 16;
+
+    struct Entry {
+        std::uint32_t key = 0;
+        bool remote = false;
+        control::MrKeyEntry translation;
+    };
+
+    std::array<Entry, kEntries> entries_{};
+    std::uint64_t epoch_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+
+}  // namespace ugdr::worker
@@ -0,0 +1,191 @@
+#include "worker/shared_memory_transport.hpp"
+
+#include "queue/descriptors.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include <unistd.h>
+
+namespace ugdr::worker {
+namespace {
+
+static_assert(std::is_trivially_copyable_v<RequestDatagram>);
+static_assert(std::is_trivially_copyable_v<ResponseDatagram>);
+
+constexpr std::uint32_t slot_stride_for(std::size_t size) noexcept {
+    return static_cast<std::uint32_t>((size + queue::kSlotAlignment - 1U) &
+                                      ~(queue::kSlotAlignment - 1U));
+}
+
+template <typename T> bool try_push(queue::SharedRing &ring, const T &value) {
+    void *slot = nullptr;
+    if (ring.producer_reserve(&slot) != 0) {
+        return false;
+    }
+    std::memcpy(slot, &value, sizeof(value));
+    return ring.producer_publish() == 0;
+}
+
+template <typename T> bool try_pop(queue::SharedRing &ring, T &value) {
+    const void *slot = nullptr;
+    if (ring.consumer_peek(&slot) != 0) {
+        return false;
+    }
+    std::memcpy(&value, slot, sizeof(value));
+    return ring.consumer_release() == 0;
+}
+
+}  // namespace
+
+bool SharedMemoryTransport::valid() const noexcept {
+    return requests_.valid() && responses_.valid();
+}
+
+int SharedMemoryTransport::duplicate_fds(int *request_descriptor,
+                                         int *response_descriptor) const noexcept {
+    if (request_descriptor == nullptr || response_descriptor == nullptr || !valid()) {
+        return EINVAL;
+    }
+    int request_copy = -1;
+    int status = requests_.duplicate_fd(&request_copy);
+    if (status != 0) {
+        return status;
+    }
+    int response_copy = -1;
+    status = responses_.duplicate_fd(&response_copy);
+    if (status != 0) {
+        (void)::close(request_copy);
+        return status;
+    }
+    *request_descriptor = request_copy;
+    *response_descriptor = response_copy;
+    return 0;
+}
+
+int SharedMemoryTransport::add_peer_mapping(const PeerMemoryMapping &mapping) {
+    constexpr std::uint64_t max_address = std::numeric_limits<std::uint64_t>::max();
+    if (mapping.length == 0 || mapping.peer_address > max_address - mapping.length ||
+        mapping.local_address > max_address - mapping.length) {
+        return EINVAL;
+    }
+    auto next = peer_mappings_.lower_bound(mapping.peer_address);
+    if (next != peer_mappings_.end() &&
+        next->second.peer_address < mapping.peer_address + mapping.length) {
+        return EEXIST;
+    }
+    if (next != peer_mappings_.begin()) {
+        const PeerMemoryMapping &previous = std::prev(next)->second;
+        if (previous.peer_address + previous.length > mapping.peer_address) {
+            return EEXIST;
+        }
+    }
+    peer_mappings_.emplace_hint(next, mapping.peer_address, mapping);
+    return 0;
+}
+
+int SharedMemoryTransport::remove_peer_mapping(std::uint64_t peer_address) noexcept {
+    return peer_mappings_.erase(peer_address) == 0 ? ENOENT : 0;
+}
+
+bool SharedMemoryTransport::translate_source(std::uint64_t address, std::uint32_t length,
+                                             std::uint64_t *local_address) const noexcept {
+    auto mapping = peer_mappings_.upper_bound(address);
+    if (mapping == peer_mappings_.begin()) {
+        return false;
+    }
+    const PeerMemoryMapping &peer = std::prev(mapping)->second;
+    const std::uint64_t offset = address - peer.peer_address;
+    if (offset > peer.length || length > peer.length - offset) {
+        return false;
+    }
+    *local_address = peer.local_address + offset;
+    return true;
+}
+
+bool SharedMemoryTransport::try_push_request(const RequestDatagram &request) {
+    return try_push(requests_, request);
+}
+
+bool SharedMemoryTransport::try_pop_request(RequestDatagram &request) {
+    if (!try_pop(requests_, request)) {
+        return false;
+    }
+    std::uint64_t local_address = 0;
+    request.source_unmapped =
+        request.payload_length != 0 &&
+        !translate_source(request.source_daemon_address, request.payload_length, &local_address);
+    if (request.payload_length != 0 && !request.source_unmapped) {
+        request.source_daemon_address = local_address;
+    }
+    return true;
+}
+
+bool SharedMemoryTransport::try_push_response(const ResponseDatagram &response) {
+    return try_push(responses_, response);
+}
+
+bool SharedMemoryTransport::try_pop_response(ResponseDatagram &response) {
+    return try_pop(responses_, response);
+}
+
+queue::QueueDescriptor shared_memory_request_descriptor(std::uint32_t capacity) noexcept {
+    return {queue::QueueKind::transport, capacity, slot_stride_for(sizeof(RequestDatagram))};
+}
+
+queue::QueueDescriptor shared_memory_response_descriptor(std::uint32_t capacity) noexcept {
+    return {queue::QueueKind::transport, capacity, slot_stride_for(sizeof(ResponseDatagram))};
+}
+
+int create_shared_memory_transport(std::uint32_t request_capacity,
+                                   std::uint32_t response_capacity,
+                                   SharedMemoryTransport *transport) noexcept {
+    if (transport == nullptr || transport->valid()) {
+        return EINVAL;
+    }
+    queue::SharedRing requests;
+    int status =
+        queue::create_shared_ring(shared_memory_request_descriptor(request_capacity), &requests);
+    if (status != 0) {
+        return status;
+    }
+    queue::SharedRing responses;
+    status = queue::create_shared_ring(shared_memory_response_descriptor(response_capacity),
+                                       &responses);
+    if (status != 0) {
+        return status;
+    }
+    transport->requests_ = std::move(requests);
+    transport->responses_ = std::move(responses);
+    return 0;
+}
+
+int attach_shared_memory_transport(int request_descriptor, int response_descriptor,
+                                   std::uint32_t request_capacity,
+                                   std::uint32_t response_capacity,
+                                   SharedMemoryTransport *transport) noexcept {
+    if (transport == nullptr || transport->valid()) {
+        return EINVAL;
+    }
+    queue::SharedRing requests;
+    int status = queue::map_shared_ring(
+        request_descriptor, shared_memory_request_descriptor(request_capacity), &requests);
+    if (status != 0) {
+        return status;
+    }
+    queue::SharedRing responses;
+    status = queue::map_shared_ring(
+        response_descriptor, shared_memory_response_descriptor(response_capacity), &responses);
+    if (status != 0) {
+        return status;
+    }
+    transport->requests_ = std::move(requests);
+    transport->responses_ = std::move(responses);
+    return 0;
+}
+
+}  // namespace ugdr::worker
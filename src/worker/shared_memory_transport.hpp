@@ -0,0 +1,67 @@
+#pragma once
+
+#include "queue/shared_ring.hpp"
+#include "worker/local_transport.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+namespace ugdr::worker {
+
+// A peer daemon's range [peer_address, peer_address + length) as it appears in this process.
+struct PeerMemoryMapping {
+    std::uint64_t peer_address = 0;
+    std::uint64_t length = 0;
+    std::uint64_t local_address = 0;
+
+    bool operator==(const PeerMemoryMapping &) const = default;
+};
+
+// Carries datagrams between two daemons over a pair of shared rings. Requests name their payload
+// by the requesting daemon's address, which the responder only reads through a peer mapping.
+class SharedMemoryTransport final : public DatagramTransport {
+  public:
+    SharedMemoryTransport() noexcept = default;
+
+    [[nodiscard]] bool valid() const noexcept;
+    int duplicate_fds(int *request_descriptor, int *response_descriptor) const noexcept;
+
+    // Mappings may not overlap; adding one that does fails with EEXIST.
+    int add_peer_mapping(const PeerMemoryMapping &mapping);
+    int remove_peer_mapping(std::uint64_t peer_address) noexcept;
+
+    bool try_push_request(const RequestDatagram &request) override;
+    // Rewrites source_daemon_address to the local address of the payload. A request whose payload
+    // is not wholly inside one peer mapping comes out with source_unmapped set and its address
+    // untouched, for the responder to fail.
+    bool try_pop_request(RequestDatagram &request) override;
+
+    bool try_push_response(const ResponseDatagram &response) override;
+    bool try_pop_response(ResponseDatagram &response) override;
+
+  private:
+    friend int create_shared_memory_transport(std::uint32_t, std::uint32_t,
+                                              SharedMemoryTransport *) noexcept;
+    friend int attach_shared_memory_transport(int, int, std::uint32_t, std::uint32_t,
+                                              SharedMemoryTransport *) noexcept;
+
+    bool translate_source(std::uint64_t address, std::uint32_t length,
+                          std::uint64_t *local_address) const noexcept;
+
+    queue::SharedRing requests_;
+    queue::SharedRing responses_;
+    std::map<std::uint64_t, PeerMemoryMapping> peer_mappings_;
+};
+
+queue::QueueDescriptor shared_memory_request_descriptor(std::uint32_t capacity) noexcept;
+queue::QueueDescriptor shared_memory_response_descriptor(std::uint32_t capacity) noexcept;
+int create_shared_memory_transport(std::uint32_t request_capacity,
+                                   std::uint32_t response_capacity,
+                                   SharedMemoryTransport *transport) noexcept;
+int attach_shared_memory_transport(int request_descriptor, int response_descriptor,
+                                   std::uint32_t request_capacity,
+                                   std::uint32_t response_capacity,
+                                   SharedMemoryTransport *transport) noexcept;
+
+}  // namespace ugdr::worker
@@ -0,0 +1,133 @@
+#include "worker/timer_wheel.hpp"
+
+#include <algorithm>
+
+namespace ugdr::worker {
+
+TimerWheel::TimerWheel(std::chrono::nanoseconds resolution, std::size_t slot_count,
+                       Clock::time_point origin)
+    : resolution_(std::max(resolution, std::chrono::nanoseconds(1))), origin_(origin),
+      slots_(std::max<std::size_t>(slot_count, 1), kNoNode) {
+}
+
+TimerWheel::TimerId TimerWheel::schedule(Clock::time_point deadline, std::uint64_t key) {
+    std::uint32_t index = 0;
+    if (!free_nodes_.empty()) {
+        index = free_nodes_.back();
+        free_nodes_.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    Node &node = nodes_[index];
+    node.key = key;
+    node.deadline_tick = std::max(tick_at(deadline), current_tick_ + 1);
+    node.active = true;
+    link(index);
+    ++size_;
+    return (static_cast<TimerId>(node.generation) << 32U) | (static_cast<TimerId>(index) + 1);
+}
+
+bool TimerWheel::cancel(TimerId timer) noexcept {
+    const std::uint64_t slot_index = timer & UINT32_MAX;
+    if (slot_index == 0 || slot_index > nodes_.size()) {
+        return false;
+    }
+    const auto index = static_cast<std::uint32_t>(slot_index - 1);
+    Node &node = nodes_[index];
+    if (!node.active || node.generation != static_cast<std::uint32_t>(timer >> 32U)) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+std::size_t TimerWheel::expire(Clock::time_point now, std::vector<std::uint64_t> *expired) {
+    const std::size_t before = expired->size();
+    const std::uint64_t now_tick = tick_at(now);
+    if (size_ == 0) {
+        current_tick_ = std::max(current_tick_, now_tick);
+        return 0;
+    }
+    if (now_tick > current_tick_ && now_tick - current_tick_ >= slots_.size()) {
+        for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+            expire_slot(slot, now_tick, expired);
+        }
+        current_tick_ = now_tick;
+    }
+    while (current_tick_ < now_tick) {
+        ++current_tick_;
+        expire_slot(current_tick_ % slots_.size(), current_tick_, expired);
+    }
+    return expired->size() - before;
+}
+
+std::size_t TimerWheel::size() const noexcept {
+    return size_;
+}
+
+bool TimerWheel::empty() const noexcept {
+    return size_ == 0;
+}
+
+std::uint64_t TimerWheel::tick_at(Clock::time_point time) const noexcept {
+    if (time <= origin_) {
+        return 0;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin_);
+    return static_cast<std::uint64_t>((elapsed.count() + resolution_.count() - 1) /
+                                      resolution_.count());
+}
+
+void TimerWheel::link(std::uint32_t index) noexcept {
+    Node &node = nodes_[index];
+    std::uint32_t &head = slots_[node.deadline_tick % slots_.size()];
+    node.previous = kNoNode;
+    node.next = head;
+    if (head != kNoNode) {
+        nodes_[head].previous = index;
+    }
+    head = index;
+}
+
+void TimerWheel::unlink(std::uint32_t index) noexcept {
+    Node &node = nodes_[index];
+    if (node.previous != kNoNode) {
+        nodes_[node.previous].next = node.next;
+    } else {
+        slots_[node.deadline_tick % slots_.size()] = node.next;
+    }
+    if (node.next != kNoNode) {
+        nodes_[node.next].previous = node.previous;
+    }
+    node.previous = kNoNode;
+    node.next = kNoNode;
+}
+
+void TimerWheel::release(std::uint32_t index) noexcept {
+    Node &node = nodes_[index];
+    node.active = false;
+    ++node.generation;
+    if (node.generation == 0) {
+        node.generation = 1;
+    }
+    free_nodes_.push_back(index);
+    --size_;
+}
+
+void TimerWheel::expire_slot(std::size_t slot, std::uint64_t tick,
+                             std::vector<std::uint64_t> *expired) {
+    std::uint32_t index = slots_[slot];
+    while (index != kNoNode) {
+        const std::uint32_t next = nodes_[index].next;
+        if (nodes_[index].deadline_tick <= tick) {
+            expired->push_back(nodes_[index].key);
+            unlink(index);
+            release(index);
+        }
+        index = next;
+    }
+}
+
+}  // namespace ugdr::worker
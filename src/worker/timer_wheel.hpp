@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ugdr::worker {
+
+class TimerWheel {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = std::uint64_t;
+
+    static constexpr TimerId kInvalidTimer = 0;
+
+    TimerWheel(std::chrono::nanoseconds resolution, std::size_t slot_count,
+               Clock::time_point origin = Clock::now());
+
+    TimerId schedule(Clock::time_point deadline, std::uint64_t key);
+    bool cancel(TimerId timer) noexcept;
+    std::size_t expire(Clock::time_point now, std::vector<std::uint64_t> *expired);
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+  private:
+    static constexpr std::uint32_t kNoNode = UINT32_MAX;
+
+    struct Node {
+        std::uint64_t key = 0;
+        std::uint64_t deadline_tick = 0;
+        std::uint32_t previous = kNoNode;
+        std::uint32_t next = kNoNode;
+        std::uint32_t generation = 1;
+        bool active = false;
+    };
+
+    [[nodiscard]] std::uint64_t tick_at(Clock::time_point time) const noexcept;
+    void link(std::uint32_t index) noexcept;
+    void unlink(std::uint32_t index) noexcept;
+    void release(std::uint32_t index) noexcept;
+    void expire_slot(std::size_t slot, std::uint64_t tick, std::vector<std::uint64_t> *expired);
+
+    std::chrono::nanoseconds resolution_;
+    Clock::time_point origin_;
+    std::uint64_t current_tick_ = 0;
+    std::vector<std::uint32_t> slots_;
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> free_nodes_;
+    std::size_t size_ = 0;
+};
+
+}  // namespace ugdr::worker
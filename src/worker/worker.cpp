@@ -5,10 +5,12 @@
 #include "ugdr/api.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <cstring>
+#include <iterator>
 #include <limits>
 #include <utility>
 
@@ -33,10 +35,41 @@ std::uint32_t completion_status(DatagramResult result) noexcept {
         return UGDR_WC_REM_OP_ERR;
     case DatagramResult::backend_error:
         return UGDR_WC_GENERAL_ERR;
+    case DatagramResult::retry_exceeded:
+        return UGDR_WC_RETRY_EXC_ERR;
     }
     return UGDR_WC_GENERAL_ERR;
 }
 
+constexpr std::array<std::uint32_t, 32> kRnrTimerMicroseconds = {
+    655360, 10,    20,    30,    40,     60,     80,     120,    160,   240,   320,
+    480,    640,   960,   1280,  1920,   2560,   3840,   5120,   7680,  10240, 15360,
+    20480,  30720, 40960, 61440, 81920,  122880, 163840, 245760, 327680, 491520,
+};
+
+std::chrono::microseconds rnr_timer_delay(std::uint8_t encoded) noexcept {
+    return std::chrono::microseconds(kRnrTimerMicroseconds[encoded & 31U]);
+}
+
+bool chunk_arrived(const std::vector<std::uint64_t> &arrived, std::uint32_t index) noexcept {
+    return (arrived[index / 64U] & (UINT64_C(1) << (index % 64U))) != 0;
+}
+
+bool range_overlaps(const std::map<std::uint64_t, std::uint64_t> &ranges, std::uint64_t offset,
+                    std::uint64_t length) noexcept {
+    const auto next = ranges.lower_bound(offset);
+    if (next != ranges.end() && next->first < offset + length) {
+        return true;
+    }
+    return next != ranges.begin() && std::prev(next)->second > offset;
+}
+
+std::chrono::nanoseconds ack_timeout(std::uint8_t encoded) noexcept {
+    const unsigned int exponent =
+        std::max<unsigned int>(encoded & 31U, LoopWorker::kMinimumAckTimeout);
+    return std::chrono::nanoseconds(INT64_C(4096) << exponent);
+}
+
 queue::CompletionEntry send_completion(std::uint64_t wr_id, std::uint32_t qp_num,
                                        DatagramResult result) noexcept {
     queue::CompletionEntry entry{};
@@ -49,15 +82,17 @@ queue::CompletionEntry send_completion(std::uint64_t wr_id, std::uint32_t qp_num
 
 }  // namespace
 
-LoopWorker::LoopWorker(control::QpService &service, std::uint32_t qp_num, LocalTransport &transport,
-                       CopyBackend &backend, LoopWorkerRole role, std::size_t payload_bytes,
-                       ParentCompletionObserver *observer)
+LoopWorker::LoopWorker(control::QpService &service, std::uint32_t qp_num,
+                       DatagramTransport &transport, CopyBackend &backend, LoopWorkerRole role,
+                       std::size_t payload_bytes, ParentCompletionObserver *observer,
+                       const FlowControlOptions &flow_control, ChunkOrdering chunk_ordering)
     : service_(service), qp_num_(qp_num), transport_(transport), backend_(backend), role_(role),
       payload_bytes_(payload_bytes == 0
                          ? kDefaultPayloadBytes
                          : std::min(payload_bytes, static_cast<std::size_t>(
                                                        std::numeric_limits<std::uint32_t>::max()))),
-      observer_(observer) {
+      observer_(observer), flow_control_(flow_control), chunk_ordering_(chunk_ordering),
+      timers_(kTimerResolution, kTimerSlots) {
 }
 
 bool LoopWorker::progress_once() {
@@ -91,16 +126,40 @@ bool LoopWorker::progress_once() {
             progressed = true;
         }
     } else {
+        if (view.state == control::kQpStateErr && !requester_error_) {
+            enter_requester_error(view);
+        }
         while (try_response(view)) {
             progressed = true;
         }
+        if (try_timers(view)) {
+            progressed = true;
+        }
         while (try_send(view)) {
             progressed = true;
         }
     }
+    if (view.send_cq_moderator->flush_if_due(*view.send_cq)) {
+        progressed = true;
+    }
+    if (view.receive_cq_moderator->flush_if_due(*view.receive_cq)) {
+        progressed = true;
+    }
     return progressed;
 }
 
+const FlowControlCounters &LoopWorker::flow_control_counters() const noexcept {
+    return flow_control_.counters();
+}
+
+const RetryCounters &LoopWorker::retry_counters() const noexcept {
+    return retry_counters_;
+}
+
+const MrTranslationCache &LoopWorker::mr_translation_cache() const noexcept {
+    return mr_cache_;
+}
+
 bool LoopWorker::try_backend_completions(const control::WorkerQpView &) {
     std::array<BackendCompletion, kBackendBatchCapacity> completions{};
     const std::size_t completion_count =
@@ -158,7 +217,7 @@ bool LoopWorker::try_parent_response(const control::WorkerQpView &view) {
         return true;
     }
     ResponderInflight &parent = inflight->second;
-    if (parent.next_payload_index != parent.payload_count ||
+    if (parent.received_count != parent.payload_count ||
         parent.terminal_count != parent.payload_count) {
         return false;
     }
@@ -181,9 +240,9 @@ bool LoopWorker::try_parent_response(const control::WorkerQpView &view) {
             return false;
         }
     }
-    if (!transport_.try_push_response({parent_request_id, result, 0})) {
+    if (!transport_.try_push_response(make_response(parent_request_id, result))) {
         if (produce_receive) {
-            (void)view.receive_cq->producer_publish(0);
+            (void)view.receive_cq_moderator->commit(*view.receive_cq, 0);
         }
         return false;
     }
@@ -196,14 +255,20 @@ bool LoopWorker::try_parent_response(const control::WorkerQpView &view) {
         entry.immediate_data = parent.immediate_data;
         entry.qp_num = view.qp_num;
         entry.flags = UGDR_WC_WITH_IMM;
-        std::memcpy(receive_slot, &entry, sizeof(entry));
-        if (view.receive_cq->producer_publish() != 0) {
+        (void)queue::write_completion(*view.receive_cq, receive_slot, entry);
+        if (view.receive_cq_moderator->commit(*view.receive_cq, 1) != 0) {
             return false;
         }
     }
 
     responder_inflight_.erase(inflight);
     responder_order_.pop_front();
+    responded_.insert_or_assign(parent_request_id, result);
+    responded_order_.push_back(parent_request_id);
+    if (responded_order_.size() > kResponseHistory) {
+        responded_.erase(responded_order_.front());
+        responded_order_.pop_front();
+    }
     return true;
 }
 
@@ -211,23 +276,52 @@ bool LoopWorker::try_response(const control::WorkerQpView &view) {
     bool loaded = false;
     if (!pending_response_.has_value()) {
         ResponseDatagram response;
-        if (!transport_.try_pop_response(response)) {
+        if (!local_responses_.empty()) {
+            response = local_responses_.front();
+            local_responses_.pop_front();
+        } else if (!transport_.try_pop_response(response)) {
             return false;
         }
         pending_response_ = response;
         loaded = true;
     }
     const auto inflight = requester_inflight_.find(pending_response_->parent_request_id);
-    if (inflight == requester_inflight_.end()) {
+    if (inflight == requester_inflight_.end() || requester_error_) {
+        ++retry_counters_.duplicate_responses;
         pending_response_.reset();
         return true;
     }
+    const bool rnr = pending_response_->result == DatagramResult::rnr;
+    if (rnr) {
+        if (pending_response_->epoch != send_epoch_) {
+            pending_response_.reset();
+            return true;
+        }
+        if (loaded) {
+            ++retry_counters_.rnr_naks_received;
+        }
+        if (view.rnr_retry == kInfiniteRnrRetry ||
+            inflight->second.rnr_attempts < view.rnr_retry) {
+            ++inflight->second.rnr_attempts;
+            flow_control_.on_rnr(pending_response_->credits);
+            rewind_requester(view, pending_response_->parent_request_id);
+            if (rnr_timer_ != TimerWheel::kInvalidTimer) {
+                (void)timers_.cancel(rnr_timer_);
+            }
+            rnr_timer_ = timers_.schedule(std::chrono::steady_clock::now() +
+                                              rnr_timer_delay(pending_response_->rnr_delay),
+                                          kRnrTimerKey);
+            rnr_waiting_ = true;
+            pending_response_.reset();
+            return true;
+        }
+    }
     const bool needs_completion =
         pending_response_->result != DatagramResult::success || inflight->second.signaled;
     if (needs_completion) {
         const queue::CompletionEntry entry =
             send_completion(inflight->second.wr_id, view.qp_num, pending_response_->result);
-        if (queue::produce_completions(*view.send_cq, &entry, 1) != 1) {
+        if (queue::produce_completions(*view.send_cq, *view.send_cq_moderator, &entry, 1) != 1) {
             return loaded;
         }
     }
@@ -237,8 +331,25 @@ bool LoopWorker::try_response(const control::WorkerQpView &view) {
                                          inflight->second.payload_count,
                                          pending_response_->result});
     }
+    const bool exhausted = rnr || pending_response_->result == DatagramResult::retry_exceeded;
+    flow_control_.on_response(inflight->second.payload_count, pending_response_->credits,
+                              exhausted,
+                              std::chrono::steady_clock::now() - inflight->second.posted_at);
+    if (inflight->second.timer != TimerWheel::kInvalidTimer) {
+        (void)timers_.cancel(inflight->second.timer);
+    }
+    if (rnr) {
+        ++retry_counters_.rnr_retry_exhausted;
+    }
     requester_inflight_.erase(inflight);
+    while (!requester_order_.empty() && !requester_inflight_.contains(requester_order_.front())) {
+        requester_order_.pop_front();
+    }
     pending_response_.reset();
+    if (exhausted) {
+        // Later parents must not land after this one failed, so the QP errors out and flushes.
+        enter_requester_error(view);
+    }
     return true;
 }
 
@@ -253,28 +364,54 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         loaded = true;
     }
     RequestDatagram &request = *pending_request_;
+    if (responder_discarding_) {
+        if (static_cast<std::int32_t>(request.epoch - responder_discard_epoch_) <= 0) {
+            ++retry_counters_.discarded_requests;
+            pending_request_.reset();
+            return true;
+        }
+        responder_discarding_ = false;
+    }
     if (request.target_qp_num != view.qp_num ||
         request.parent_total_length > std::numeric_limits<std::uint32_t>::max()) {
-        if (!transport_.try_push_response(
-                {request.parent_request_id, DatagramResult::remote_invalid_request, 0})) {
+        if (!transport_.try_push_response(make_response(request.parent_request_id,
+                                                        DatagramResult::remote_invalid_request))) {
             return loaded;
         }
         pending_request_.reset();
         return true;
     }
 
+    const bool any_order = chunk_ordering_ == ChunkOrdering::any_order;
     auto inflight = responder_inflight_.find(request.parent_request_id);
     if (inflight == responder_inflight_.end()) {
+        const auto responded = responded_.find(request.parent_request_id);
+        if (responded != responded_.end()) {
+            if (request.payload_index == 0 &&
+                !transport_.try_push_response(
+                    make_response(request.parent_request_id, responded->second))) {
+                return loaded;
+            }
+            ++retry_counters_.discarded_requests;
+            pending_request_.reset();
+            return true;
+        }
+
         const bool zero_parent = request.payload_count == 0;
+        const bool first_position =
+            (request.payload_index == 0 && request.payload_offset == 0) ||
+            (any_order && request.payload_index < request.payload_count &&
+             request.payload_offset < request.parent_total_length &&
+             request.payload_length <= request.parent_total_length - request.payload_offset);
         const bool valid_first =
-            request.payload_index == 0 && request.payload_offset == 0 &&
+            first_position &&
             ((zero_parent && request.parent_total_length == 0 && request.payload_length == 0) ||
              (!zero_parent && request.parent_total_length != 0 && request.payload_length != 0 &&
               request.payload_length <= request.parent_total_length &&
               request.payload_count <= request.parent_total_length));
         if (!valid_first) {
-            if (!transport_.try_push_response(
-                    {request.parent_request_id, DatagramResult::remote_invalid_request, 0})) {
+            if (!transport_.try_push_response(make_response(
+                    request.parent_request_id, DatagramResult::remote_invalid_request))) {
                 return loaded;
             }
             pending_request_.reset();
@@ -282,11 +419,11 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         }
 
         std::uint64_t target_daemon_address = 0;
-        if (service_.resolve_rkey(view.session_id, view.pd_identity, request.rkey,
-                                  request.remote_address, request.parent_total_length,
-                                  &target_daemon_address) != 0) {
-            if (!transport_.try_push_response(
-                    {request.parent_request_id, DatagramResult::remote_access_error, 0})) {
+        if (mr_cache_.resolve(service_, view.session_id, view.pd_identity, request.rkey, true,
+                              request.remote_address, request.parent_total_length,
+                              &target_daemon_address) != 0) {
+            if (!transport_.try_push_response(make_response(
+                    request.parent_request_id, DatagramResult::remote_access_error))) {
                 return loaded;
             }
             pending_request_.reset();
@@ -298,7 +435,18 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         if (with_immediate) {
             const void *receive_slot = nullptr;
             if (view.receive_queue->consumer_peek(&receive_slot) != 0) {
-                return loaded;
+                ResponseDatagram response =
+                    make_response(request.parent_request_id, DatagramResult::rnr);
+                response.rnr_delay = view.min_rnr_timer;
+                response.epoch = request.epoch;
+                if (!transport_.try_push_response(response)) {
+                    return loaded;
+                }
+                ++retry_counters_.rnr_naks_sent;
+                responder_discarding_ = true;
+                responder_discard_epoch_ = request.epoch;
+                pending_request_.reset();
+                return true;
             }
             receive = static_cast<const queue::ReceiveWqeHeader *>(receive_slot);
         }
@@ -315,9 +463,13 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         parent.payload_count = request.payload_count;
         parent.terminal.resize(request.payload_count, 0);
         parent.results.resize(request.payload_count, DatagramResult::success);
+        if (any_order) {
+            parent.arrived.resize((static_cast<std::size_t>(request.payload_count) + 63) / 64, 0);
+        }
         parent.has_receive = receive != nullptr;
         parent.receive_wr_id = receive == nullptr ? 0 : receive->wr_id;
         parent.byte_length = static_cast<std::uint32_t>(request.parent_total_length);
+        parent.epoch = request.epoch;
         const auto inserted =
             responder_inflight_.emplace(request.parent_request_id, std::move(parent));
         if (!inserted.second) {
@@ -325,10 +477,35 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         }
         responder_order_.push_back(request.parent_request_id);
         inflight = inserted.first;
+        // Other QPs pop the same SRQ, so claim the WQE now rather than on the first payload.
+        if (receive != nullptr && view.shared_receive_queue) {
+            if (view.receive_queue->consumer_release() != 0) {
+                return false;
+            }
+            inflight->second.receive_consumed = true;
+        }
     }
 
     ResponderInflight &parent = inflight->second;
     const bool zero_parent = parent.payload_count == 0;
+    const bool duplicate =
+        any_order && !zero_parent
+            ? request.payload_index < parent.payload_count &&
+                  chunk_arrived(parent.arrived, request.payload_index)
+            : request.payload_index < parent.next_payload_index;
+    if (request.epoch != parent.epoch) {
+        if (duplicate) {
+            ++retry_counters_.discarded_requests;
+            pending_request_.reset();
+            return true;
+        }
+        parent.epoch = request.epoch;
+    }
+    const bool in_position =
+        any_order ? request.payload_index < parent.payload_count && !duplicate
+                  : request.payload_index == parent.next_payload_index &&
+                        request.payload_index < parent.payload_count &&
+                        request.payload_offset == parent.next_payload_offset;
     const bool valid_payload =
         request.source_qp_num == parent.source_qp_num &&
         request.target_qp_num == parent.target_qp_num && request.opcode == parent.opcode &&
@@ -338,9 +515,7 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         request.payload_count == parent.payload_count &&
         ((zero_parent && request.payload_index == 0 && request.payload_offset == 0 &&
           request.payload_length == 0) ||
-         (!zero_parent && request.payload_index == parent.next_payload_index &&
-          request.payload_index < parent.payload_count &&
-          request.payload_offset == parent.next_payload_offset && request.payload_length != 0 &&
+         (!zero_parent && in_position && request.payload_length != 0 &&
           request.payload_offset <= parent.parent_total_length &&
           request.payload_length <= parent.parent_total_length - request.payload_offset));
     if (!valid_payload) {
@@ -359,6 +534,18 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         return true;
     }
 
+    if (any_order &&
+        range_overlaps(parent.arrived_ranges, request.payload_offset, request.payload_length)) {
+        // Overlapping chunks can add up to the parent's length and still leave bytes unwritten.
+        fail_chunk(parent, request, DatagramResult::remote_invalid_request);
+        pending_request_.reset();
+        return true;
+    }
+    if (request.source_unmapped) {
+        fail_chunk(parent, request, DatagramResult::remote_access_error);
+        pending_request_.reset();
+        return true;
+    }
     if (pending_backend_request_count_ == pending_backend_requests_.size()) {
         return loaded;
     }
@@ -379,17 +566,68 @@ bool LoopWorker::try_request(const control::WorkerQpView &view) {
         }
         parent.receive_consumed = true;
     }
-    ++parent.next_payload_index;
-    parent.next_payload_offset += request.payload_length;
-    if (parent.next_payload_index == parent.payload_count &&
-        parent.next_payload_offset != parent.parent_total_length) {
-        parent.parent_error = DatagramResult::remote_invalid_request;
-    }
+    record_chunk(parent, request);
     pending_request_.reset();
     return true;
 }
 
+void LoopWorker::record_chunk(ResponderInflight &parent, const RequestDatagram &request) {
+    if (chunk_ordering_ == ChunkOrdering::any_order) {
+        parent.arrived[request.payload_index / 64U] |= UINT64_C(1) << (request.payload_index % 64U);
+        parent.arrived_ranges.emplace(request.payload_offset,
+                                      request.payload_offset + request.payload_length);
+    } else {
+        ++parent.next_payload_index;
+        parent.next_payload_offset += request.payload_length;
+    }
+    ++parent.received_count;
+    parent.received_bytes += request.payload_length;
+    // Chunks never overlap, so the byte count proves the whole target range was covered.
+    if (parent.received_count == parent.payload_count &&
+        parent.received_bytes != parent.parent_total_length) {
+        parent.parent_error = DatagramResult::remote_invalid_request;
+    }
+}
+
+// Counts the chunk as arrived and finished with result, without submitting it to the backend, so
+// the parent completes through try_parent_response with a single response.
+void LoopWorker::fail_chunk(ResponderInflight &parent, const RequestDatagram &request,
+                            DatagramResult result) {
+    if (chunk_ordering_ == ChunkOrdering::any_order) {
+        parent.arrived[request.payload_index / 64U] |= UINT64_C(1) << (request.payload_index % 64U);
+        ++parent.received_count;
+        parent.received_bytes += request.payload_length;
+    } else {
+        record_chunk(parent, request);
+    }
+    parent.terminal[request.payload_index] = 1;
+    parent.results[request.payload_index] = result;
+    ++parent.terminal_count;
+}
+
 bool LoopWorker::try_send(const control::WorkerQpView &view) {
+    if (requester_error_) {
+        return try_flush_send(view);
+    }
+    if (!pending_send_.has_value() && rnr_waiting_) {
+        return false;
+    }
+    if (!pending_send_.has_value() && !retransmit_queue_.empty()) {
+        const auto inflight = requester_inflight_.find(retransmit_queue_.front());
+        retransmit_queue_.pop_front();
+        if (inflight == requester_inflight_.end()) {
+            return true;
+        }
+        PendingSend parent = inflight->second.send;
+        parent.segment_index = 0;
+        parent.segment_offset = 0;
+        parent.payload_offset = 0;
+        parent.payload_index = 0;
+        parent.zero_payload_sent = false;
+        parent.from_send_queue = false;
+        pending_send_ = std::move(parent);
+        ++retry_counters_.retransmitted_parents;
+    }
     if (!pending_send_.has_value()) {
         const void *send_slot = nullptr;
         if (view.send_queue->consumer_peek(&send_slot) != 0) {
@@ -415,6 +653,7 @@ bool LoopWorker::try_send(const control::WorkerQpView &view) {
         parent.remote_address = send.remote_address;
         parent.rkey = send.rkey;
         parent.immediate_data = send.immediate_data;
+        parent.from_send_queue = true;
         parent.source_segments.reserve(send.sge_count);
 
         std::uint64_t payload_count = 0;
@@ -425,9 +664,9 @@ bool LoopWorker::try_send(const control::WorkerQpView &view) {
                 return complete_send_error(view, send, UGDR_WC_LOC_LEN_ERR);
             }
             std::uint64_t daemon_address = 0;
-            if (service_.resolve_lkey(view.session_id, view.pd_identity, sges[index].lkey,
-                                      sges[index].address, sges[index].length,
-                                      &daemon_address) != 0) {
+            if (mr_cache_.resolve(service_, view.session_id, view.pd_identity, sges[index].lkey,
+                                  false, sges[index].address, sges[index].length,
+                                  &daemon_address) != 0) {
                 return complete_send_error(view, send, UGDR_WC_LOC_PROT_ERR);
             }
             parent.total_length += sges[index].length;
@@ -442,16 +681,27 @@ bool LoopWorker::try_send(const control::WorkerQpView &view) {
             return complete_send_error(view, send, UGDR_WC_LOC_LEN_ERR);
         }
         parent.payload_count = static_cast<std::uint32_t>(payload_count);
+        if (!flow_control_.try_admit(parent.payload_count)) {
+            (void)view.send_queue->consumer_release(0);
+            return false;
+        }
         const auto inserted = requester_inflight_.emplace(
-            parent.parent_request_id, RequesterInflight{parent.wr_id, parent.signaled,
-                                                        parent.total_length, parent.payload_count});
+            parent.parent_request_id,
+            RequesterInflight{parent.wr_id, parent.signaled, parent.total_length,
+                              parent.payload_count, std::chrono::steady_clock::now(), 0, 0,
+                              TimerWheel::kInvalidTimer, {}});
         if (!inserted.second) {
             return false;
         }
+        requester_order_.push_back(parent.parent_request_id);
         pending_send_ = std::move(parent);
     }
 
     PendingSend &parent = *pending_send_;
+    if (!parent.from_send_queue && !requester_inflight_.contains(parent.parent_request_id)) {
+        pending_send_.reset();
+        return true;
+    }
     RequestDatagram request;
     request.parent_request_id = parent.parent_request_id;
     request.source_qp_num = parent.source_qp_num;
@@ -462,6 +712,7 @@ bool LoopWorker::try_send(const control::WorkerQpView &view) {
     request.immediate_data = parent.immediate_data;
     request.parent_total_length = parent.total_length;
     request.payload_count = parent.payload_count;
+    request.epoch = send_epoch_;
 
     if (parent.total_length == 0) {
         if (parent.zero_payload_sent) {
@@ -497,15 +748,154 @@ bool LoopWorker::try_send(const control::WorkerQpView &view) {
     if (!finished) {
         return true;
     }
-    if (view.send_queue->consumer_release() != 0) {
+    if (parent.from_send_queue) {
+        if (view.send_queue->consumer_release() != 0) {
+            return false;
+        }
+        advance_sequence();
+    }
+    const auto inflight = requester_inflight_.find(parent.parent_request_id);
+    if (inflight != requester_inflight_.end()) {
+        arm_retransmit_timer(view, parent.parent_request_id, inflight->second);
+        if (parent.from_send_queue) {
+            inflight->second.send = std::move(parent);
+        }
+    }
+    pending_send_.reset();
+    return true;
+}
+
+bool LoopWorker::try_flush_send(const control::WorkerQpView &view) {
+    while (!requester_order_.empty()) {
+        const auto inflight = requester_inflight_.find(requester_order_.front());
+        if (inflight == requester_inflight_.end()) {
+            requester_order_.pop_front();
+            continue;
+        }
+        queue::CompletionEntry entry{};
+        entry.wr_id = inflight->second.wr_id;
+        entry.status = UGDR_WC_WR_FLUSH_ERR;
+        entry.opcode = UGDR_WC_RDMA_WRITE;
+        entry.qp_num = view.qp_num;
+        if (queue::produce_completions(*view.send_cq, *view.send_cq_moderator, &entry, 1) != 1) {
+            return false;
+        }
+        flow_control_.on_flush(inflight->second.payload_count);
+        requester_inflight_.erase(inflight);
+        requester_order_.pop_front();
+        return true;
+    }
+    const void *send_slot = nullptr;
+    if (view.send_queue->consumer_peek(&send_slot) != 0) {
+        return false;
+    }
+    return complete_send_error(view, *static_cast<const queue::SendWqeHeader *>(send_slot),
+                               UGDR_WC_WR_FLUSH_ERR);
+}
+
+bool LoopWorker::try_timers(const control::WorkerQpView &view) {
+    if (timers_.empty()) {
+        return false;
+    }
+    expired_timers_.clear();
+    if (timers_.expire(std::chrono::steady_clock::now(), &expired_timers_) == 0) {
         return false;
     }
+    for (const std::uint64_t key : expired_timers_) {
+        if (key == kRnrTimerKey) {
+            rnr_timer_ = TimerWheel::kInvalidTimer;
+            rnr_waiting_ = false;
+            continue;
+        }
+        const auto inflight = requester_inflight_.find(key);
+        if (inflight == requester_inflight_.end() ||
+            inflight->second.timer == TimerWheel::kInvalidTimer) {
+            continue;
+        }
+        inflight->second.timer = TimerWheel::kInvalidTimer;
+        ++retry_counters_.timeouts;
+        if (inflight->second.timeout_attempts < view.retry_count) {
+            ++inflight->second.timeout_attempts;
+            rewind_requester(view, key);
+        } else {
+            ++retry_counters_.retry_exhausted;
+            local_responses_.push_back({key, DatagramResult::retry_exceeded, 0, 0, send_epoch_});
+        }
+    }
+    return true;
+}
+
+void LoopWorker::arm_retransmit_timer(const control::WorkerQpView &view,
+                                      std::uint64_t parent_request_id, RequesterInflight &parent) {
+    if (parent.timer != TimerWheel::kInvalidTimer) {
+        (void)timers_.cancel(parent.timer);
+        parent.timer = TimerWheel::kInvalidTimer;
+    }
+    if (view.timeout != 0) {
+        parent.timer = timers_.schedule(
+            std::chrono::steady_clock::now() + ack_timeout(view.timeout), parent_request_id);
+    }
+}
+
+void LoopWorker::rewind_requester(const control::WorkerQpView &view,
+                                  std::uint64_t first_parent_request_id) {
+    if (pending_send_.has_value()) {
+        if (pending_send_->from_send_queue) {
+            (void)view.send_queue->consumer_release();
+            advance_sequence();
+            const auto inflight = requester_inflight_.find(pending_send_->parent_request_id);
+            if (inflight != requester_inflight_.end()) {
+                inflight->second.send = std::move(*pending_send_);
+            }
+        }
+        pending_send_.reset();
+    }
+    retransmit_queue_.clear();
+    bool rewinding = false;
+    for (const std::uint64_t parent_request_id : requester_order_) {
+        rewinding = rewinding || parent_request_id == first_parent_request_id;
+        const auto inflight =
+            rewinding ? requester_inflight_.find(parent_request_id) : requester_inflight_.end();
+        if (inflight == requester_inflight_.end()) {
+            continue;
+        }
+        if (inflight->second.timer != TimerWheel::kInvalidTimer) {
+            (void)timers_.cancel(inflight->second.timer);
+            inflight->second.timer = TimerWheel::kInvalidTimer;
+        }
+        retransmit_queue_.push_back(parent_request_id);
+    }
+    ++send_epoch_;
+}
+
+void LoopWorker::enter_requester_error(const control::WorkerQpView &view) {
+    requester_error_ = true;
+    (void)service_.worker_enter_error(view.qp_num);
+    if (pending_send_.has_value() && pending_send_->from_send_queue) {
+        (void)view.send_queue->consumer_release();
+        advance_sequence();
+    }
     pending_send_.reset();
+    retransmit_queue_.clear();
+    local_responses_.clear();
+    if (rnr_timer_ != TimerWheel::kInvalidTimer) {
+        (void)timers_.cancel(rnr_timer_);
+        rnr_timer_ = TimerWheel::kInvalidTimer;
+    }
+    rnr_waiting_ = false;
+    for (auto &[parent_request_id, parent] : requester_inflight_) {
+        if (parent.timer != TimerWheel::kInvalidTimer) {
+            (void)timers_.cancel(parent.timer);
+            parent.timer = TimerWheel::kInvalidTimer;
+        }
+    }
+}
+
+void LoopWorker::advance_sequence() noexcept {
     ++next_sequence_;
     if (next_sequence_ == 0) {
         next_sequence_ = 1;
     }
-    return true;
 }
 
 bool LoopWorker::complete_send_error(const control::WorkerQpView &view,
@@ -515,7 +905,7 @@ bool LoopWorker::complete_send_error(const control::WorkerQpView &view,
     entry.status = status;
     entry.opcode = UGDR_WC_RDMA_WRITE;
     entry.qp_num = view.qp_num;
-    if (queue::produce_completions(*view.send_cq, &entry, 1) != 1) {
+    if (queue::produce_completions(*view.send_cq, *view.send_cq_moderator, &entry, 1) != 1) {
         (void)view.send_queue->consumer_release(0);
         return false;
     }
@@ -526,4 +916,9 @@ std::uint64_t LoopWorker::next_request_id() noexcept {
     return (static_cast<std::uint64_t>(qp_num_) << 32U) | next_sequence_;
 }
 
+ResponseDatagram LoopWorker::make_response(std::uint64_t parent_request_id,
+                                           DatagramResult result) const noexcept {
+    return {parent_request_id, result, 0, flow_control_.advertise(pending_backend_request_count_)};
+}
+
 }  // namespace ugdr::worker
@@ -3,12 +3,17 @@
 #include "control/qp.hpp"
 #include "queue/descriptors.hpp"
 #include "worker/copy_backend.hpp"
+#include "worker/flow_control.hpp"
 #include "worker/local_transport.hpp"
+#include "worker/mr_translation_cache.hpp"
+#include "worker/timer_wheel.hpp"
 
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
+#include <map>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -31,37 +36,57 @@ class ParentCompletionObserver {
     virtual void on_parent_completion(const ParentCompletionEvent &event) noexcept = 0;
 };
 
+struct RetryCounters {
+    std::uint64_t rnr_naks_sent = 0;
+    std::uint64_t rnr_naks_received = 0;
+    std::uint64_t rnr_retry_exhausted = 0;
+    std::uint64_t retransmitted_parents = 0;
+    std::uint64_t discarded_requests = 0;
+    std::uint64_t timeouts = 0;
+    std::uint64_t retry_exhausted = 0;
+    std::uint64_t duplicate_responses = 0;
+};
+
 enum class LoopWorkerRole {
     requester,
     responder,
 };
 
+enum class ChunkOrdering {
+    in_order,
+    any_order,
+};
+
 class LoopWorker {
   public:
     static constexpr std::size_t kDefaultPayloadBytes = 8192;
+    static constexpr std::uint8_t kInfiniteRnrRetry = 7;
+    static constexpr std::uint8_t kMinimumAckTimeout = 14;
 
-    LoopWorker(control::QpService &service, std::uint32_t qp_num, LocalTransport &transport,
+    LoopWorker(control::QpService &service, std::uint32_t qp_num, DatagramTransport &transport,
                CopyBackend &backend, LoopWorkerRole role,
                std::size_t payload_bytes = kDefaultPayloadBytes,
-               ParentCompletionObserver *observer = nullptr);
+               ParentCompletionObserver *observer = nullptr,
+               const FlowControlOptions &flow_control = {},
+               ChunkOrdering chunk_ordering = ChunkOrdering::in_order);
 
     bool progress_once();
+    [[nodiscard]] const FlowControlCounters &flow_control_counters() const noexcept;
+    [[nodiscard]] const RetryCounters &retry_counters() const noexcept;
+    [[nodiscard]] const MrTranslationCache &mr_translation_cache() const noexcept;
 
   private:
     static constexpr std::size_t kBackendBatchCapacity = 64;
+    static constexpr std::chrono::nanoseconds kTimerResolution{4096};
+    static constexpr std::size_t kTimerSlots = 4096;
+    static constexpr std::uint64_t kRnrTimerKey = 0;
+    static constexpr std::size_t kResponseHistory = 1024;
 
     struct SourceSegment {
         std::uint64_t daemon_address = 0;
         std::uint32_t length = 0;
     };
 
-    struct RequesterInflight {
-        std::uint64_t wr_id = 0;
-        bool signaled = false;
-        std::uint64_t logical_bytes = 0;
-        std::uint32_t payload_count = 0;
-    };
-
     struct PendingSend {
         std::uint64_t parent_request_id = 0;
         std::uint64_t wr_id = 0;
@@ -80,6 +105,19 @@ class LoopWorker {
         std::uint64_t payload_offset = 0;
         std::uint32_t payload_index = 0;
         bool zero_payload_sent = false;
+        bool from_send_queue = false;
+    };
+
+    struct RequesterInflight {
+        std::uint64_t wr_id = 0;
+        bool signaled = false;
+        std::uint64_t logical_bytes = 0;
+        std::uint32_t payload_count = 0;
+        std::chrono::steady_clock::time_point posted_at{};
+        std::uint32_t rnr_attempts = 0;
+        std::uint32_t timeout_attempts = 0;
+        TimerWheel::TimerId timer = TimerWheel::kInvalidTimer;
+        PendingSend send;
     };
 
     struct ResponderInflight {
@@ -93,6 +131,11 @@ class LoopWorker {
         std::uint64_t target_daemon_address = 0;
         std::uint64_t next_payload_offset = 0;
         std::uint32_t next_payload_index = 0;
+        std::uint32_t received_count = 0;
+        std::uint64_t received_bytes = 0;
+        std::vector<std::uint64_t> arrived;
+        // Any-order byte ranges received so far, keyed by offset, so overlaps are caught.
+        std::map<std::uint64_t, std::uint64_t> arrived_ranges;
         std::uint32_t payload_count = 0;
         std::uint32_t terminal_count = 0;
         std::vector<std::uint8_t> terminal;
@@ -102,6 +145,7 @@ class LoopWorker {
         bool receive_consumed = false;
         std::uint64_t receive_wr_id = 0;
         std::uint32_t byte_length = 0;
+        std::uint32_t epoch = 0;
     };
 
     bool try_backend_completions(const control::WorkerQpView &view);
@@ -110,24 +154,53 @@ class LoopWorker {
     bool try_response(const control::WorkerQpView &view);
     bool try_request(const control::WorkerQpView &view);
     bool try_send(const control::WorkerQpView &view);
+    bool try_flush_send(const control::WorkerQpView &view);
+    void record_chunk(ResponderInflight &parent, const RequestDatagram &request);
+    void fail_chunk(ResponderInflight &parent, const RequestDatagram &request,
+                    DatagramResult result);
+    bool try_timers(const control::WorkerQpView &view);
+    void arm_retransmit_timer(const control::WorkerQpView &view, std::uint64_t parent_request_id,
+                              RequesterInflight &parent);
+    void rewind_requester(const control::WorkerQpView &view, std::uint64_t first_parent_request_id);
+    void enter_requester_error(const control::WorkerQpView &view);
+    void advance_sequence() noexcept;
     bool complete_send_error(const control::WorkerQpView &view, const queue::SendWqeHeader &send,
                              std::uint32_t status);
     std::uint64_t next_request_id() noexcept;
+    ResponseDatagram make_response(std::uint64_t parent_request_id,
+                                   DatagramResult result) const noexcept;
 
     control::QpService &service_;
     std::uint32_t qp_num_ = 0;
-    LocalTransport &transport_;
+    DatagramTransport &transport_;
     CopyBackend &backend_;
     LoopWorkerRole role_ = LoopWorkerRole::requester;
     std::size_t payload_bytes_ = kDefaultPayloadBytes;
     ParentCompletionObserver *observer_ = nullptr;
+    FlowController flow_control_;
+    ChunkOrdering chunk_ordering_ = ChunkOrdering::in_order;
     std::uint32_t next_sequence_ = 1;
     std::unordered_map<std::uint64_t, RequesterInflight> requester_inflight_;
+    std::deque<std::uint64_t> requester_order_;
+    std::deque<std::uint64_t> retransmit_queue_;
+    std::uint32_t send_epoch_ = 0;
+    TimerWheel timers_;
+    std::vector<std::uint64_t> expired_timers_;
+    TimerWheel::TimerId rnr_timer_ = TimerWheel::kInvalidTimer;
+    bool rnr_waiting_ = false;
+    bool requester_error_ = false;
+    bool responder_discarding_ = false;
+    std::uint32_t responder_discard_epoch_ = 0;
+    RetryCounters retry_counters_;
+    MrTranslationCache mr_cache_;
     std::unordered_map<std::uint64_t, ResponderInflight> responder_inflight_;
     std::deque<std::uint64_t> responder_order_;
+    std::unordered_map<std::uint64_t, DatagramResult> responded_;
+    std::deque<std::uint64_t> responded_order_;
     std::optional<PendingSend> pending_send_;
     std::optional<RequestDatagram> pending_request_;
     std::optional<ResponseDatagram> pending_response_;
+    std::deque<ResponseDatagram> local_responses_;
     std::array<BackendRequest, kBackendBatchCapacity> pending_backend_requests_{};
     std::size_t pending_backend_request_count_ = 0;
 };
@@ -86,7 +86,7 @@ bool send_report(int fd, int status, std::uint32_t qp_num = 0,
 }
 
 ugdr_qp_init_attr qp_init_attributes(ugdr_cq *send_cq, ugdr_cq *recv_cq) {
-    return {send_cq, recv_cq, 32, 32, 1, 1, UGDR_QPT_RC, 0};
+    return {send_cq, recv_cq, 32, 32, 1, 1, UGDR_QPT_RC, 0, nullptr};
 }
 
 int initialize_qp(ugdr_qp *qp) {
@@ -283,8 +283,20 @@ int main() {
     const int send_count = ugdr_poll_cq(send, 1, &send_wc);
     const std::size_t allocations_after = allocation_count.load(std::memory_order_relaxed);
     if (send_count != 1 || allocations_before != allocations_after || send_wc.wr_id != 1001 ||
-        !valid_wc(send_wc) || ugdr_poll_cq(receive, 1, &receive_wc) != 1 ||
-        receive_wc.wr_id != 2001 || !valid_wc(receive_wc)) {
+        !valid_wc(send_wc) || ugdr_start_poll(receive) != 0) {
+        return 8;
+    }
+    receive_wc.wr_id = ugdr_wc_read_wr_id(receive);
+    receive_wc.status = ugdr_wc_read_status(receive);
+    receive_wc.opcode = ugdr_wc_read_opcode(receive);
+    receive_wc.byte_len = ugdr_wc_read_byte_len(receive);
+    receive_wc.imm_data = ugdr_wc_read_imm_data(receive);
+    receive_wc.qp_num = ugdr_wc_read_qp_num(receive);
+    receive_wc.wc_flags = ugdr_wc_read_wc_flags(receive);
+    const int next_status = ugdr_next_poll(receive);
+    ugdr_end_poll(receive);
+    if (receive_wc.wr_id != 2001 || !valid_wc(receive_wc) || next_status != ENOENT ||
+        ugdr_start_poll(receive) != ENOENT) {
         return 8;
     }
     std::atomic<bool> polling_started{false};
@@ -312,8 +324,8 @@ int main() {
     if (destroy_status != 0 || destroy_race_failure.load() != 0 ||
         ugdr_poll_cq(shared, 1, &sentinel) != -EINVAL ||
         std::memcmp(&sentinel, &expected_sentinel, sizeof(sentinel)) != 0 ||
-        ugdr_destroy_cq(send) != 0 || ugdr_destroy_cq(receive) != 0 ||
-        ugdr_close_device(context) != 0) {
+        ugdr_start_poll(shared) != EINVAL || ugdr_destroy_cq(send) != 0 ||
+        ugdr_destroy_cq(receive) != 0 || ugdr_close_device(context) != 0) {
         return 9;
     }
 
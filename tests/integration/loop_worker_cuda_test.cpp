@@ -346,8 +346,10 @@ int main() {
                                       UGDR_ACCESS_LOCAL_WRITE | UGDR_ACCESS_REMOTE_WRITE);
         send_cq = context == nullptr ? nullptr : ugdr_create_cq(context, 8, nullptr, nullptr, 0);
         receive_cq = context == nullptr ? nullptr : ugdr_create_cq(context, 8, nullptr, nullptr, 0);
-        ugdr_qp_init_attr requester_attributes{send_cq, send_cq, 8, 8, 4, 4, UGDR_QPT_RC, 0};
-        ugdr_qp_init_attr responder_attributes{receive_cq, receive_cq, 8, 8, 4, 4, UGDR_QPT_RC, 0};
+        ugdr_qp_init_attr requester_attributes{send_cq, send_cq, 8, 8, 4, 4, UGDR_QPT_RC, 0,
+                                               nullptr};
+        ugdr_qp_init_attr responder_attributes{receive_cq, receive_cq, 8, 8, 4, 4, UGDR_QPT_RC, 0,
+                                               nullptr};
         requester =
             source_pd == nullptr ? nullptr : ugdr_create_qp(source_pd, &requester_attributes);
         responder =
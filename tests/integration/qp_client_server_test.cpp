@@ -71,7 +71,7 @@ int child_main(const std::string &socket_path, int ready_fd) {
 }
 
 ugdr_qp_init_attr init_attributes(ugdr_cq *send_cq, ugdr_cq *recv_cq) {
-    return {send_cq, recv_cq, 17, 19, 3, 5, UGDR_QPT_RC, 1};
+    return {send_cq, recv_cq, 17, 19, 3, 5, UGDR_QPT_RC, 1, nullptr};
 }
 
 }  // namespace
@@ -180,7 +180,7 @@ int child_main(const std::string &socket_path, int ready_fd) {
 }
 
 ugdr_qp_init_attr qp_attributes(ugdr_cq *send_cq, ugdr_cq *recv_cq) {
-    return {send_cq, recv_cq, 128, 32, 2, 2, UGDR_QPT_RC, 0};
+    return {send_cq, recv_cq, 128, 32, 2, 2, UGDR_QPT_RC, 0, nullptr};
 }
 
 int initialize(ugdr_qp *qp) {
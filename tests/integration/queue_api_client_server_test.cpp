@@ -238,7 +238,7 @@ int child_main(const std::string &socket_path, int ready_fd) {
     if (::write(ready_fd, &ready, 1) != 1) {
         return 21;
     }
-    constexpr int expected_control_requests = 32;
+    constexpr int expected_control_requests = 35;
     for (int iteration = 0; iteration < 4000 && service.request_count < expected_control_requests;
          ++iteration) {
         (void)service.progress_all();
@@ -252,7 +252,12 @@ int child_main(const std::string &socket_path, int ready_fd) {
 }
 
 ugdr_qp_init_attr qp_attributes(ugdr_cq *send_cq, ugdr_cq *recv_cq, int sq_sig_all) {
-    return {send_cq, recv_cq, 32, 32, 4, 4, UGDR_QPT_RC, sq_sig_all};
+    return {send_cq, recv_cq, 32, 32, 4, 4, UGDR_QPT_RC, sq_sig_all, nullptr};
+}
+
+ugdr_qp_init_attr_ex single_threaded_qp_attributes(ugdr_cq *cq, int sq_sig_all) {
+    return {cq, cq, 32, 32, 4, 4, UGDR_QPT_RC, sq_sig_all, nullptr,
+            UGDR_QP_CREATE_SINGLE_THREADED};
 }
 
 int initialize(ugdr_qp *qp) {
@@ -376,6 +381,111 @@ bool common_cq_semantics(ugdr_qp *first, ugdr_qp *second, ugdr_cq *common, std::
     return valid;
 }
 
+bool builder_semantics(ugdr_qp *first, ugdr_qp *second, ugdr_cq *common) {
+    if (ugdr_wr_start(first) != 0) {
+        return false;
+    }
+    ugdr_wr_rdma_write(first, 500, UGDR_SEND_SIGNALED | (1U << 5U), 77, UINT64_C(0x200000));
+    ugdr_wr_set_sge(first, 31, UINT64_C(0x100000), 8);
+    if (ugdr_wr_complete(first) != EINVAL || ugdr_wr_start(first) != 0) {
+        return false;
+    }
+    ugdr_wr_rdma_write(first, 501, UGDR_SEND_SIGNALED, 77, UINT64_C(0x200000));
+    ugdr_wr_abort(first);
+
+    constexpr std::uint32_t immediate = UINT32_C(0x55667788);
+    const std::array<ugdr_sge, 2> sges{{{UINT64_C(0x100000), 8, 31}, {UINT64_C(0x100040), 9, 32}}};
+    if (!post_receive(second, 600) || ugdr_wr_start(first) != 0) {
+        return false;
+    }
+    ugdr_wr_rdma_write(first, 502, 0, 77, UINT64_C(0x200000));
+    ugdr_wr_set_sge(first, 31, UINT64_C(0x100000), 8);
+    ugdr_wr_rdma_write_imm(first, 503, UGDR_SEND_SIGNALED, 77, UINT64_C(0x200000), immediate);
+    ugdr_wr_set_sge_list(first, sges.size(), sges.data());
+    if (ugdr_wr_complete(first) != 0) {
+        return false;
+    }
+    std::array<ugdr_wc, 3> completions{};
+    const int count = poll_until(common, completions.data(), 2);
+    const ugdr_wc &send = completions[0].wr_id == 503 ? completions[0] : completions[1];
+    const ugdr_wc &receive = completions[0].wr_id == 503 ? completions[1] : completions[0];
+    const bool valid = count == 2 && send.wr_id == 503 && send.status == UGDR_WC_SUCCESS &&
+                       receive.wr_id == 600 && receive.status == UGDR_WC_SUCCESS &&
+                       receive.byte_len == 17 && receive.imm_data == immediate &&
+                       ugdr_poll_cq(common, 1, &completions[2]) == 0;
+    if (!valid) {
+        std::cerr << "builder matrix failed: count=" << count << " first=" << completions[0].wr_id
+                  << " second=" << completions[1].wr_id << '\n';
+    }
+    return valid;
+}
+
+bool array_semantics(ugdr_qp *first, ugdr_qp *second, ugdr_cq *common) {
+    std::array<ugdr_recv_wr, 2> receives{};
+    std::array<ugdr_send_wr, 2> sends{};
+    for (std::size_t index = 0; index < 2; ++index) {
+        receives[index].wr_id = 700 + index;
+        sends[index].wr_id = 710 + index;
+        sends[index].opcode = UGDR_WR_RDMA_WRITE_WITH_IMM;
+        sends[index].send_flags = UGDR_SEND_SIGNALED;
+        sends[index].imm_data = static_cast<std::uint32_t>(index);
+        sends[index].wr.rdma.rkey = 77;
+    }
+    int posted = -1;
+    if (ugdr_post_send_batch(first, sends.data(), 2, nullptr) != EINVAL ||
+        ugdr_post_recv_batch(second, receives.data(), 2, &posted) != 0 || posted != 2 ||
+        ugdr_post_send_batch(first, sends.data(), 2, &posted) != 0 || posted != 2) {
+        return false;
+    }
+    std::array<ugdr_wc, 4> completions{};
+    if (poll_until(common, completions.data(), completions.size()) != 4) {
+        return false;
+    }
+    std::uint64_t seen = 0;
+    for (const ugdr_wc &completion : completions) {
+        seen |= completion.status == UGDR_WC_SUCCESS ? UINT64_C(1) << (completion.wr_id - 700) : 0;
+    }
+    return seen == UINT64_C(0xc03);
+}
+
+bool template_semantics(ugdr_qp *first, ugdr_cq *common) {
+    ugdr_sge sge{UINT64_C(0x100000), 8, 31};
+    ugdr_send_wr shape{};
+    shape.sg_list = &sge;
+    shape.num_sge = 1;
+    shape.opcode = UGDR_WR_RDMA_WRITE;
+    shape.send_flags = UGDR_SEND_SIGNALED;
+    shape.wr.rdma.rkey = 77;
+    std::uint32_t template_id = UINT32_MAX;
+    if (ugdr_create_send_template(first, &shape, nullptr) != EINVAL ||
+        ugdr_create_send_template(first, &shape, &template_id) != 0 ||
+        ugdr_post_send_template(first, template_id + 1, 0, 0, 0) != EINVAL ||
+        ugdr_post_send_template(first, template_id, 720, UINT64_C(0x100040),
+                                UINT64_C(0x200000)) != 0) {
+        return false;
+    }
+    ugdr_wc completion{};
+    return poll_until(common, &completion, 1) == 1 && completion.wr_id == 720 &&
+           completion.status == UGDR_WC_SUCCESS && completion.opcode == UGDR_WC_RDMA_WRITE;
+}
+
+bool moderation_semantics(ugdr_cq *single_entry, ugdr_cq *compact) {
+    ugdr_modify_cq_attr attr{};
+    attr.moderate.cq_count = 2;
+    if (ugdr_modify_cq(single_entry, nullptr) != EINVAL ||
+        ugdr_modify_cq(single_entry, &attr) != EINVAL) {
+        return false;
+    }
+    attr.attr_mask = UGDR_CQ_ATTR_MODERATE;
+    if (ugdr_modify_cq(single_entry, &attr) != EINVAL ||
+        ugdr_modify_cq(compact, &attr) != EOPNOTSUPP) {
+        return false;
+    }
+    attr.moderate.cq_count = 1;
+    attr.moderate.cq_period = 10;
+    return ugdr_modify_cq(single_entry, &attr) == 0;
+}
+
 bool backpressure_and_allocation(ugdr_qp *first, ugdr_qp *second, ugdr_cq *send_cq,
                                  ugdr_cq *recv_cq) {
     if (!post_receive(second, 300) || !post_receive(second, 301) ||
@@ -558,20 +668,23 @@ int main() {
         ugdr_free_device_list(devices);
     }
     ugdr_pd *const pd = context != nullptr ? ugdr_alloc_pd(context) : nullptr;
-    ugdr_cq *const common =
-        context != nullptr ? ugdr_create_cq(context, 32, nullptr, nullptr, 0) : nullptr;
+    ugdr_cq_init_attr_ex common_attr{
+        32, nullptr, nullptr, 0,
+        UGDR_CREATE_CQ_ATTR_SINGLE_THREADED | UGDR_CREATE_CQ_ATTR_COMPACT_CQE};
+    ugdr_cq *const common = context != nullptr ? ugdr_create_cq_ex(context, &common_attr) : nullptr;
     ugdr_cq *const send =
         context != nullptr ? ugdr_create_cq(context, 32, nullptr, nullptr, 0) : nullptr;
     ugdr_cq *const receive =
         context != nullptr ? ugdr_create_cq(context, 1, nullptr, nullptr, 0) : nullptr;
 
-    ugdr_qp_init_attr common_first_attr = qp_attributes(common, common, 0);
-    ugdr_qp_init_attr common_second_attr = qp_attributes(common, common, 1);
+    ugdr_qp_init_attr_ex common_first_attr = single_threaded_qp_attributes(common, 0);
+    ugdr_qp_init_attr_ex common_second_attr = single_threaded_qp_attributes(common, 1);
     ugdr_qp_init_attr separate_first_attr = qp_attributes(send, receive, 0);
     ugdr_qp_init_attr separate_second_attr = qp_attributes(send, receive, 0);
-    ugdr_qp *const common_first = pd != nullptr ? ugdr_create_qp(pd, &common_first_attr) : nullptr;
+    ugdr_qp *const common_first =
+        pd != nullptr ? ugdr_create_qp_ex(pd, &common_first_attr) : nullptr;
     ugdr_qp *const common_second =
-        pd != nullptr ? ugdr_create_qp(pd, &common_second_attr) : nullptr;
+        pd != nullptr ? ugdr_create_qp_ex(pd, &common_second_attr) : nullptr;
     ugdr_qp *const separate_first =
         pd != nullptr ? ugdr_create_qp(pd, &separate_first_attr) : nullptr;
     ugdr_qp *const separate_second =
@@ -591,6 +704,18 @@ int main() {
         return 6;
     }
 
+    ugdr_cq_init_attr_ex unknown_cq_flags{32, nullptr, nullptr, 0, 1U << 7U};
+    ugdr_qp_init_attr_ex unknown_qp_flags = single_threaded_qp_attributes(common, 0);
+    unknown_qp_flags.create_flags = 1U << 7U;
+    errno = 0;
+    if (ugdr_create_cq_ex(context, &unknown_cq_flags) != nullptr || errno != EINVAL) {
+        return 69;
+    }
+    errno = 0;
+    if (ugdr_create_qp_ex(pd, &unknown_qp_flags) != nullptr || errno != EINVAL) {
+        return 69;
+    }
+
     ugdr_send_wr invalid{};
     invalid.opcode = static_cast<ugdr_wr_opcode>(99);
     ugdr_send_wr *bad = nullptr;
@@ -601,6 +726,18 @@ int main() {
                              common_second_num)) {
         return 71;
     }
+    if (!builder_semantics(common_first, common_second, common)) {
+        return 75;
+    }
+    if (!array_semantics(common_first, common_second, common)) {
+        return 76;
+    }
+    if (!template_semantics(common_first, common)) {
+        return 77;
+    }
+    if (!moderation_semantics(receive, common)) {
+        return 78;
+    }
     if (!backpressure_and_allocation(separate_first, separate_second, send, receive)) {
         return 72;
     }
@@ -90,9 +90,10 @@ bool publish_all(std::array<CompletionReservation, 2> *targets, std::uint32_t ta
     for (std::uint32_t index = 0; index < target_count; ++index) {
         CompletionReservation &target = (*targets)[index];
         for (std::uint32_t entry_index = 0; entry_index < target.count; ++entry_index) {
-            std::memcpy(
+            (void)queue::write_completion(
+                *target.ring,
                 mutable_slot(target.slots, entry_index, target.ring->descriptor().slot_stride),
-                &target.entries[entry_index], sizeof(CompletionEntry));
+                target.entries[entry_index], entry_index);
         }
     }
     for (std::uint32_t index = 0; index < target_count; ++index) {
@@ -11,6 +11,7 @@
 int main(void) {
     int num_devices = 17;
     struct ugdr_qp_init_attr init_attr = {0};
+    struct ugdr_srq_init_attr srq_attr = {0, 8, 1};
     struct ugdr_qp_attr attr = {0};
     struct ugdr_qp_conn_info info = {23};
     struct ugdr_mr mr = {0};
@@ -82,9 +83,15 @@ int main(void) {
         ugdr_post_recv(0, &recv_wr, &bad_recv) != EINVAL || bad_recv != &recv_wr) {
         return 10;
     }
+    errno = 0;
+    bad_recv = (struct ugdr_recv_wr *)(uintptr_t)3;
+    if (ugdr_create_srq(0, &srq_attr) != 0 || errno != EINVAL || ugdr_destroy_srq(0) != EINVAL ||
+        ugdr_post_srq_recv(0, &recv_wr, &bad_recv) != EINVAL || bad_recv != &recv_wr) {
+        return 11;
+    }
 
     return sge.lkey == mr.lkey && send_wr.wr.rdma.rkey == mr.rkey && recv_wr.sg_list == 0 &&
                    wc.imm_data == send_wr.imm_data
                ? 0
-               : 11;
+               : 12;
 }
@@ -38,6 +38,8 @@ int main() {
         std::is_same_v<decltype(&ugdr_create_cq), ugdr_cq *(*)(ugdr_context *, int, void *,
                                                                ugdr_comp_channel *, int) noexcept>);
     static_assert(std::is_same_v<decltype(&ugdr_destroy_cq), int (*)(ugdr_cq *) noexcept>);
+    static_assert(std::is_same_v<decltype(&ugdr_modify_cq),
+                                 int (*)(ugdr_cq *, ugdr_modify_cq_attr *) noexcept>);
     static_assert(
         std::is_same_v<decltype(&ugdr_poll_cq), int (*)(ugdr_cq *, int, ugdr_wc *) noexcept>);
     static_assert(std::is_same_v<decltype(&ugdr_create_qp),
@@ -47,6 +49,11 @@ int main() {
                                  int (*)(ugdr_qp *, ugdr_qp_attr *, int) noexcept>);
     static_assert(std::is_same_v<decltype(&ugdr_query_qp), int (*)(ugdr_qp *, ugdr_qp_attr *, int,
                                                                    ugdr_qp_init_attr *) noexcept>);
+    static_assert(std::is_same_v<decltype(&ugdr_create_srq),
+                                 ugdr_srq *(*)(ugdr_pd *, ugdr_srq_init_attr *) noexcept>);
+    static_assert(std::is_same_v<decltype(&ugdr_destroy_srq), int (*)(ugdr_srq *) noexcept>);
+    static_assert(std::is_same_v<decltype(&ugdr_post_srq_recv),
+                                 int (*)(ugdr_srq *, ugdr_recv_wr *, ugdr_recv_wr **) noexcept>);
     static_assert(std::is_same_v<decltype(&ugdr_query_qp_conn_info),
                                  int (*)(ugdr_qp *, ugdr_qp_conn_info *) noexcept>);
     static_assert(
@@ -63,6 +70,7 @@ int main() {
     static_assert(std::is_standard_layout_v<ugdr_recv_wr>);
     static_assert(std::is_standard_layout_v<ugdr_wc>);
     static_assert(std::is_standard_layout_v<ugdr_qp_init_attr>);
+    static_assert(std::is_standard_layout_v<ugdr_srq_init_attr>);
     static_assert(std::is_standard_layout_v<ugdr_qp_attr>);
     static_assert(std::is_standard_layout_v<ugdr_qp_conn_info>);
 
@@ -138,7 +146,7 @@ int main() {
 
     auto *const send_cq = sentinel_pointer<ugdr_cq>(12);
     auto *const recv_cq = sentinel_pointer<ugdr_cq>(13);
-    ugdr_qp_init_attr init_attr{send_cq, recv_cq, 17, 19, 3, 5, UGDR_QPT_RC, 1};
+    ugdr_qp_init_attr init_attr{send_cq, recv_cq, 17, 19, 3, 5, UGDR_QPT_RC, 1, nullptr};
     const ugdr_qp_init_attr expected_init_attr = init_attr;
     errno = 0;
     if (ugdr_create_qp(sentinel_pointer<ugdr_pd>(14), &init_attr) != nullptr || errno != EINVAL ||
@@ -159,7 +167,7 @@ int main() {
         return 14;
     }
 
-    ugdr_qp_init_attr query_init{recv_cq, send_cq, 23, 29, 7, 11, UGDR_QPT_RC, 0};
+    ugdr_qp_init_attr query_init{recv_cq, send_cq, 23, 29, 7, 11, UGDR_QPT_RC, 0, nullptr};
     const ugdr_qp_init_attr expected_query_init = query_init;
     errno = 131;
     if (ugdr_query_qp(sentinel_pointer<ugdr_qp>(17), &attr, UGDR_QP_STATE, &query_init) != EINVAL ||
@@ -211,7 +219,44 @@ int main() {
         return 19;
     }
 
+    ugdr_srq_init_attr srq_attr{sentinel_pointer<void>(24), 43, 2};
+    const ugdr_srq_init_attr expected_srq_attr = srq_attr;
+    errno = 0;
+    if (ugdr_create_srq(sentinel_pointer<ugdr_pd>(25), &srq_attr) != nullptr || errno != EINVAL ||
+        !unchanged(srq_attr, expected_srq_attr)) {
+        return 20;
+    }
+    errno = 157;
+    bad_recv = sentinel_pointer<ugdr_recv_wr>(26);
+    if (ugdr_destroy_srq(sentinel_pointer<ugdr_srq>(27)) != EINVAL ||
+        ugdr_post_srq_recv(sentinel_pointer<ugdr_srq>(28), &recv_wr, &bad_recv) != EINVAL ||
+        errno != 157 || bad_recv != &recv_wr || !unchanged(recv_wr, expected_recv_wr)) {
+        return 21;
+    }
+
+    auto *const unpolled = sentinel_pointer<ugdr_cq>(29);
+    ugdr_end_poll(nullptr);
+    ugdr_end_poll(unpolled);
+    if (ugdr_start_poll(unpolled) != EINVAL || ugdr_next_poll(nullptr) != EINVAL ||
+        ugdr_next_poll(unpolled) != EINVAL || ugdr_wc_read_wr_id(unpolled) != 0 ||
+        ugdr_wc_read_status(nullptr) != UGDR_WC_GENERAL_ERR ||
+        ugdr_wc_read_byte_len(unpolled) != 0 || ugdr_wc_read_qp_num(unpolled) != 0 ||
+        ugdr_wc_read_wc_flags(unpolled) != 0) {
+        return 23;
+    }
+
+    auto *const unbuilt = sentinel_pointer<ugdr_qp>(30);
+    ugdr_wr_rdma_write(unbuilt, 1, UGDR_SEND_SIGNALED, mr.rkey, 0);
+    ugdr_wr_rdma_write_imm(nullptr, 2, 0, mr.rkey, 0, 3);
+    ugdr_wr_set_sge(unbuilt, mr.lkey, 0, 8);
+    ugdr_wr_set_sge_list(unbuilt, 1, &sge);
+    ugdr_wr_abort(unbuilt);
+    if (ugdr_wr_start(unbuilt) != EINVAL || ugdr_wr_complete(unbuilt) != EINVAL ||
+        ugdr_wr_complete(nullptr) != EINVAL) {
+        return 24;
+    }
+
     return mr.lkey == 17 && mr.rkey == 19 && sge.lkey == mr.lkey && send_wr.wr.rdma.rkey == mr.rkey
                ? 0
-               : 20;
+               : 22;
 }
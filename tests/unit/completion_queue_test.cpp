@@ -92,11 +92,147 @@ int validation_test() {
                : 2;
 }
 
+int reader_test() {
+    const QueueDescriptor descriptor{QueueKind::completion, 4,
+                                     ugdr::queue::completion_slot_stride()};
+    SharedRing ring;
+    ugdr::queue::CompletionReader reader;
+    if (ugdr::queue::create_shared_ring(descriptor, &ring) != 0 ||
+        reader.start(ring) != ENOENT || reader.active()) {
+        return 1;
+    }
+    const std::array first{entry(1), entry(2), entry(3)};
+    if (ugdr::queue::produce_completions(ring, first.data(), first.size()) != 3 ||
+        reader.start(ring) != 0 || reader.current().wr_id != 1 || reader.next() != 0 ||
+        std::memcmp(&reader.current(), &first[1], sizeof(CompletionEntry)) != 0 ||
+        reader.end() != 0) {
+        return 2;
+    }
+    const std::array second{entry(4), entry(5), entry(6)};
+    if (ugdr::queue::produce_completions(ring, second.data(), second.size()) != 3 ||
+        reader.start(ring) != 0) {
+        return 3;
+    }
+    std::array<std::uint64_t, 5> seen{};
+    std::size_t count = 0;
+    do {
+        seen[count++] = reader.current().wr_id;
+    } while (count < seen.size() && reader.next() == 0);
+    if (count != 4 || seen[0] != 3 || seen[1] != 4 || seen[2] != 5 || seen[3] != 6 ||
+        reader.next() != ENOENT || reader.end() != 0 || reader.end() != EINVAL) {
+        return 4;
+    }
+    const CompletionEntry last = entry(7);
+    return reader.start(ring) == ENOENT &&
+                   ugdr::queue::produce_completions(ring, &last, 1) == 1 && consume(ring, &last, 1)
+               ? 0
+               : 5;
+}
+
+int moderation_test() {
+    const QueueDescriptor descriptor{QueueKind::completion, 8,
+                                     ugdr::queue::completion_slot_stride()};
+    SharedRing ring;
+    ugdr::queue::CompletionModerator moderator;
+    moderator.configure({3, UINT16_MAX});
+    const std::array entries{entry(1), entry(2), entry(3), entry(4)};
+    const void *slot = nullptr;
+    if (ugdr::queue::create_shared_ring(descriptor, &ring) != 0 ||
+        ugdr::queue::produce_completions(ring, moderator, entries.data(), 2) != 2 ||
+        ring.producer_staged() != 2 || ring.consumer_peek(&slot) != EAGAIN ||
+        moderator.flush_if_due(ring)) {
+        return 1;
+    }
+    if (ugdr::queue::produce_completions(ring, moderator, &entries[2], 1) != 1 ||
+        ring.producer_staged() != 0 || !consume(ring, entries.data(), 3)) {
+        return 2;
+    }
+    moderator.configure({3, 0});
+    if (ugdr::queue::produce_completions(ring, moderator, &entries[3], 1) != 1 ||
+        ring.consumer_peek(&slot) != EAGAIN || !moderator.flush_if_due(ring) ||
+        moderator.flush_if_due(ring) || !consume(ring, &entries[3], 1)) {
+        return 3;
+    }
+    moderator.configure({});
+    return ugdr::queue::produce_completions(ring, moderator, entries.data(), 1) == 1 &&
+                   ring.producer_staged() == 0 && consume(ring, entries.data(), 1)
+               ? 0
+               : 4;
+}
+
+bool consume_compact(SharedRing &ring, const CompletionEntry *expected, std::uint32_t count) {
+    ConstSlotBatch batch;
+    if (ugdr::queue::peek_completions(ring, count + 1, &batch) != 0 || batch.count != count) {
+        return false;
+    }
+    std::uint32_t index = 0;
+    for (const ConstSlotSpan &span : {batch.first, batch.second}) {
+        const auto *slots = static_cast<const std::byte *>(span.data);
+        for (std::uint32_t slot = 0; slot < span.count; ++slot, ++index) {
+            CompletionEntry actual;
+            std::memcpy(&actual, slots + static_cast<std::size_t>(slot) * sizeof(actual),
+                        sizeof(actual));
+            actual.flags &= ~ugdr::queue::kCompletionOwnerFlag;
+            if (std::memcmp(&actual, expected + index, sizeof(actual)) != 0) {
+                return false;
+            }
+        }
+    }
+    return index == count && ring.consumer_release(count) == 0;
+}
+
+int compact_test() {
+    const QueueDescriptor descriptor{QueueKind::completion, 3,
+                                     ugdr::queue::compact_completion_slot_stride()};
+    SharedRing ring;
+    ConstSlotBatch batch;
+    const void *slot = nullptr;
+    if (ugdr::queue::create_shared_ring(descriptor, &ring) != 0 ||
+        ugdr::queue::peek_completions(ring, 3, &batch) != EAGAIN) {
+        return 1;
+    }
+    const std::array first{entry(1), entry(2)};
+    if (ugdr::queue::produce_completions(ring, first.data(), first.size()) != 2 ||
+        ring.consumer_peek(&slot) != EAGAIN || !consume_compact(ring, first.data(), 2)) {
+        return 2;
+    }
+    const std::array second{entry(3), entry(4), entry(5), entry(6)};
+    if (ugdr::queue::produce_completions(ring, second.data(), second.size()) != 3 ||
+        ugdr::queue::produce_completions(ring, &second[3], 1) != 0 ||
+        !consume_compact(ring, second.data(), 3) ||
+        ugdr::queue::peek_completions(ring, 3, &batch) != EAGAIN) {
+        return 3;
+    }
+    ugdr::queue::CompletionReader reader;
+    ugdr::queue::CompletionModerator moderator;
+    moderator.configure({2, 0});
+    if (ugdr::queue::produce_completions(ring, moderator, &second[3], 1) != 1 ||
+        moderator.flush_if_due(ring) || reader.start(ring) != 0 ||
+        reader.current().wr_id != 6 || reader.next() != ENOENT || reader.end() != 0) {
+        return 4;
+    }
+    void *reserved = nullptr;
+    return ring.producer_reserve(&reserved) == 0 &&
+                   ugdr::queue::write_completion(ring, reserved, first[0]) == 0 &&
+                   moderator.commit(ring, 1) == 0 && consume_compact(ring, first.data(), 1)
+               ? 0
+               : 5;
+}
+
 }  // namespace
 
 int main() {
     if (batch_and_capacity_test() != 0) {
         return 1;
     }
+    if (reader_test() != 0) {
+        return 3;
+    }
+    if (moderation_test() != 0) {
+        return 4;
+    }
+    if (compact_test() != 0) {
+        return 5;
+    }
     return validation_test() == 0 ? 0 : 2;
 }
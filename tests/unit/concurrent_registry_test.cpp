@@ -0,0 +1,165 @@
+#include "control/concurrent_registry.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> live_records{0};
+
+struct Record {
+    explicit Record(std::uint64_t tag = 0) : tag(tag) {
+        live_records.fetch_add(1);
+    }
+    Record(Record &&other) noexcept : tag(other.tag) {
+        live_records.fetch_add(1);
+    }
+    Record(const Record &) = delete;
+    Record &operator=(const Record &) = delete;
+    Record &operator=(Record &&) = delete;
+    ~Record() {
+        live_records.fetch_sub(1);
+    }
+
+    std::uint64_t tag = 0;
+};
+
+using Registry = ugdr::control::ConcurrentGenerationRegistry<Record,
+                                                             ugdr::control::ObjectType::context>;
+
+int single_thread_test() {
+    Registry registry;
+    const auto first = registry.insert(11, Record{7});
+    if (!first.has_value() || registry.size() != 1 || registry.resolve(11, *first) == nullptr ||
+        registry.resolve(11, *first)->tag != 7 || registry.resolve(12, *first) != nullptr ||
+        registry.resolve_any(*first) == nullptr) {
+        return 1;
+    }
+    const auto wrong_type = ugdr::control::encode_object_identity(
+        {ugdr::control::ObjectType::pd, 1, 0});
+    if (!wrong_type.has_value() || registry.resolve(11, *wrong_type) != nullptr) {
+        return 2;
+    }
+    const auto reader = registry.register_reader();
+    if (!reader.has_value() || registry.erase(12, *first) != EINVAL ||
+        registry.erase(11, *first) != 0 || registry.resolve(11, *first) != nullptr ||
+        registry.erase(11, *first) != EINVAL || registry.retired_count() != 1 ||
+        live_records.load() != 1) {
+        return 3;
+    }
+    registry.quiescent(*reader);
+    registry.reclaim();
+    if (registry.retired_count() != 0 || live_records.load() != 0) {
+        return 4;
+    }
+    registry.unregister_reader(*reader);
+
+    const auto reused = registry.insert(11, Record{9});
+    const auto parts =
+        reused.has_value() ? ugdr::control::decode_object_identity(*reused) : std::nullopt;
+    if (!parts.has_value() || parts->slot != 0 || parts->generation != 2 ||
+        registry.resolve(11, *first) != nullptr) {
+        return 5;
+    }
+    const auto other_session = registry.insert(22, Record{13});
+    if (!other_session.has_value() || registry.erase_session(11) != 1 || registry.size() != 1 ||
+        registry.resolve(22, *other_session) == nullptr || registry.retired_count() != 0) {
+        return 6;
+    }
+
+    Registry wrapping(std::numeric_limits<std::uint32_t>::max());
+    const auto last_generation = wrapping.insert(31, Record{17});
+    if (!last_generation.has_value() || wrapping.erase(31, *last_generation) != 0) {
+        return 7;
+    }
+    const auto after_retirement = wrapping.insert(31, Record{19});
+    const auto after_parts = after_retirement.has_value()
+                                 ? ugdr::control::decode_object_identity(*after_retirement)
+                                 : std::nullopt;
+    return after_parts.has_value() && after_parts->slot == 1 ? 0 : 8;
+}
+
+// Readers check that every record they resolve carries its own identity while the writer keeps
+// erasing and reinserting; a freed or reused record would fail the check.
+int concurrent_test() {
+    constexpr int kReaders = 3;
+    constexpr std::uint32_t kObjects = 64;
+    constexpr int kRounds = 2000;
+    Registry registry;
+    std::vector<std::atomic<std::uint64_t>> identities(kObjects);
+    for (std::uint32_t index = 0; index < kObjects; ++index) {
+        const auto slot = ugdr::control::encode_object_identity(
+            {ugdr::control::ObjectType::context, 1, index});
+        const auto identity = registry.insert(1, Record{*slot});
+        if (!identity.has_value() || *identity != *slot) {
+            return 10;
+        }
+        identities[index].store(*identity);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> readers;
+    for (int reader_index = 0; reader_index < kReaders; ++reader_index) {
+        readers.emplace_back([&, reader_index] {
+            const auto reader = registry.register_reader();
+            if (!reader.has_value()) {
+                failures.fetch_add(1);
+                return;
+            }
+            std::uint32_t index = static_cast<std::uint32_t>(reader_index);
+            while (!stop.load(std::memory_order_relaxed)) {
+                const std::uint64_t identity = identities[index % kObjects].load();
+                const Record *const record = registry.resolve(1, identity);
+                if (record != nullptr && record->tag != identity) {
+                    failures.fetch_add(1);
+                }
+                ++index;
+                registry.quiescent(*reader);
+            }
+            registry.unregister_reader(*reader);
+        });
+    }
+    for (int round = 0; round < kRounds; ++round) {
+        const std::uint32_t index = static_cast<std::uint32_t>(round) % kObjects;
+        const std::uint64_t old_identity = identities[index].load();
+        if (registry.erase(1, old_identity) != 0) {
+            failures.fetch_add(1);
+            break;
+        }
+        const auto parts = ugdr::control::decode_object_identity(old_identity);
+        const auto expected = ugdr::control::encode_object_identity(
+            {ugdr::control::ObjectType::context, parts->generation + 1, parts->slot});
+        const auto identity = registry.insert(1, Record{*expected});
+        if (!identity.has_value() || *identity != *expected) {
+            failures.fetch_add(1);
+            break;
+        }
+        identities[index].store(*identity);
+    }
+    stop.store(true);
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    registry.reclaim();
+    if (failures.load() != 0 || registry.retired_count() != 0 || registry.size() != kObjects) {
+        return 11;
+    }
+    return registry.erase_session(1) == kObjects && live_records.load() == 0 ? 0 : 12;
+}
+
+}  // namespace
+
+int main() {
+    if (const int result = single_thread_test(); result != 0) {
+        return result;
+    }
+    if (live_records.load() != 0) {
+        return 9;
+    }
+    return concurrent_test();
+}
@@ -0,0 +1,113 @@
+#include "worker/flow_control.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace {
+
+using namespace std::chrono_literals;
+using ugdr::worker::CongestionControl;
+using ugdr::worker::FlowControlOptions;
+using ugdr::worker::FlowController;
+
+bool disabled_controller_admits_everything_test() {
+    FlowController controller;
+    for (int index = 0; index < 1000; ++index) {
+        if (!controller.try_admit(64)) {
+            return false;
+        }
+    }
+    return !controller.enabled() && controller.counters().window == 0 &&
+           controller.counters().credit_stalls == 0 &&
+           controller.counters().outstanding_payloads == 64000 &&
+           controller.advertise(10) == 0;
+}
+
+bool credit_window_test() {
+    FlowControlOptions options;
+    options.credit_window = 8;
+    FlowController controller(options);
+    if (!controller.enabled() || controller.counters().window != 8 || !controller.try_admit(5) ||
+        !controller.try_admit(3) || controller.try_admit(1) || controller.try_admit(1) ||
+        controller.counters().credit_stalls != 1 ||
+        controller.counters().outstanding_payloads != 8) {
+        return false;
+    }
+    controller.on_response(5, 4, false, 1us);
+    if (controller.counters().window != 4 || controller.counters().outstanding_payloads != 3 ||
+        !controller.try_admit(1) || controller.try_admit(1) ||
+        controller.counters().credit_stalls != 2) {
+        return false;
+    }
+    controller.on_response(3, 0, false, 1us);
+    controller.on_response(1, 16, false, 1us);
+    return controller.counters().window == 8 && controller.counters().minimum_window == 4 &&
+           controller.counters().peak_window == 8 &&
+           controller.counters().outstanding_payloads == 0 && controller.try_admit(20) &&
+           controller.counters().admitted_parents == 4;
+}
+
+bool advertisement_test() {
+    FlowControlOptions options;
+    options.credit_window = 16;
+    options.minimum_window = 2;
+    const FlowController controller(options);
+    return controller.advertise(0) == 16 && controller.advertise(10) == 6 &&
+           controller.advertise(14) == 2 && controller.advertise(64) == 2;
+}
+
+bool delay_congestion_control_test() {
+    FlowControlOptions options;
+    options.credit_window = 32;
+    options.congestion_control = CongestionControl::delay;
+    options.target_delay = 10us;
+    options.minimum_window = 2;
+    options.decrease_factor = 0.5;
+    FlowController controller(options);
+    if (controller.counters().window != 32) {
+        return false;
+    }
+    for (int index = 0; index < 32; ++index) {
+        if (!controller.try_admit(1)) {
+            return false;
+        }
+    }
+    for (int index = 0; index < 32; ++index) {
+        controller.on_response(1, 32, false, 40us);
+    }
+    const std::uint32_t decreased = controller.counters().window;
+    if (decreased >= 32 || decreased < 2 || controller.counters().window_decreases != 1 ||
+        controller.counters().last_delay_ns != 40000) {
+        return false;
+    }
+    for (int index = 0; index < 200; ++index) {
+        if (!controller.try_admit(1)) {
+            return false;
+        }
+        controller.on_response(1, 32, false, 2us);
+    }
+    if (controller.counters().window <= decreased || controller.counters().window > 32) {
+        return false;
+    }
+    for (int index = 0; index < 64; ++index) {
+        (void)controller.try_admit(1);
+        controller.on_response(1, 32, true, 1us);
+    }
+    return controller.counters().window == 2 && controller.counters().minimum_window == 2 &&
+           controller.counters().peak_window == 32;
+}
+
+}  // namespace
+
+int main() {
+    if (!disabled_controller_admits_everything_test()) {
+        return 1;
+    }
+    if (!credit_window_test()) {
+        return 2;
+    }
+    if (!advertisement_test()) {
+        return 3;
+    }
+    return delay_congestion_control_test() ? 0 : 4;
+}
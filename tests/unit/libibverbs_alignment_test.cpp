@@ -115,6 +115,18 @@ int main() {
     UGDR_ASSERT_OFFSET(ugdr_wc, sl, ibv_wc, sl);
     UGDR_ASSERT_OFFSET(ugdr_wc, dlid_path_bits, ibv_wc, dlid_path_bits);
 
+    static_assert(sizeof(ugdr_modify_cq_attr) == sizeof(ibv_modify_cq_attr));
+    static_assert(std::is_same_v<decltype(ugdr_modify_cq_attr::attr_mask),
+                                 decltype(ibv_modify_cq_attr::attr_mask)>);
+    static_assert(std::is_same_v<decltype(ugdr_moderate_cq::cq_count),
+                                 decltype(ibv_moderate_cq::cq_count)>);
+    static_assert(std::is_same_v<decltype(ugdr_moderate_cq::cq_period),
+                                 decltype(ibv_moderate_cq::cq_period)>);
+    UGDR_ASSERT_OFFSET(ugdr_modify_cq_attr, attr_mask, ibv_modify_cq_attr, attr_mask);
+    UGDR_ASSERT_OFFSET(ugdr_modify_cq_attr, moderate, ibv_modify_cq_attr, moderate);
+    UGDR_ASSERT_OFFSET(ugdr_moderate_cq, cq_count, ibv_moderate_cq, cq_count);
+    UGDR_ASSERT_OFFSET(ugdr_moderate_cq, cq_period, ibv_moderate_cq, cq_period);
+
     static_assert(
         compatible_enum<decltype(ugdr_qp_attr::qp_state), decltype(ibv_qp_attr::qp_state)>);
     static_assert(
@@ -167,6 +179,7 @@ int main() {
     static_assert(UGDR_WC_WITH_IMM == IBV_WC_WITH_IMM);
     static_assert(UGDR_ACCESS_LOCAL_WRITE == IBV_ACCESS_LOCAL_WRITE);
     static_assert(UGDR_ACCESS_REMOTE_WRITE == IBV_ACCESS_REMOTE_WRITE);
+    static_assert(UGDR_CQ_ATTR_MODERATE == IBV_CQ_ATTR_MODERATE);
 
     return 0;
 }
@@ -7,6 +7,7 @@
 
 #include <array>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -104,6 +105,34 @@ bool make_endpoint(ugdr::control::QpService &service, ugdr::ipc::SessionId sessi
     return false;
 }
 
+bool make_srq_endpoint(ugdr::control::QpService &service, const Endpoint &base,
+                       std::uint64_t srq_identity, Endpoint *endpoint) {
+    ugdr::control::QpCreateAttributes attributes;
+    attributes.send_cq_identity = base.cq_identity;
+    attributes.recv_cq_identity = base.cq_identity;
+    attributes.max_send_wr = 8;
+    attributes.max_send_sge = 4;
+    attributes.qp_type = ugdr::control::kQpTypeRc;
+    attributes.srq_identity = srq_identity;
+    auto qp = service.handle(base.session, decoded(ugdr::control::make_create_qp_request(
+                                               base.pd_identity, attributes)));
+    if (qp.response.status != 0 || qp.response.fd_indices.size() != 1) {
+        return false;
+    }
+    *endpoint = base;
+    endpoint->qp_identity = qp.response.object_identity;
+    endpoint->qp_num = 0;
+    // QPNs are handed out in order, so the new QP holds the highest one in its session.
+    ugdr::control::WorkerQpView view;
+    for (std::uint32_t qp_num = base.qp_num + 1; qp_num < base.qp_num + 64; ++qp_num) {
+        if (service.worker_qp_view(qp_num, &view) == 0 && view.session_id == base.session &&
+            view.shared_receive_queue) {
+            endpoint->qp_num = qp_num;
+        }
+    }
+    return endpoint->qp_num != 0;
+}
+
 bool connect_endpoints(ugdr::control::QpService &service, const Endpoint &first,
                        const Endpoint &second) {
     ugdr::control::QpAttributes init;
@@ -201,6 +230,22 @@ bool drive(ugdr::worker::LoopWorker &requester, ugdr::worker::LoopWorker &respon
     return made_progress && backend.accepted_count() == 0;
 }
 
+bool drive_with_retries(ugdr::worker::LoopWorker &requester, ugdr::worker::LoopWorker &responder,
+                        ugdr::test::ScriptedCopyBackend &backend,
+                        ugdr::worker::DatagramResult result) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    bool made_progress = false;
+    while (std::chrono::steady_clock::now() < deadline) {
+        made_progress = drive(requester, responder, backend, result) || made_progress;
+        const auto &retries = requester.retry_counters();
+        if (retries.retransmitted_parents + retries.rnr_retry_exhausted >=
+            retries.rnr_naks_received) {
+            break;
+        }
+    }
+    return made_progress && backend.accepted_count() == 0;
+}
+
 class RecordingObserver final : public ugdr::worker::ParentCompletionObserver {
   public:
     void on_parent_completion(const ugdr::worker::ParentCompletionEvent &event) noexcept override {
@@ -391,6 +436,530 @@ bool sq_sig_all_test() {
            completions[0].status == UGDR_WC_SUCCESS;
 }
 
+bool cq_moderation_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 311, UINT64_C(0x30000000), &requester_endpoint) ||
+        !make_endpoint(service, 312, UINT64_C(0x40000000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+    const auto modify = [&](std::uint16_t count, std::uint16_t period_us) {
+        return service
+            .handle(requester_endpoint.session,
+                    decoded(ugdr::control::make_modify_cq_request(requester_endpoint.cq_identity,
+                                                                  {count, period_us})))
+            .response.status;
+    };
+    if (modify(9, 0) != EINVAL || modify(2, UINT16_MAX) != 0) {
+        return false;
+    }
+    ugdr::worker::LocalTransport transport(4, 4);
+    ugdr::test::ScriptedCopyBackend backend(4);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder);
+    if (!post_send(service, requester_endpoint, responder_endpoint, 41, UGDR_WR_RDMA_WRITE,
+                   UGDR_SEND_SIGNALED) ||
+        !drive(requester, responder, backend, ugdr::worker::DatagramResult::success) ||
+        !drain(service, requester_endpoint).empty() ||
+        !post_send(service, requester_endpoint, responder_endpoint, 42, UGDR_WR_RDMA_WRITE,
+                   UGDR_SEND_SIGNALED) ||
+        !drive(requester, responder, backend, ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    auto completions = drain(service, requester_endpoint);
+    if (completions.size() != 2 || completions[0].wr_id != 41 || completions[1].wr_id != 42 ||
+        modify(4, 0) != 0 ||
+        !post_send(service, requester_endpoint, responder_endpoint, 43, UGDR_WR_RDMA_WRITE,
+                   UGDR_SEND_SIGNALED) ||
+        !drive(requester, responder, backend, ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    completions = drain(service, requester_endpoint);
+    return completions.size() == 1 && completions[0].wr_id == 43;
+}
+
+bool credit_window_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 801, UINT64_C(0x74000000), &requester_endpoint) ||
+        !make_endpoint(service, 802, UINT64_C(0x75000000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+
+    ugdr::worker::FlowControlOptions flow_control;
+    flow_control.credit_window = 2;
+    ugdr::worker::LocalTransport transport(8, 8);
+    ugdr::test::ScriptedCopyBackend backend(8);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester, 16, nullptr,
+                                       flow_control);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder, 16, nullptr,
+                                       flow_control);
+    if (!post_send(service, requester_endpoint, responder_endpoint, 81, UGDR_WR_RDMA_WRITE,
+                   UGDR_SEND_SIGNALED) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 82, UGDR_WR_RDMA_WRITE,
+                   UGDR_SEND_SIGNALED) ||
+        !requester.progress_once() || !responder.progress_once() || backend.accepted_count() != 3) {
+        return false;
+    }
+    const auto &counters = requester.flow_control_counters();
+    if (counters.window != 2 || counters.outstanding_payloads != 3 || counters.credit_stalls != 1 ||
+        counters.admitted_parents != 1 || requester.progress_once()) {
+        return false;
+    }
+    if (!drive(requester, responder, backend, ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    const auto completions = drain(service, requester_endpoint);
+    return completions.size() == 2 && completions[0].wr_id == 81 && completions[1].wr_id == 82 &&
+           counters.admitted_parents == 2 && counters.outstanding_payloads == 0 &&
+           counters.peak_outstanding_payloads == 3 && counters.advertised_credits == 2 &&
+           requester.mr_translation_cache().misses() == 1 &&
+           requester.mr_translation_cache().hits() != 0 &&
+           responder.mr_translation_cache().misses() == 1 &&
+           responder.mr_translation_cache().hits() != 0;
+}
+
+bool rnr_retry_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 901, UINT64_C(0x76000000), &requester_endpoint) ||
+        !make_endpoint(service, 902, UINT64_C(0x77000000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+
+    ugdr::worker::LocalTransport transport(8, 8);
+    ugdr::test::ScriptedCopyBackend backend(8);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder);
+    if (!post_send(service, requester_endpoint, responder_endpoint, 91,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 7) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 92, UGDR_WR_RDMA_WRITE,
+                   UGDR_SEND_SIGNALED) ||
+        !requester.progress_once() || !responder.progress_once() || backend.accepted_count() != 0 ||
+        responder.retry_counters().rnr_naks_sent != 1 ||
+        responder.retry_counters().discarded_requests != 3) {
+        return false;
+    }
+    if (!drive_with_retries(requester, responder, backend,
+                            ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    auto completions = drain(service, requester_endpoint);
+    const auto &retries = requester.retry_counters();
+    if (completions.size() != 2 || completions[0].wr_id != 91 ||
+        completions[0].status != UGDR_WC_RNR_RETRY_EXC_ERR || completions[1].wr_id != 92 ||
+        completions[1].status != UGDR_WC_WR_FLUSH_ERR || retries.rnr_naks_received != 2 ||
+        retries.rnr_retry_exhausted != 1 || retries.retransmitted_parents != 2 ||
+        responder.retry_counters().rnr_naks_sent != 2) {
+        return false;
+    }
+
+    ugdr::control::WorkerQpView view;
+    if (service.worker_qp_view(requester_endpoint.qp_num, &view) != 0 ||
+        view.state != ugdr::control::kQpStateErr ||
+        !post_receive(service, responder_endpoint, 93) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 94,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 8) ||
+        !requester.progress_once() || responder.progress_once()) {
+        return false;
+    }
+    completions = drain(service, requester_endpoint);
+    return completions.size() == 1 && completions[0].wr_id == 94 &&
+           completions[0].status == UGDR_WC_WR_FLUSH_ERR &&
+           drain(service, responder_endpoint).empty() && backend.accepted_count() == 0;
+}
+
+bool rnr_window_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 951, UINT64_C(0x76800000), &requester_endpoint) ||
+        !make_endpoint(service, 952, UINT64_C(0x77800000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+
+    ugdr::worker::FlowControlOptions flow_control;
+    flow_control.congestion_control = ugdr::worker::CongestionControl::delay;
+    flow_control.target_delay = std::chrono::seconds(1);
+    ugdr::worker::LocalTransport transport(8, 8);
+    ugdr::test::ScriptedCopyBackend backend(8);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester, 16, nullptr,
+                                       flow_control);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder);
+    const auto &counters = requester.flow_control_counters();
+    const std::uint32_t initial_window = counters.window;
+    // No receive is posted, so the first attempt draws an RNR NAK that is retried.
+    if (!post_send(service, requester_endpoint, responder_endpoint, 95,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 9) ||
+        !requester.progress_once() || !responder.progress_once() || !requester.progress_once()) {
+        return false;
+    }
+    const std::uint32_t reduced_window = counters.window;
+    if (requester.retry_counters().rnr_naks_received != 1 ||
+        requester.retry_counters().rnr_retry_exhausted != 0 || counters.window_decreases != 1 ||
+        reduced_window >= initial_window || counters.outstanding_payloads != 3) {
+        return false;
+    }
+    if (!post_receive(service, responder_endpoint, 96) ||
+        !drive_with_retries(requester, responder, backend,
+                            ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    const auto completions = drain(service, requester_endpoint);
+    return completions.size() == 1 && completions[0].wr_id == 95 &&
+           completions[0].status == UGDR_WC_SUCCESS && counters.outstanding_payloads == 0 &&
+           counters.window >= reduced_window;
+}
+
+bool ack_timeout_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 1001, UINT64_C(0x78000000), &requester_endpoint) ||
+        !make_endpoint(service, 1002, UINT64_C(0x79000000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+
+    ugdr::worker::LocalTransport transport(8, 8);
+    ugdr::test::ScriptedCopyBackend backend(8);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder);
+    ugdr::worker::ResponseDatagram lost_response;
+    if (!post_receive(service, responder_endpoint, 95) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 96,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 5) ||
+        !requester.progress_once() || !responder.progress_once() || !backend.progress_once() ||
+        !backend.progress_once() || !responder.progress_once() ||
+        !transport.try_pop_response(lost_response)) {
+        return false;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (requester.retry_counters().timeouts == 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        (void)requester.progress_once();
+    }
+    if (!drive(requester, responder, backend, ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    auto completions = drain(service, requester_endpoint);
+    const auto receive_completions = drain(service, responder_endpoint);
+    if (completions.size() != 1 || completions[0].wr_id != 96 ||
+        completions[0].status != UGDR_WC_SUCCESS || receive_completions.size() != 1 ||
+        receive_completions[0].wr_id != 95 || requester.retry_counters().timeouts != 1 ||
+        requester.retry_counters().retransmitted_parents != 1 ||
+        responder.retry_counters().discarded_requests != 2) {
+        return false;
+    }
+
+    if (!post_send(service, requester_endpoint, responder_endpoint, 97, UGDR_WR_RDMA_WRITE,
+                   UGDR_SEND_SIGNALED)) {
+        return false;
+    }
+    completions.clear();
+    while (completions.empty() && std::chrono::steady_clock::now() < deadline) {
+        (void)requester.progress_once();
+        ugdr::worker::RequestDatagram lost_request;
+        while (transport.try_pop_request(lost_request)) {
+        }
+        completions = drain(service, requester_endpoint);
+    }
+    const auto &retries = requester.retry_counters();
+    if (completions.size() != 1 || completions[0].wr_id != 97 ||
+        completions[0].status != UGDR_WC_RETRY_EXC_ERR || retries.timeouts != 3 ||
+        retries.retry_exhausted != 1) {
+        return false;
+    }
+
+    if (!post_send(service, requester_endpoint, responder_endpoint, 98, UGDR_WR_RDMA_WRITE, 0) ||
+        !requester.progress_once() || responder.progress_once()) {
+        return false;
+    }
+    completions = drain(service, requester_endpoint);
+    return completions.size() == 1 && completions[0].wr_id == 98 &&
+           completions[0].status == UGDR_WC_WR_FLUSH_ERR;
+}
+
+bool any_order_chunks_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 1101, UINT64_C(0x7a000000), &requester_endpoint) ||
+        !make_endpoint(service, 1102, UINT64_C(0x7b000000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+
+    ugdr::worker::LocalTransport transport(8, 8);
+    ugdr::test::ScriptedCopyBackend backend(8);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester, 16);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder, 16, nullptr, {},
+                                       ugdr::worker::ChunkOrdering::any_order);
+    if (!post_receive(service, responder_endpoint, 111) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 112,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 3) ||
+        !requester.progress_once()) {
+        return false;
+    }
+    std::vector<ugdr::worker::RequestDatagram> chunks;
+    ugdr::worker::RequestDatagram chunk;
+    while (transport.try_pop_request(chunk)) {
+        chunks.push_back(chunk);
+    }
+    if (chunks.size() != 3 || !transport.try_push_request(chunks[2]) ||
+        !transport.try_push_request(chunks[0]) || !transport.try_push_request(chunks[1]) ||
+        !responder.progress_once() || backend.accepted_count() != 3) {
+        return false;
+    }
+    std::array<bool, 3> seen{};
+    for (std::size_t index = 0; index < seen.size(); ++index) {
+        ugdr::worker::BackendRequest completed;
+        if (!backend.progress_at(0, ugdr::worker::DatagramResult::success, &completed) ||
+            completed.payload_index >= seen.size() || seen[completed.payload_index] ||
+            completed.payload_offset != UINT64_C(16) * completed.payload_index) {
+            return false;
+        }
+        seen[completed.payload_index] = true;
+    }
+    if (!responder.progress_once() || !requester.progress_once()) {
+        return false;
+    }
+    const auto completions = drain(service, requester_endpoint);
+    const auto receive_completions = drain(service, responder_endpoint);
+    return completions.size() == 1 && completions[0].wr_id == 112 &&
+           completions[0].status == UGDR_WC_SUCCESS && receive_completions.size() == 1 &&
+           receive_completions[0].wr_id == 111 && receive_completions[0].byte_length == 48;
+}
+
+bool overlapping_chunks_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 1111, UINT64_C(0x7a800000), &requester_endpoint) ||
+        !make_endpoint(service, 1112, UINT64_C(0x7b800000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+
+    ugdr::worker::LocalTransport transport(8, 8);
+    ugdr::test::ScriptedCopyBackend backend(8);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester, 16);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder, 16, nullptr, {},
+                                       ugdr::worker::ChunkOrdering::any_order);
+    if (!post_receive(service, responder_endpoint, 113) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 114,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 4) ||
+        !requester.progress_once()) {
+        return false;
+    }
+    std::vector<ugdr::worker::RequestDatagram> chunks;
+    ugdr::worker::RequestDatagram chunk;
+    while (transport.try_pop_request(chunk)) {
+        chunks.push_back(chunk);
+    }
+    // Chunk 1 rewrites chunk 0's bytes: the lengths still add up to 48, but [16, 32) is never
+    // written.
+    if (chunks.size() != 3) {
+        return false;
+    }
+    chunks[1].payload_offset = 0;
+    if (!transport.try_push_request(chunks[0]) || !transport.try_push_request(chunks[1]) ||
+        !transport.try_push_request(chunks[2]) || !responder.progress_once() ||
+        backend.accepted_count() != 2 ||
+        !backend.progress_at(0, ugdr::worker::DatagramResult::success) ||
+        !backend.progress_at(0, ugdr::worker::DatagramResult::success) ||
+        !responder.progress_once() || !requester.progress_once()) {
+        return false;
+    }
+    const auto completions = drain(service, requester_endpoint);
+    return completions.size() == 1 && completions[0].wr_id == 114 &&
+           completions[0].status == UGDR_WC_REM_INV_REQ_ERR &&
+           drain(service, responder_endpoint).empty();
+}
+
+bool unmapped_source_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint requester_endpoint;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 1121, UINT64_C(0x7c000000), &requester_endpoint) ||
+        !make_endpoint(service, 1122, UINT64_C(0x7d000000), &responder_endpoint) ||
+        !connect_endpoints(service, requester_endpoint, responder_endpoint)) {
+        return false;
+    }
+
+    ugdr::worker::LocalTransport transport(8, 8);
+    ugdr::test::ScriptedCopyBackend backend(8);
+    ugdr::worker::LoopWorker requester(service, requester_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::requester, 16);
+    ugdr::worker::LoopWorker responder(service, responder_endpoint.qp_num, transport, backend,
+                                       ugdr::worker::LoopWorkerRole::responder, 16);
+    if (!post_receive(service, responder_endpoint, 115) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 116,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 5) ||
+        !requester.progress_once()) {
+        return false;
+    }
+    std::vector<ugdr::worker::RequestDatagram> chunks;
+    ugdr::worker::RequestDatagram chunk;
+    while (transport.try_pop_request(chunk)) {
+        chunks.push_back(chunk);
+    }
+    // The transport could map chunk 0 but not chunk 1, as a peer mapping would after removal.
+    if (chunks.size() != 3) {
+        return false;
+    }
+    chunks[1].source_unmapped = true;
+    for (const auto &pushed : chunks) {
+        if (!transport.try_push_request(pushed)) {
+            return false;
+        }
+    }
+    if (!responder.progress_once() || backend.accepted_count() != 2 ||
+        !backend.progress_at(0, ugdr::worker::DatagramResult::success) ||
+        !backend.progress_at(0, ugdr::worker::DatagramResult::success) ||
+        !responder.progress_once() || !requester.progress_once()) {
+        return false;
+    }
+    auto completions = drain(service, requester_endpoint);
+    ugdr::worker::ResponseDatagram extra;
+    if (completions.size() != 1 || completions[0].wr_id != 116 ||
+        completions[0].status != UGDR_WC_REM_ACCESS_ERR ||
+        !drain(service, responder_endpoint).empty() || transport.try_pop_response(extra)) {
+        return false;
+    }
+    // The failed parent left no responder state behind.
+    if (!post_receive(service, responder_endpoint, 117) ||
+        !post_send(service, requester_endpoint, responder_endpoint, 118,
+                   UGDR_WR_RDMA_WRITE_WITH_IMM, UGDR_SEND_SIGNALED, 6) ||
+        !drive(requester, responder, backend, ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    completions = drain(service, requester_endpoint);
+    const auto receive_completions = drain(service, responder_endpoint);
+    return completions.size() == 1 && completions[0].wr_id == 118 &&
+           completions[0].status == UGDR_WC_SUCCESS && receive_completions.size() == 1 &&
+           receive_completions[0].wr_id == 117;
+}
+
+bool shared_receive_queue_test() {
+    FakeCudaBackend memory_backend;
+    ugdr::control::QpService service(memory_backend);
+    Endpoint first_requester;
+    Endpoint second_requester;
+    Endpoint responder_endpoint;
+    if (!make_endpoint(service, 1201, UINT64_C(0x7c000000), &first_requester) ||
+        !make_endpoint(service, 1202, UINT64_C(0x7d000000), &second_requester) ||
+        !make_endpoint(service, 1203, UINT64_C(0x7e000000), &responder_endpoint)) {
+        return false;
+    }
+    auto srq = service.handle(1203, decoded(ugdr::control::make_create_srq_request(
+                                        responder_endpoint.pd_identity, 4, 1)));
+    const std::uint64_t srq_identity = srq.response.object_identity;
+    Endpoint first_shared;
+    Endpoint second_shared;
+    if (srq.response.status != 0 ||
+        !make_srq_endpoint(service, responder_endpoint, srq_identity, &first_shared) ||
+        !make_srq_endpoint(service, responder_endpoint, srq_identity, &second_shared) ||
+        !connect_endpoints(service, first_requester, first_shared) ||
+        !connect_endpoints(service, second_requester, second_shared) ||
+        service.handle(1203, decoded(ugdr::control::make_destroy_srq_request(srq_identity)))
+                .response.status != EBUSY) {
+        return false;
+    }
+
+    ugdr::worker::LocalTransport first_transport(8, 8);
+    ugdr::worker::LocalTransport second_transport(8, 8);
+    ugdr::test::ScriptedCopyBackend first_backend(8);
+    ugdr::test::ScriptedCopyBackend second_backend(8);
+    ugdr::worker::LoopWorker first_request(service, first_requester.qp_num, first_transport,
+                                           first_backend, ugdr::worker::LoopWorkerRole::requester);
+    ugdr::worker::LoopWorker first_response(service, first_shared.qp_num, first_transport,
+                                            first_backend, ugdr::worker::LoopWorkerRole::responder);
+    ugdr::worker::LoopWorker second_request(service, second_requester.qp_num, second_transport,
+                                            second_backend,
+                                            ugdr::worker::LoopWorkerRole::requester);
+    ugdr::worker::LoopWorker second_response(service, second_shared.qp_num, second_transport,
+                                             second_backend,
+                                             ugdr::worker::LoopWorkerRole::responder);
+    if (!post_receive(service, first_shared, 121) || !post_receive(service, second_shared, 122) ||
+        !post_send(service, second_requester, second_shared, 132, UGDR_WR_RDMA_WRITE_WITH_IMM,
+                   UGDR_SEND_SIGNALED, 2) ||
+        !drive(second_request, second_response, second_backend,
+               ugdr::worker::DatagramResult::success) ||
+        !post_send(service, first_requester, first_shared, 131, UGDR_WR_RDMA_WRITE_WITH_IMM,
+                   UGDR_SEND_SIGNALED, 1) ||
+        !drive(first_request, first_response, first_backend,
+               ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    auto receive_completions = drain(service, responder_endpoint);
+    if (drain(service, first_requester).size() != 1 ||
+        drain(service, second_requester).size() != 1 || receive_completions.size() != 2 ||
+        receive_completions[0].wr_id != 121 ||
+        receive_completions[0].qp_num != second_shared.qp_num ||
+        receive_completions[0].immediate_data != 2 || receive_completions[1].wr_id != 122 ||
+        receive_completions[1].qp_num != first_shared.qp_num ||
+        receive_completions[1].immediate_data != 1) {
+        return false;
+    }
+
+    if (!post_send(service, first_requester, first_shared, 133, UGDR_WR_RDMA_WRITE_WITH_IMM,
+                   UGDR_SEND_SIGNALED, 3) ||
+        !first_request.progress_once() || !first_response.progress_once() ||
+        first_response.retry_counters().rnr_naks_sent != 1 ||
+        !post_receive(service, second_shared, 123) ||
+        !drive_with_retries(first_request, first_response, first_backend,
+                            ugdr::worker::DatagramResult::success)) {
+        return false;
+    }
+    receive_completions = drain(service, responder_endpoint);
+    if (drain(service, first_requester).size() != 1 || receive_completions.size() != 1 ||
+        receive_completions[0].wr_id != 123 ||
+        receive_completions[0].qp_num != first_shared.qp_num) {
+        return false;
+    }
+    return service
+                   .handle(1203, decoded(ugdr::control::make_destroy_qp_request(
+                                     first_shared.qp_identity)))
+                   .response.status == 0 &&
+           service
+                   .handle(1203, decoded(ugdr::control::make_destroy_qp_request(
+                                     second_shared.qp_identity)))
+                   .response.status == 0 &&
+           service.handle(1203, decoded(ugdr::control::make_destroy_srq_request(srq_identity)))
+                   .response.status == 0 &&
+           service.srq_count() == 0;
+}
+
 }  // namespace
 
 int main() {
@@ -474,7 +1043,8 @@ int main() {
                    UGDR_SEND_SIGNALED, 9) ||
         !requester.progress_once() || !responder.progress_once() || backend.accepted_count() != 0 ||
         responder.progress_once() || !post_receive(service, responder_endpoint, 22) ||
-        !drive(requester, responder, backend, ugdr::worker::DatagramResult::success)) {
+        !drive_with_retries(requester, responder, backend,
+                            ugdr::worker::DatagramResult::success)) {
         return 9;
     }
     completions = drain(service, requester_endpoint);
@@ -593,8 +1163,12 @@ int main() {
     }
     completions = drain(service, requester_endpoint);
     return completions.size() == 1 && completions[0].wr_id == 16 && sq_sig_all_test() &&
+                   cq_moderation_test() &&
                    payload_split_and_aggregate_test() && deterministic_error_test() &&
-                   backend_batch_backpressure_test()
+                   backend_batch_backpressure_test() && credit_window_test() &&
+                   rnr_retry_test() && rnr_window_test() && ack_timeout_test() &&
+                   any_order_chunks_test() && overlapping_chunks_test() &&
+                   unmapped_source_test() && shared_receive_queue_test()
                ? 0
                : 29;
 }
@@ -0,0 +1,68 @@
+#include "control/mr_key_table.hpp"
+
+#include <cstdint>
+
+int main() {
+    using ugdr::control::MrKeyEntry;
+    using ugdr::control::MrKeyTable;
+
+    MrKeyTable table;
+    MrKeyEntry entry;
+    entry.owner_session = 11;
+    entry.pd_identity = 22;
+    entry.client_address = UINT64_C(0x1000);
+    entry.length = UINT64_C(0x400);
+    entry.daemon_address = UINT64_C(0x80001000);
+    const auto first = table.insert(entry);
+    const auto second = table.insert(entry);
+    if (!first.has_value() || !second.has_value() || first->lkey != UINT32_C(0x00100000) ||
+        first->rkey != UINT32_C(0x00100001) || second->lkey != UINT32_C(0x00100002) ||
+        table.size() != 2) {
+        return 1;
+    }
+    const MrKeyEntry *const found = table.find(second->lkey, false);
+    if (found == nullptr || found->pd_identity != 22 ||
+        found->daemon_address != entry.daemon_address || table.find(second->rkey, true) != found ||
+        table.find(second->rkey, false) != nullptr || table.find(second->lkey, true) != nullptr ||
+        table.find(UINT32_C(0x00100004), false) != nullptr) {
+        return 2;
+    }
+
+    table.erase(first->lkey);
+    table.erase(first->lkey);
+    if (table.size() != 1 || table.find(first->lkey, false) != nullptr ||
+        table.find(first->rkey, true) != nullptr) {
+        return 3;
+    }
+    const auto reused = table.insert(entry);
+    if (!reused.has_value() || reused->lkey != UINT32_C(0x00200000) ||
+        table.find(first->lkey, false) != nullptr || table.find(reused->lkey, false) == nullptr) {
+        return 4;
+    }
+
+    // Cycling one slot past its last generation must never bring back an earlier key.
+    std::uint32_t lkey = reused->lkey;
+    for (int cycle = 0; cycle < 4096; ++cycle) {
+        table.erase(lkey);
+        const auto next = table.insert(entry);
+        if (!next.has_value() || next->lkey == 0 || next->lkey == first->lkey ||
+            table.find(first->lkey, false) != nullptr || table.find(first->rkey, true) != nullptr) {
+            return 5;
+        }
+        lkey = next->lkey;
+    }
+    if ((lkey & UINT32_C(0x000fffff)) != 4 || table.size() != 2) {
+        return 6;
+    }
+
+    // Freed slots are reused oldest first.
+    table.erase(second->lkey);
+    table.erase(lkey);
+    const auto oldest = table.insert(entry);
+    const auto newest = table.insert(entry);
+    if (!oldest.has_value() || !newest.has_value() ||
+        (oldest->lkey & UINT32_C(0x000fffff)) != 2 || (newest->lkey & UINT32_C(0x000fffff)) != 4) {
+        return 7;
+    }
+    return 0;
+}
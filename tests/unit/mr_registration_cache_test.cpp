@@ -0,0 +1,87 @@
+#include "api/mr_registration_cache.hpp"
+
+#include <cerrno>
+#include <cstdint>
+
+namespace {
+
+constexpr std::uint32_t kLocal = UGDR_ACCESS_LOCAL_WRITE;
+constexpr std::uint32_t kRemote = UGDR_ACCESS_LOCAL_WRITE | UGDR_ACCESS_REMOTE_WRITE;
+
+ugdr_mr make_mr(ugdr_pd *pd, std::uintptr_t address, std::size_t length) {
+    ugdr_mr mr{};
+    mr.pd = pd;
+    mr.addr = reinterpret_cast<void *>(address);
+    mr.length = length;
+    return mr;
+}
+
+}  // namespace
+
+int main() {
+    auto *const pd = reinterpret_cast<ugdr_pd *>(std::uintptr_t{0x1000});
+    auto *const other_pd = reinterpret_cast<ugdr_pd *>(std::uintptr_t{0x2000});
+
+    ugdr::api::MrRegistrationCache disabled;
+    if (disabled.enabled()) {
+        return 1;
+    }
+
+    ugdr::api::MrRegistrationCache cache(2);
+    ugdr_mr wide = make_mr(pd, 0x10000, 0x1000);
+    ugdr_mr same_start = make_mr(pd, 0x10000, 0x2000);
+    if (!cache.enabled() || !cache.insert(&wide, kLocal) || cache.insert(&same_start, kLocal) ||
+        cache.contains(&same_start) || cache.size() != 1) {
+        return 2;
+    }
+
+    // Contained ranges share the registration; PD, access, and overhanging ranges miss.
+    if (cache.acquire(pd, 0x10000, 0x1000, kLocal) != &wide ||
+        cache.acquire(pd, 0x10400, 0x100, kLocal) != &wide ||
+        cache.acquire(pd, 0x10f00, 0x200, kLocal) != nullptr ||
+        cache.acquire(pd, 0xff00, 0x200, kLocal) != nullptr ||
+        cache.acquire(pd, 0x10000, 0x100, kRemote) != nullptr ||
+        cache.acquire(other_pd, 0x10000, 0x100, kLocal) != nullptr ||
+        cache.acquire(pd, UINT64_MAX, 2, kLocal) != nullptr) {
+        return 3;
+    }
+
+    // Three references: the insert and two hits.
+    if (cache.release(&wide) != 0 || cache.release(&wide) != 0 || cache.idle_count() != 0 ||
+        cache.release(&wide) != 0 || cache.idle_count() != 1 || cache.release(&wide) != EINVAL ||
+        cache.release(&same_start) != EINVAL) {
+        return 4;
+    }
+    // An idle hit takes the registration back out of the LRU.
+    if (cache.acquire(pd, 0x10800, 0x10, kLocal) != &wide || cache.idle_count() != 0 ||
+        cache.release(&wide) != 0 || cache.idle_in(pd) != &wide ||
+        cache.idle_in(other_pd) != nullptr) {
+        return 5;
+    }
+
+    // A registration ending before address must not hide an earlier one that covers it.
+    ugdr_mr narrow = make_mr(pd, 0x10100, 0x10);
+    ugdr_mr remote = make_mr(other_pd, 0x20000, 0x1000);
+    if (!cache.insert(&narrow, kLocal) || !cache.insert(&remote, kRemote) ||
+        cache.acquire(pd, 0x10200, 0x10, kLocal) != &wide ||
+        cache.acquire(other_pd, 0x20000, 0x10, kRemote) != &remote) {
+        return 6;
+    }
+
+    // Least recently released goes first, and only once the idle bound is exceeded.
+    if (cache.release(&wide) != 0 || cache.release(&narrow) != 0 ||
+        cache.next_eviction() != nullptr || cache.release(&remote) != 0 ||
+        cache.release(&remote) != 0 || cache.idle_count() != 3 ||
+        cache.next_eviction() != &wide) {
+        return 7;
+    }
+    cache.erase(&wide);
+    if (cache.contains(&wide) || cache.next_eviction() != nullptr || cache.size() != 2 ||
+        cache.acquire(pd, 0x10200, 0x10, kLocal) != nullptr) {
+        return 8;
+    }
+    cache.erase(&narrow);
+    cache.erase(&remote);
+    cache.erase(&remote);
+    return cache.size() == 0 && cache.idle_count() == 0 ? 0 : 9;
+}
@@ -0,0 +1,111 @@
+#include "worker/mr_translation_cache.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+class FakeCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &memory,
+             ugdr::gpu::CudaIpcMapping *mapping) override {
+        mapping->gpu_uuid = memory.gpu_uuid;
+        mapping->daemon_base_address = UINT64_C(0x80000000);
+        return 0;
+    }
+
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return 0;
+    }
+};
+
+ugdr::control::DecodedControlRequest decoded(ugdr::control::UgdrControlRequest request) {
+    ugdr::control::DecodedControlRequest value;
+    value.value = std::move(request);
+    return value;
+}
+
+}  // namespace
+
+int main() {
+    using ugdr::control::MrRegistrationResult;
+
+    constexpr ugdr::ipc::SessionId session = 5;
+    FakeCudaBackend backend;
+    ugdr::control::PdMrCqService service(backend);
+    const auto context =
+        service.handle(session, decoded(ugdr::control::make_create_context_request(1)));
+    const auto pd = service.handle(session, decoded(ugdr::control::make_create_pd_request(
+                                                context.response.object_identity)));
+    const std::uint64_t pd_identity = pd.response.object_identity;
+    ugdr::gpu::ExportedCudaMemory memory;
+    memory.gpu_uuid[0] = 3;
+    memory.client_address = UINT64_C(0x10000000);
+    memory.allocation_size = UINT64_C(0x2000);
+    memory.length = UINT64_C(0x1000);
+    memory.ipc_handle.resize(64, std::byte{0x5a});
+    const auto registered = service.handle(
+        session, decoded(ugdr::control::make_register_mr_request(
+                     pd_identity, memory,
+                     ugdr::control::kAccessLocalWrite | ugdr::control::kAccessRemoteWrite)));
+    MrRegistrationResult keys;
+    if (registered.response.status != 0 ||
+        ugdr::control::decode_mr_registration_result(registered.response.opaque, &keys) != 0) {
+        return 1;
+    }
+
+    ugdr::worker::MrTranslationCache cache;
+    std::uint64_t address = 0;
+    if (cache.resolve(service, session, pd_identity, keys.lkey, false, memory.client_address + 16,
+                      32, &address) != 0 ||
+        address != UINT64_C(0x80000010) ||
+        cache.resolve(service, session, pd_identity, keys.lkey, false, memory.client_address + 64,
+                      32, &address) != 0 ||
+        address != UINT64_C(0x80000040) ||
+        cache.resolve(service, session, pd_identity, keys.rkey, true, memory.client_address, 8,
+                      &address) != 0 ||
+        cache.hits() != 1 || cache.misses() != 2) {
+        return 2;
+    }
+    if (cache.resolve(service, session, pd_identity, keys.lkey, false,
+                      memory.client_address + memory.length, 1, &address) != EINVAL ||
+        cache.resolve(service, session, pd_identity, keys.lkey, true, memory.client_address, 1,
+                      &address) != EINVAL ||
+        cache.resolve(service, session + 1, pd_identity, keys.lkey, false, memory.client_address,
+                      1, &address) != EINVAL ||
+        cache.resolve(service, session, pd_identity + 1, keys.lkey, false, memory.client_address,
+                      1, &address) != EINVAL) {
+        return 3;
+    }
+
+    const auto epoch = service.mr_key_epoch();
+    if (service
+                .handle(session, decoded(ugdr::control::make_deregister_mr_request(
+                                     registered.response.object_identity)))
+                .response.status != 0 ||
+        service.mr_key_epoch() == epoch ||
+        cache.resolve(service, session, pd_identity, keys.lkey, false, memory.client_address, 1,
+                      &address) != EINVAL) {
+        return 4;
+    }
+
+    const auto again = service.handle(
+        session, decoded(ugdr::control::make_register_mr_request(
+                     pd_identity, memory, ugdr::control::kAccessLocalWrite)));
+    MrRegistrationResult new_keys;
+    if (again.response.status != 0 ||
+        ugdr::control::decode_mr_registration_result(again.response.opaque, &new_keys) != 0 ||
+        cache.resolve(service, session, pd_identity, new_keys.lkey, false, memory.client_address,
+                      1, &address) != 0 ||
+        cache.resolve(service, session, pd_identity, new_keys.rkey, true, memory.client_address, 1,
+                      &address) != EACCES) {
+        return 5;
+    }
+    service.on_disconnect(session);
+    return cache.resolve(service, session, pd_identity, new_keys.lkey, false,
+                         memory.client_address, 1, &address) == EINVAL
+               ? 0
+               : 6;
+}
@@ -0,0 +1,112 @@
+#include "control/device_context.hpp"
+#include "queue/numa.hpp"
+#include "queue/shared_ring.hpp"
+
+#include <cerrno>
+#include <string>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+int cpu_list_test() {
+    cpu_set_t cpus;
+    if (ugdr::queue::parse_cpu_list("0-3,8,10-11\n", &cpus) != 0 || CPU_COUNT(&cpus) != 7 ||
+        !CPU_ISSET(8, &cpus) || !CPU_ISSET(11, &cpus) || CPU_ISSET(9, &cpus)) {
+        return 1;
+    }
+    if (ugdr::queue::parse_cpu_list("5", &cpus) != 0 || CPU_COUNT(&cpus) != 1 ||
+        !CPU_ISSET(5, &cpus)) {
+        return 2;
+    }
+    for (const char *malformed : {"", "\n", "3-1", "1,,2", "a", "1-", "4096", "1;2"}) {
+        if (ugdr::queue::parse_cpu_list(malformed, &cpus) != EINVAL) {
+            return 3;
+        }
+    }
+    return 0;
+}
+
+int placement_test() {
+    if (ugdr::queue::numa_node_count() < 1) {
+        return 1;
+    }
+    int node = 7;
+    if (ugdr::queue::pci_device_numa_node("../node", &node) != EINVAL ||
+        ugdr::queue::pci_device_numa_node("", &node) != EINVAL ||
+        ugdr::queue::pci_device_numa_node("ffff:ff:1f.7", &node) != ENOENT || node != 7) {
+        return 2;
+    }
+
+    const long page = sysconf(_SC_PAGESIZE);
+    void *memory = mmap(nullptr, static_cast<std::size_t>(page), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page <= 0 || memory == MAP_FAILED) {
+        return 3;
+    }
+    // Sandboxes may refuse mbind; the policy is only ever applied on a best-effort basis.
+    const int bind_status =
+        ugdr::queue::bind_memory_to_numa_node(memory, static_cast<std::size_t>(page), 0);
+    const bool rejected =
+        ugdr::queue::bind_memory_to_numa_node(memory, static_cast<std::size_t>(page), -2) !=
+            EINVAL ||
+        ugdr::queue::bind_memory_to_numa_node(memory, static_cast<std::size_t>(page),
+                                              ugdr::queue::kNoNumaNode) != 0;
+    (void)munmap(memory, static_cast<std::size_t>(page));
+    if ((bind_status != 0 && bind_status != ENOSYS && bind_status != EPERM) || rejected) {
+        return 4;
+    }
+
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) != 0) {
+        return 5;
+    }
+    const int pin_status = ugdr::queue::pin_thread_to_numa_node(0);
+    (void)sched_setaffinity(0, sizeof(original), &original);
+    if ((pin_status != 0 && pin_status != ENOENT) ||
+        ugdr::queue::pin_thread_to_numa_node(ugdr::queue::kNoNumaNode) != 0 ||
+        ugdr::queue::pin_thread_to_numa_node(-2) != EINVAL) {
+        return 6;
+    }
+
+    // A ring that prefers node 0 is an ordinary ring on every host.
+    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, 64, 64};
+    ugdr::queue::RingMemoryOptions options;
+    options.numa_node = 0;
+    ugdr::queue::SharedRing ring;
+    void *slot = nullptr;
+    if (ugdr::queue::create_shared_ring(descriptor, &ring, options) != 0 ||
+        ring.producer_reserve(&slot) != 0 || ring.producer_publish() != 0) {
+        return 7;
+    }
+    return 0;
+}
+
+int catalog_test() {
+    ugdr::control::DeviceCatalog catalog;
+    const std::uint64_t identity = catalog.devices().front().identity;
+    if (catalog.numa_node(identity) != ugdr::queue::kNoNumaNode ||
+        catalog.numa_node(identity + 1) != ugdr::queue::kNoNumaNode) {
+        return 1;
+    }
+    if (catalog.set_pci_address(identity + 1, "0000:00:00.0") != ENOENT ||
+        catalog.set_pci_address(identity, "../node") != EINVAL ||
+        catalog.numa_node(identity) != ugdr::queue::kNoNumaNode) {
+        return 2;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main() {
+    if (cpu_list_test() != 0) {
+        return 1;
+    }
+    if (placement_test() != 0) {
+        return 2;
+    }
+    return catalog_test() != 0 ? 3 : 0;
+}
@@ -59,6 +59,35 @@ int main() {
         return 7;
     }
 
+    GenerationRegistry<Record, ObjectType::context> sessions;
+    std::uint64_t middle = 0;
+    for (int index = 0; index < 9; ++index) {
+        const auto identity = sessions.insert(40 + index % 3, Record{index});
+        if (!identity.has_value()) {
+            return 10;
+        }
+        middle = index == 4 ? *identity : middle;
+    }
+    int visited = 0;
+    int sum = 0;
+    sessions.for_each_session(41, [&](std::uint64_t identity, Record &record) {
+        visited += sessions.resolve(41, identity) == &record ? 1 : 100;
+        sum += record.value;
+    });
+    if (visited != 3 || sum != 1 + 4 + 7 || sessions.erase(41, middle) != 0 ||
+        sessions.erase_session(41) != 2 || sessions.erase_session(41) != 0 ||
+        sessions.erase_session(99) != 0 || sessions.size() != 6 ||
+        sessions.erase_session(40) != 3 || sessions.erase_session(42) != 3 ||
+        sessions.size() != 0) {
+        return 11;
+    }
+    const auto after_teardown = sessions.insert(41, Record{21});
+    visited = 0;
+    sessions.for_each_session(41, [&](std::uint64_t, Record &) { ++visited; });
+    if (!after_teardown.has_value() || visited != 1 || sessions.erase_session(41) != 1) {
+        return 12;
+    }
+
     GenerationRegistry<Record, ObjectType::context> wrapping(
         std::numeric_limits<std::uint32_t>::max());
     const auto last_generation = wrapping.insert(31, Record{17});
@@ -223,9 +223,58 @@ int main() {
             0 ||
         local_keys.lkey <= accepted.lkey || local_keys.rkey <= accepted.rkey ||
         service.resolve_rkey(session, pd_identity, local_keys.rkey, memory.client_address, 1,
-                             &daemon_address) != EACCES) {
+                             &daemon_address) != EACCES ||
+        service.resolve_lkey(session, pd_identity, accepted.lkey, memory.client_address, 1,
+                             &daemon_address) != EINVAL ||
+        service.resolve_lkey(session, pd_identity, local_keys.rkey, memory.client_address, 1,
+                             &daemon_address) != EINVAL ||
+        service.resolve_lkey(session + 1, pd_identity, local_keys.lkey, memory.client_address, 1,
+                             &daemon_address) != EINVAL) {
         return 14;
     }
+    // MRs inside one exported allocation share a single backend mapping.
+    auto sibling_memory = memory;
+    sibling_memory.client_address = UINT64_C(0x10002000);
+    sibling_memory.allocation_offset = UINT64_C(0x2000);
+    sibling_memory.length = UINT64_C(0x100);
+    const int opens_before_sibling = backend.open_calls;
+    auto sibling = service.handle(
+        session, decoded(ugdr::control::make_register_mr_request(
+                     pd_identity, sibling_memory, ugdr::control::kAccessLocalWrite)));
+    MrRegistrationResult sibling_keys;
+    if (sibling.response.status != 0 ||
+        ugdr::control::decode_mr_registration_result(sibling.response.opaque, &sibling_keys) !=
+            0 ||
+        backend.open_calls != opens_before_sibling || backend.live_mappings != 1 ||
+        service.resolve_lkey(session, pd_identity, sibling_keys.lkey,
+                             sibling_memory.client_address, 1, &daemon_address) != 0 ||
+        daemon_address != UINT64_C(0x80102000)) {
+        return 18;
+    }
+    auto resized_memory = sibling_memory;
+    resized_memory.allocation_size *= 2;
+    auto other_memory = sibling_memory;
+    other_memory.ipc_handle[0] = std::byte{0x6b};
+    auto resized = service.handle(
+        session, decoded(ugdr::control::make_register_mr_request(
+                     pd_identity, resized_memory, ugdr::control::kAccessLocalWrite)));
+    auto other = service.handle(session,
+                                decoded(ugdr::control::make_register_mr_request(
+                                    pd_identity, other_memory, ugdr::control::kAccessLocalWrite)));
+    if (resized.response.status != EINVAL || other.response.status != 0 ||
+        backend.open_calls != opens_before_sibling + 1 || backend.live_mappings != 2) {
+        return 19;
+    }
+    if (service.handle(session, decoded(ugdr::control::make_deregister_mr_request(
+                                    sibling.response.object_identity)))
+                .response.status != 0 ||
+        backend.live_mappings != 2 ||
+        service.handle(session, decoded(ugdr::control::make_deregister_mr_request(
+                                    other.response.object_identity)))
+                .response.status != 0 ||
+        backend.live_mappings != 1) {
+        return 20;
+    }
     if (service.handle(session, decoded(ugdr::control::make_deregister_mr_request(
                                     local_only.response.object_identity)))
                 .response.status != 0 ||
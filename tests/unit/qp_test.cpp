@@ -45,7 +45,8 @@ int main() {
                                                 3,
                                                 5,
                                                 ugdr::control::kQpTypeRc,
-                                                1};
+                                                1,
+                                                UINT64_C(0x2122232425262728)};
     std::vector<std::byte> bytes;
     QpCreateAttributes round_trip;
     if (ugdr::control::encode_qp_create_attributes(encoded_attributes, &bytes) != 0 ||
@@ -270,6 +271,60 @@ int main() {
         return 22;
     }
 
+    auto malformed_srq = ugdr::control::make_create_srq_request(pd_identity, 4, 2);
+    malformed_srq.opaque.pop_back();
+    auto srq = service.handle(
+        session, decoded(ugdr::control::make_create_srq_request(pd_identity, 4, 2)));
+    if (service.handle(session, decoded(std::move(malformed_srq))).response.status != EPROTO ||
+        service.handle(session, decoded(ugdr::control::make_create_srq_request(pd_identity, 0, 2)))
+                .response.status != EINVAL ||
+        srq.response.status != 0 || srq.response.fd_indices.size() != 1 ||
+        service.srq_count() != 1) {
+        return 23;
+    }
+    const std::uint64_t srq_identity = srq.response.object_identity;
+    QpCreateAttributes shared = attributes(local_cq.response.object_identity,
+                                           local_cq.response.object_identity);
+    shared.srq_identity = srq_identity;
+    if (service.handle(session, decoded(ugdr::control::make_create_qp_request(pd_identity, shared)))
+            .response.status != EINVAL) {
+        return 24;
+    }
+    shared.max_recv_wr = 0;
+    shared.max_recv_sge = 0;
+    auto shared_qp = service.handle(
+        session, decoded(ugdr::control::make_create_qp_request(pd_identity, shared)));
+    ugdr::control::WorkerQpView view;
+    // QPN 5 went to the second local QP above, so the SRQ-attached QP is 6.
+    if (shared_qp.response.status != 0 || shared_qp.response.fd_indices.size() != 1 ||
+        shared_qp.file_descriptors.size() != 1 || service.worker_qp_view(6, &view) != 0 ||
+        !view.shared_receive_queue || view.max_recv_sge != 2 ||
+        service.handle(session, decoded(ugdr::control::make_destroy_srq_request(srq_identity)))
+                .response.status != EBUSY ||
+        service.handle(session, decoded(ugdr::control::make_destroy_qp_request(
+                                    shared_qp.response.object_identity)))
+                .response.status != 0 ||
+        service.handle(session, decoded(ugdr::control::make_destroy_pd_request(pd_identity)))
+                .response.status != EBUSY) {
+        return 25;
+    }
+    auto shared_again = service.handle(
+        session, decoded(ugdr::control::make_create_qp_request(pd_identity, shared)));
+    if (shared_again.response.status != 0 ||
+        service.handle(session, decoded(ugdr::control::make_destroy_qp_request(
+                                    shared_again.response.object_identity)))
+                .response.status != 0 ||
+        service.handle(session, decoded(ugdr::control::make_destroy_srq_request(srq_identity)))
+                .response.status != 0 ||
+        service.srq_count() != 0) {
+        return 26;
+    }
+    auto leaked_srq = service.handle(
+        session, decoded(ugdr::control::make_create_srq_request(pd_identity, 4, 2)));
+    if (leaked_srq.response.status != 0) {
+        return 27;
+    }
+
     auto final_cq = service.handle(session, decoded(ugdr::control::make_create_cq_request(
                                                 context.response.object_identity, 12)));
     auto final_qp =
@@ -277,11 +332,11 @@ int main() {
                                     pd_identity, attributes(final_cq.response.object_identity,
                                                             final_cq.response.object_identity))));
     if (final_cq.response.status != 0 || final_qp.response.status != 0 || service.qp_count() != 3) {
-        return 23;
+        return 28;
     }
     service.on_disconnect(session);
-    return service.qp_count() == 0 && service.cq_count() == 0 && service.pd_count() == 0 &&
-                   service.context_count() == 0
+    return service.qp_count() == 0 && service.srq_count() == 0 && service.cq_count() == 0 &&
+                   service.pd_count() == 0 && service.context_count() == 0
                ? 0
-               : 24;
+               : 29;
 }
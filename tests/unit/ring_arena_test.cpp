@@ -0,0 +1,179 @@
+#include "control/pd_mr_cq.hpp"
+#include "control/queue_descriptor.hpp"
+#include "queue/descriptors.hpp"
+#include "queue/ring_arena.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+using ugdr::queue::QueueDescriptor;
+using ugdr::queue::QueueKind;
+using ugdr::queue::SharedRing;
+using ugdr::queue::SharedRingArena;
+
+class NullCudaBackend final : public ugdr::gpu::CudaIpcMemoryBackend {
+  public:
+    int open(const ugdr::gpu::ExportedCudaMemory &, ugdr::gpu::CudaIpcMapping *) override {
+        return 0;
+    }
+
+    int close(const ugdr::gpu::CudaIpcMapping &) noexcept override {
+        return 0;
+    }
+};
+
+ugdr::control::DecodedControlRequest decoded(ugdr::control::UgdrControlRequest request) {
+    ugdr::control::DecodedControlRequest value;
+    value.value = std::move(request);
+    return value;
+}
+
+// Maps the daemon's arena a second time, the way a client sees it.
+bool map_peer(const SharedRingArena &arena, std::shared_ptr<SharedRingArena> *peer) {
+    int descriptor = -1;
+    if (arena.duplicate_fd(&descriptor) != 0) {
+        return false;
+    }
+    const int status = SharedRingArena::map(descriptor, peer);
+    (void)::close(descriptor);
+    return status == 0;
+}
+
+bool round_trip(SharedRing &producer, SharedRing &consumer, std::uint64_t value) {
+    void *slot = nullptr;
+    if (producer.producer_reserve(&slot) != 0) {
+        return false;
+    }
+    std::memcpy(slot, &value, sizeof(value));
+    const void *seen = nullptr;
+    std::uint64_t read = 0;
+    if (producer.producer_publish() != 0 || consumer.consumer_peek(&seen) != 0) {
+        return false;
+    }
+    std::memcpy(&read, seen, sizeof(read));
+    return consumer.consumer_release() == 0 && read == value;
+}
+
+}  // namespace
+
+int main() {
+    const long page = sysconf(_SC_PAGESIZE);
+    const QueueDescriptor send{QueueKind::send, 64, 128};
+    std::size_t ring_bytes = 0;
+    if (page <= 0 || ugdr::queue::shared_ring_mapping_size(send, static_cast<std::size_t>(page),
+                                                           &ring_bytes) != 0) {
+        return 1;
+    }
+
+    std::shared_ptr<SharedRingArena> arena;
+    if (SharedRingArena::create(0, &arena) != EINVAL ||
+        SharedRingArena::create(ugdr::queue::kMaxRingArenaBytes + 1, &arena) != EINVAL ||
+        SharedRingArena::create(3 * ring_bytes, &arena) != 0 || arena->size() != 3 * ring_bytes) {
+        return 2;
+    }
+
+    // Rings are carved first fit, share no fd, and return their range on reset.
+    SharedRing first;
+    SharedRing second;
+    SharedRing third;
+    SharedRing overflow;
+    if (ugdr::queue::create_arena_ring(arena, send, &first) != 0 ||
+        ugdr::queue::create_arena_ring(arena, send, &second) != 0 ||
+        ugdr::queue::create_arena_ring(arena, send, &third) != 0 ||
+        ugdr::queue::create_arena_ring(arena, send, &overflow) != ENOMEM || !first.in_arena() ||
+        first.arena_offset() != 0 || second.arena_offset() != ring_bytes ||
+        third.arena_offset() != 2 * ring_bytes || arena->allocated_bytes() != 3 * ring_bytes) {
+        return 3;
+    }
+    int descriptor = -1;
+    if (first.duplicate_fd(&descriptor) != EINVAL) {
+        return 4;
+    }
+    first.reset();
+    second.reset();
+    if (arena->allocated_bytes() != ring_bytes) {
+        return 5;
+    }
+    // The two released neighbours coalesce, so a double-sized ring fits in their place.
+    const QueueDescriptor wide{QueueKind::send, 128, 128};
+    SharedRing widened;
+    if (ugdr::queue::create_arena_ring(arena, wide, &widened) != 0 || widened.arena_offset() != 0) {
+        return 6;
+    }
+
+    // A peer mapping of the arena sees the same ring at the same offset.
+    std::shared_ptr<SharedRingArena> peer;
+    SharedRing mapped;
+    SharedRing misplaced;
+    if (!map_peer(*arena, &peer) || peer->size() != arena->size() ||
+        ugdr::queue::map_arena_ring(peer, third.arena_offset(), send, &mapped) != 0 ||
+        !round_trip(third, mapped, 41) || !round_trip(mapped, third, 42) ||
+        ugdr::queue::map_arena_ring(peer, third.arena_offset(), wide, &misplaced) != EPROTO ||
+        ugdr::queue::map_arena_ring(peer, 1, send, &misplaced) != EPROTO ||
+        ugdr::queue::map_arena_ring(peer, peer->size(), send, &misplaced) != EPROTO) {
+        return 7;
+    }
+    // Mapped rings never return the range; only the creator does.
+    const std::size_t allocated = arena->allocated_bytes();
+    mapped.reset();
+    if (allocated == 0 || arena->allocated_bytes() != allocated) {
+        return 8;
+    }
+
+    // Version 2 descriptor payloads carry offsets and need an arena to decode.
+    std::vector<std::byte> bytes;
+    const std::vector<std::uint64_t> offsets{UINT64_C(0x123456789000)};
+    std::vector<QueueDescriptor> descriptors;
+    std::vector<std::uint64_t> decoded_offsets;
+    if (ugdr::control::encode_queue_descriptors({send}, &bytes, &offsets) != 0 ||
+        ugdr::control::decode_queue_descriptors(bytes, &descriptors) != EPROTO ||
+        ugdr::control::decode_queue_descriptors(bytes, &descriptors, &decoded_offsets) != 0 ||
+        descriptors != std::vector<QueueDescriptor>{send} || decoded_offsets != offsets) {
+        return 9;
+    }
+
+    // With an arena mapped, the service answers creates with offsets and no fds.
+    NullCudaBackend backend;
+    ugdr::control::PdMrCqService service(backend);
+    constexpr ugdr::ipc::SessionId session = 1;
+    const auto context =
+        service.handle(session, decoded(ugdr::control::make_create_context_request(1)));
+    const auto context_identity = context.response.object_identity;
+    const auto plain = service.handle(
+        session, decoded(ugdr::control::make_create_cq_request(context_identity, 16)));
+    const auto mapping = service.handle(
+        session, decoded(ugdr::control::make_map_ring_arena_request(context_identity, 1 << 20)));
+    const auto again = service.handle(
+        session, decoded(ugdr::control::make_map_ring_arena_request(context_identity, 1 << 20)));
+    const auto carved = service.handle(
+        session, decoded(ugdr::control::make_create_cq_request(context_identity, 16)));
+    if (context.response.status != 0 || plain.response.status != 0 ||
+        plain.file_descriptors.size() != 1 || mapping.response.status != 0 ||
+        mapping.file_descriptors.size() != 1 || again.response.status != EEXIST ||
+        carved.response.status != 0 || !carved.file_descriptors.empty() ||
+        !carved.response.fd_indices.empty()) {
+        return 10;
+    }
+    std::shared_ptr<SharedRingArena> client_arena;
+    ugdr::control::DecodedControlResponse response;
+    response.value = carved.response;
+    std::vector<SharedRing> rings;
+    const QueueDescriptor completion{QueueKind::completion, 16,
+                                     ugdr::queue::completion_slot_stride()};
+    if (SharedRingArena::map(mapping.file_descriptors[0].get(), &client_arena) != 0 ||
+        ugdr::control::map_queue_rings(response, {completion}, {}, &rings) != EPROTO ||
+        ugdr::control::map_queue_rings(response, {completion}, {client_arena}, &rings) != 0 ||
+        rings.size() != 1 || !rings[0].in_arena() || client_arena->allocated_bytes() != 0) {
+        return 11;
+    }
+    service.on_disconnect(session);
+    return service.cq_count() == 0 && service.context_count() == 0 ? 0 : 12;
+}
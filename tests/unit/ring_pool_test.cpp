@@ -0,0 +1,124 @@
+#include "queue/ring_pool.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+using ugdr::queue::QueueDescriptor;
+using ugdr::queue::QueueKind;
+using ugdr::queue::SharedRing;
+using ugdr::queue::SharedRingPool;
+
+bool fresh(const SharedRing &ring, const QueueDescriptor &descriptor) {
+    return ring.valid() && ring.descriptor() == descriptor && ring.producer_position() == 0 &&
+           ring.consumer_position() == 0;
+}
+
+bool wait_available(const SharedRingPool &pool, const QueueDescriptor &descriptor,
+                    std::size_t count) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (pool.available(descriptor) != count) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    const QueueDescriptor send{QueueKind::send, 64, 128};
+    const QueueDescriptor completion{QueueKind::completion, 64, 64};
+
+    SharedRingPool pool(2);
+    SharedRing first;
+    // A shape is pooled once it has been created on demand.
+    if (pool.acquire(send, &first) != 0 || !fresh(first, send) || pool.misses() != 1 ||
+        pool.available(send) != 0 || pool.acquire(send, &first) != EINVAL ||
+        pool.acquire(send, nullptr) != EINVAL) {
+        return 1;
+    }
+    pool.refill();
+    SharedRing second;
+    SharedRing third;
+    if (pool.available(send) != 2 || pool.acquire(send, &second) != 0 ||
+        pool.acquire(send, &third) != 0 || pool.hits() != 2 || pool.available(send) != 0 ||
+        !fresh(second, send) || !fresh(third, send) ||
+        second.mapping_address() == third.mapping_address() ||
+        second.mapping_address() == first.mapping_address()) {
+        return 2;
+    }
+
+    // Shapes that fail to create are never pooled.
+    SharedRing invalid;
+    const QueueDescriptor zero{QueueKind::send, 0, 128};
+    pool.refill();
+    if (pool.acquire(zero, &invalid) != EINVAL || invalid.valid() || pool.available(zero) != 0) {
+        return 3;
+    }
+
+    // Rings above the size cap are created on demand but never kept.
+    const QueueDescriptor large{QueueKind::completion, 65536, 64};
+    SharedRing unbounded;
+    pool.refill();
+    if (pool.acquire(large, &unbounded) != 0 || !fresh(unbounded, large) ||
+        pool.available(large) != 0) {
+        return 9;
+    }
+
+    // Once every shape slot is taken, a new shape replaces the least recently requested one.
+    SharedRingPool bounded(1);
+    SharedRing common;
+    if (bounded.acquire(send, &common) != 0) {
+        return 10;
+    }
+    for (std::uint32_t index = 0; index < SharedRingPool::kMaxShapes; ++index) {
+        SharedRing unusual;
+        if (bounded.acquire({QueueKind::receive, 64 + index, 64}, &unusual) != 0) {
+            return 10;
+        }
+    }
+    bounded.refill();
+    SharedRing again;
+    if (bounded.available(send) != 0 ||
+        bounded.available({QueueKind::receive, 64, 64}) != 1 ||
+        bounded.available({QueueKind::receive, 64 + SharedRingPool::kMaxShapes - 1, 64}) != 1 ||
+        bounded.acquire(send, &again) != 0 || !fresh(again, send)) {
+        return 11;
+    }
+    bounded.refill();
+    if (bounded.available(send) != 1 || bounded.available({QueueKind::receive, 64, 64}) != 0) {
+        return 12;
+    }
+
+    SharedRingPool disabled(0);
+    SharedRing unpooled;
+    disabled.refill();
+    if (disabled.acquire(completion, &unpooled) != 0 || !fresh(unpooled, completion) ||
+        disabled.available(completion) != 0) {
+        return 4;
+    }
+
+    // The background thread tops a shape back up after each acquire.
+    if (pool.start() != 0 || pool.start() != EBUSY) {
+        return 5;
+    }
+    SharedRing cq;
+    if (pool.acquire(completion, &cq) != 0 || !fresh(cq, completion) ||
+        !wait_available(pool, completion, 2) || !wait_available(pool, send, 2)) {
+        return 6;
+    }
+    SharedRing pooled_cq;
+    if (pool.acquire(completion, &pooled_cq) != 0 || !fresh(pooled_cq, completion) ||
+        !wait_available(pool, completion, 2)) {
+        return 7;
+    }
+    pool.stop();
+    SharedRing after_stop;
+    return pool.acquire(send, &after_stop) == 0 && fresh(after_stop, send) ? 0 : 8;
+}
@@ -0,0 +1,166 @@
+#include "worker/shared_memory_transport.hpp"
+
+#include <cerrno>
+#include <cstdint>
+
+#include <unistd.h>
+
+namespace {
+
+using ugdr::worker::DatagramOpcode;
+using ugdr::worker::DatagramResult;
+using ugdr::worker::PeerMemoryMapping;
+using ugdr::worker::RequestDatagram;
+using ugdr::worker::ResponseDatagram;
+using ugdr::worker::SharedMemoryTransport;
+
+RequestDatagram request(std::uint64_t id, std::uint64_t source_address = 0) {
+    return {id,
+            static_cast<std::uint32_t>(id + 10),
+            static_cast<std::uint32_t>(id + 20),
+            DatagramOpcode::rdma_write_with_immediate,
+            UINT64_C(0x100000000) + id,
+            static_cast<std::uint32_t>(id + 30),
+            static_cast<std::uint32_t>(id + 40),
+            12,
+            5,
+            source_address == 0 ? UINT64_C(0x200000000) + id : source_address,
+            7,
+            1,
+            2};
+}
+
+bool attach_pair(SharedMemoryTransport *requester, SharedMemoryTransport *responder,
+                 std::uint32_t request_capacity, std::uint32_t response_capacity) {
+    if (ugdr::worker::create_shared_memory_transport(request_capacity, response_capacity,
+                                                     requester) != 0) {
+        return false;
+    }
+    int request_fd = -1;
+    int response_fd = -1;
+    if (requester->duplicate_fds(&request_fd, &response_fd) != 0) {
+        return false;
+    }
+    const int status = ugdr::worker::attach_shared_memory_transport(
+        request_fd, response_fd, request_capacity, response_capacity, responder);
+    (void)::close(request_fd);
+    (void)::close(response_fd);
+    // Identity-map the default payload addresses so round trips come back unchanged.
+    return status == 0 && responder->valid() &&
+           responder->add_peer_mapping({UINT64_C(0x200000000), 0x1000, UINT64_C(0x200000000)}) ==
+               0;
+}
+
+bool cross_mapping_round_trip_test() {
+    SharedMemoryTransport requester;
+    SharedMemoryTransport responder;
+    if (!attach_pair(&requester, &responder, 4, 4)) {
+        return false;
+    }
+    const RequestDatagram expected = request(1);
+    RequestDatagram actual;
+    if (!requester.try_push_request(expected) || !responder.try_pop_request(actual) ||
+        actual != expected || requester.try_pop_request(actual)) {
+        return false;
+    }
+    const ResponseDatagram response{1, DatagramResult::rnr, 9};
+    ResponseDatagram actual_response;
+    return responder.try_push_response(response) &&
+           requester.try_pop_response(actual_response) && actual_response == response &&
+           !responder.try_pop_response(actual_response);
+}
+
+bool fifo_and_capacity_recovery_test() {
+    SharedMemoryTransport requester;
+    SharedMemoryTransport responder;
+    if (!attach_pair(&requester, &responder, 2, 1)) {
+        return false;
+    }
+    RequestDatagram actual;
+    if (!requester.try_push_request(request(1)) || !requester.try_push_request(request(2)) ||
+        requester.try_push_request(request(3)) || !responder.try_pop_request(actual) ||
+        actual != request(1) || !requester.try_push_request(request(3)) ||
+        !responder.try_pop_request(actual) || actual != request(2) ||
+        !responder.try_pop_request(actual) || actual != request(3) ||
+        responder.try_pop_request(actual)) {
+        return false;
+    }
+    const ResponseDatagram first{1, DatagramResult::success, 0};
+    const ResponseDatagram second{2, DatagramResult::backend_error, 0};
+    return responder.try_push_response(first) && !responder.try_push_response(second);
+}
+
+bool peer_mapping_translation_test() {
+    SharedMemoryTransport requester;
+    SharedMemoryTransport responder;
+    if (!attach_pair(&requester, &responder, 4, 4)) {
+        return false;
+    }
+    const PeerMemoryMapping mapping{0x10000, 0x1000, 0x7f0000};
+    if (responder.add_peer_mapping(mapping) != 0 ||
+        responder.add_peer_mapping({0x10800, 0x1000, 0x900000}) != EEXIST ||
+        responder.add_peer_mapping({0x0f800, 0x1000, 0x900000}) != EEXIST ||
+        responder.add_peer_mapping({0x10000, 0, 0x900000}) != EINVAL) {
+        return false;
+    }
+    RequestDatagram actual;
+    if (!requester.try_push_request(request(1, 0x10100)) || !responder.try_pop_request(actual) ||
+        actual.source_daemon_address != 0x7f0100 || actual.source_unmapped) {
+        return false;
+    }
+    // A payload that straddles the end of the mapping is flagged, not translated.
+    if (!requester.try_push_request(request(2, 0x10ffc)) || !responder.try_pop_request(actual) ||
+        !actual.source_unmapped || actual.source_daemon_address != 0x10ffc) {
+        return false;
+    }
+    if (responder.remove_peer_mapping(0x10000) != 0 ||
+        responder.remove_peer_mapping(0x10000) != ENOENT) {
+        return false;
+    }
+    // Once the mapping is gone, so is every address it covered.
+    ResponseDatagram response;
+    return requester.try_push_request(request(3, 0x10100)) && responder.try_pop_request(actual) &&
+           actual.source_unmapped && actual.source_daemon_address == 0x10100 &&
+           requester.try_push_request(request(4)) && responder.try_pop_request(actual) &&
+           actual == request(4) && !requester.try_pop_response(response);
+}
+
+bool attach_rejects_mismatched_layout_test() {
+    SharedMemoryTransport requester;
+    if (ugdr::worker::create_shared_memory_transport(4, 4, &requester) != 0) {
+        return false;
+    }
+    int request_fd = -1;
+    int response_fd = -1;
+    if (requester.duplicate_fds(&request_fd, &response_fd) != 0) {
+        return false;
+    }
+    SharedMemoryTransport swapped;
+    SharedMemoryTransport resized;
+    const bool rejected =
+        ugdr::worker::attach_shared_memory_transport(response_fd, request_fd, 4, 4, &swapped) !=
+            0 &&
+        !swapped.valid() &&
+        ugdr::worker::attach_shared_memory_transport(request_fd, response_fd, 8, 4, &resized) !=
+            0 &&
+        !resized.valid() &&
+        ugdr::worker::create_shared_memory_transport(4, 4, &requester) == EINVAL;
+    (void)::close(request_fd);
+    (void)::close(response_fd);
+    return rejected;
+}
+
+}  // namespace
+
+int main() {
+    if (!cross_mapping_round_trip_test()) {
+        return 1;
+    }
+    if (!fifo_and_capacity_recovery_test()) {
+        return 2;
+    }
+    if (!peer_mapping_translation_test()) {
+        return 3;
+    }
+    return attach_rejects_mismatched_layout_test() ? 0 : 4;
+}
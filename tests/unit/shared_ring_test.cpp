@@ -1,11 +1,14 @@
+#include "control/queue_descriptor.hpp"
 #include "queue/shared_ring.hpp"
 
 #include <algorithm>
 #include <atomic>
 #include <cerrno>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <thread>
+#include <vector>
 
 #include <unistd.h>
 
@@ -104,8 +107,9 @@ int mapping_test() {
     return actual == expected && peer.consumer_release() == 0 ? 0 : 7;
 }
 
-int batch_wrap_test() {
-    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::send, 5, kStride};
+int batch_wrap_test(ugdr::queue::RingOwnership ownership) {
+    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::completion, 5, kStride,
+                                                  ownership};
     ugdr::queue::SharedRing ring;
     if (ugdr::queue::create_shared_ring(descriptor, &ring) != 0) {
         return 1;
@@ -146,9 +150,10 @@ int batch_wrap_test() {
     return 0;
 }
 
-int threaded_wrap_test() {
+int threaded_wrap_test(ugdr::queue::RingOwnership ownership) {
     constexpr std::uint64_t iterations = 200000;
-    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::completion, 257, kStride};
+    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::completion, 257, kStride,
+                                                  ownership};
     ugdr::queue::SharedRing ring;
     if (ugdr::queue::create_shared_ring(descriptor, &ring) != 0) {
         return 1;
@@ -230,6 +235,197 @@ int malformed_mapping_test() {
     return 0;
 }
 
+int phase_ownership_test() {
+    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::completion, 2, kStride,
+                                                  ugdr::queue::RingOwnership::phase};
+    ugdr::queue::SharedRing owner;
+    int fd = -1;
+    if (ugdr::queue::create_shared_ring(descriptor, &owner) != 0 ||
+        ugdr::queue::slot_payload_bytes(descriptor) != 60 || owner.duplicate_fd(&fd) != 0) {
+        return 1;
+    }
+    ugdr::queue::SharedRing counters;
+    ugdr::queue::SharedRing peer;
+    const int mismatch_status = ugdr::queue::map_shared_ring(
+        fd, {descriptor.kind, descriptor.capacity, descriptor.slot_stride}, &counters);
+    const int map_status = ugdr::queue::map_shared_ring(fd, descriptor, &peer);
+    (void)::close(fd);
+    if (mismatch_status != EPROTO || map_status != 0) {
+        return 2;
+    }
+    const auto *header = static_cast<const ugdr::queue::SharedRingHeader *>(peer.mapping_address());
+    for (std::uint64_t value = 0; value < 5; ++value) {
+        void *slot = nullptr;
+        const void *read_slot = nullptr;
+        std::uint64_t actual = UINT64_MAX;
+        if (owner.producer_reserve(&slot) != 0) {
+            return 3;
+        }
+        std::memcpy(slot, &value, sizeof(value));
+        if (peer.consumer_peek(&read_slot) != EAGAIN || owner.producer_publish() != 0 ||
+            peer.consumer_peek(&read_slot) != 0) {
+            return 4;
+        }
+        std::memcpy(&actual, read_slot, sizeof(actual));
+        if (actual != value || peer.consumer_release() != 0 || header->tail.value != 0) {
+            return 5;
+        }
+    }
+    // WQE encoders and compact CQ entries fill the whole slot, so they cannot carry a marker.
+    const ugdr::queue::QueueDescriptor send{ugdr::queue::QueueKind::send, 1, kStride,
+                                            ugdr::queue::RingOwnership::phase};
+    const ugdr::queue::QueueDescriptor receive{ugdr::queue::QueueKind::receive, 1, kStride,
+                                               ugdr::queue::RingOwnership::phase};
+    const ugdr::queue::QueueDescriptor compact{ugdr::queue::QueueKind::completion, 1, 32,
+                                               ugdr::queue::RingOwnership::phase};
+    std::size_t ignored = 0;
+    std::vector<std::byte> bytes;
+    std::vector<ugdr::queue::QueueDescriptor> decoded;
+    if (ugdr::queue::shared_ring_mapping_size(send, 4096, &ignored) != EINVAL ||
+        ugdr::queue::shared_ring_mapping_size(receive, 4096, &ignored) != EINVAL ||
+        ugdr::queue::shared_ring_mapping_size(compact, 4096, &ignored) != EINVAL ||
+        ugdr::control::encode_queue_descriptors({send}, &bytes) != 0 ||
+        ugdr::control::decode_queue_descriptors(bytes, &decoded) != EPROTO) {
+        return 6;
+    }
+    return 0;
+}
+
+// A producer that maps a live phase ring resumes after the last written slot instead of slot 0.
+int phase_producer_recovery_test() {
+    const ugdr::queue::QueueDescriptor descriptor{ugdr::queue::QueueKind::completion, 4, kStride,
+                                                  ugdr::queue::RingOwnership::phase};
+    ugdr::queue::SharedRing first;
+    ugdr::queue::SharedRing consumer;
+    int fd = -1;
+    if (ugdr::queue::create_shared_ring(descriptor, &first) != 0 ||
+        first.duplicate_fd(&fd) != 0) {
+        return 1;
+    }
+    const int map_status = ugdr::queue::map_shared_ring(fd, descriptor, &consumer);
+    if (map_status != 0) {
+        (void)::close(fd);
+        return 2;
+    }
+    // Leave the ring one lap in with slots 1 and 2 written and unconsumed.
+    std::uint64_t value = 0;
+    for (int round = 0; round < 2; ++round) {
+        ugdr::queue::MutableSlotBatch produced;
+        ugdr::queue::ConstSlotBatch consumed;
+        if (first.producer_reserve(3, &produced) != 0 || produced.count != 3) {
+            (void)::close(fd);
+            return 3;
+        }
+        write_span(produced.first, &value);
+        write_span(produced.second, &value);
+        if (first.producer_publish(3) != 0 || consumer.consumer_peek(3, &consumed) != 0 ||
+            consumer.consumer_release(round == 0 ? 3 : 1) != 0) {
+            (void)::close(fd);
+            return 4;
+        }
+    }
+    ugdr::queue::SharedRing second;
+    const int remap_status = ugdr::queue::map_shared_ring(fd, descriptor, &second);
+    (void)::close(fd);
+    ugdr::queue::MutableSlotBatch produced;
+    if (remap_status != 0 || second.producer_reserve(4, &produced) != 0 || produced.count != 2 ||
+        second.producer_position() != 6) {
+        return 5;
+    }
+    write_span(produced.first, &value);
+    write_span(produced.second, &value);
+    if (second.producer_publish(2) != 0) {
+        return 6;
+    }
+    std::uint64_t expected = 4;
+    ugdr::queue::ConstSlotBatch consumed;
+    if (consumer.consumer_peek(4, &consumed) != 0 || consumed.count != 4 ||
+        !read_span(consumed.first, &expected) || !read_span(consumed.second, &expected) ||
+        consumer.consumer_release(4) != 0) {
+        return 7;
+    }
+    return 0;
+}
+
+// Only completion rings may use the compact 32-byte slot; no kind takes other short strides.
+int short_stride_test() {
+    const ugdr::queue::QueueDescriptor compact{ugdr::queue::QueueKind::completion, 4, 32};
+    const ugdr::queue::QueueDescriptor short_send{ugdr::queue::QueueKind::send, 4, 32};
+    const ugdr::queue::QueueDescriptor short_receive{ugdr::queue::QueueKind::receive, 4, 32};
+    const ugdr::queue::QueueDescriptor short_completion{ugdr::queue::QueueKind::completion, 4, 16};
+    std::size_t ignored = 0;
+    if (ugdr::queue::shared_ring_mapping_size(compact, 4096, &ignored) != 0 ||
+        ugdr::queue::shared_ring_mapping_size(short_send, 4096, &ignored) != EINVAL ||
+        ugdr::queue::shared_ring_mapping_size(short_receive, 4096, &ignored) != EINVAL ||
+        ugdr::queue::shared_ring_mapping_size(short_completion, 4096, &ignored) != EINVAL) {
+        return 1;
+    }
+    std::vector<std::byte> bytes;
+    std::vector<ugdr::queue::QueueDescriptor> decoded;
+    if (ugdr::control::encode_queue_descriptors({compact}, &bytes) != 0 ||
+        ugdr::control::decode_queue_descriptors(bytes, &decoded) != 0) {
+        return 2;
+    }
+    if (ugdr::control::encode_queue_descriptors({short_receive}, &bytes) != 0 ||
+        ugdr::control::decode_queue_descriptors(bytes, &decoded) != EPROTO) {
+        return 3;
+    }
+    return 0;
+}
+
+int memory_options_test() {
+    const long page = sysconf(_SC_PAGESIZE);
+    const ugdr::queue::RingMemoryOptions huge{true, true};
+    const ugdr::queue::QueueDescriptor large{ugdr::queue::QueueKind::completion, 16384, kStride};
+    const ugdr::queue::QueueDescriptor small{ugdr::queue::QueueKind::send, 4, kStride};
+    std::size_t normal_size = 0;
+    std::size_t huge_size = 0;
+    std::size_t small_size = 0;
+    if (page <= 0 ||
+        ugdr::queue::shared_ring_mapping_size(large, static_cast<std::size_t>(page),
+                                              &normal_size) != 0 ||
+        ugdr::queue::shared_ring_mapping_size(large, ugdr::queue::kSharedRingHugePageBytes,
+                                              &huge_size) != 0 ||
+        ugdr::queue::shared_ring_mapping_size(small, static_cast<std::size_t>(page),
+                                              &small_size) != 0) {
+        return 1;
+    }
+    // With no huge pages reserved the large ring uses normal pages; small rings always do.
+    ugdr::queue::SharedRing owner;
+    ugdr::queue::SharedRing tiny;
+    if (ugdr::queue::create_shared_ring(large, &owner, huge) != 0 ||
+        (owner.mapping_size() != normal_size && owner.mapping_size() != huge_size) ||
+        ugdr::queue::create_shared_ring(small, &tiny, huge) != 0 ||
+        tiny.mapping_size() != small_size) {
+        return 2;
+    }
+    int fd = -1;
+    if (owner.duplicate_fd(&fd) != 0) {
+        return 3;
+    }
+    ugdr::queue::SharedRing peer;
+    const int map_status = ugdr::queue::map_shared_ring(fd, large, &peer, {false, true});
+    (void)::close(fd);
+    if (map_status != 0 || peer.mapping_size() != owner.mapping_size()) {
+        return 4;
+    }
+    std::uint64_t value = 7;
+    std::uint64_t expected = 7;
+    ugdr::queue::MutableSlotBatch reserved;
+    ugdr::queue::ConstSlotBatch visible;
+    if (peer.producer_reserve(large.capacity, &reserved) != 0 ||
+        reserved.count != large.capacity) {
+        return 5;
+    }
+    write_span(reserved.first, &value);
+    if (peer.producer_publish(reserved.count) != 0 ||
+        owner.consumer_peek(large.capacity, &visible) != 0 ||
+        !read_span(visible.first, &expected)) {
+        return 6;
+    }
+    return owner.consumer_release(visible.count) == 0 ? 0 : 7;
+}
+
 }  // namespace
 
 int main() {
@@ -242,16 +438,27 @@ int main() {
     if (mapping_test() != 0) {
         return 3;
     }
-    if (batch_wrap_test() != 0) {
+    if (batch_wrap_test(ugdr::queue::RingOwnership::counters) != 0 ||
+        batch_wrap_test(ugdr::queue::RingOwnership::phase) != 0) {
         return 4;
     }
-    if (threaded_wrap_test() != 0) {
+    if (threaded_wrap_test(ugdr::queue::RingOwnership::counters) != 0 ||
+        threaded_wrap_test(ugdr::queue::RingOwnership::phase) != 0) {
         return 5;
     }
+    if (phase_ownership_test() != 0 || phase_producer_recovery_test() != 0) {
+        return 8;
+    }
     if (malformed_mapping_test() != 0) {
         return 6;
     }
+    if (memory_options_test() != 0) {
+        return 9;
+    }
     std::size_t ignored = 0;
     const ugdr::queue::QueueDescriptor invalid{ugdr::queue::QueueKind::send, 1, 63};
-    return ugdr::queue::shared_ring_mapping_size(invalid, 4096, &ignored) == EINVAL ? 0 : 7;
+    if (ugdr::queue::shared_ring_mapping_size(invalid, 4096, &ignored) != EINVAL) {
+        return 7;
+    }
+    return short_stride_test() == 0 ? 0 : 10;
 }
@@ -0,0 +1,99 @@
+#include "worker/timer_wheel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using ugdr::worker::TimerWheel;
+
+bool schedule_and_expire_test() {
+    const auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(1us, 8, origin);
+    const TimerWheel::TimerId first = wheel.schedule(origin + 3us, 1);
+    const TimerWheel::TimerId second = wheel.schedule(origin + 5us, 2);
+    const TimerWheel::TimerId third = wheel.schedule(origin + 5us, 3);
+    if (first == TimerWheel::kInvalidTimer || first == second || second == third ||
+        wheel.size() != 3) {
+        return false;
+    }
+    std::vector<std::uint64_t> expired;
+    if (wheel.expire(origin + 2us, &expired) != 0 || wheel.expire(origin + 3us, &expired) != 1 ||
+        expired != std::vector<std::uint64_t>{1} || wheel.cancel(first)) {
+        return false;
+    }
+    expired.clear();
+    if (wheel.expire(origin + 10us, &expired) != 2) {
+        return false;
+    }
+    std::sort(expired.begin(), expired.end());
+    return expired == std::vector<std::uint64_t>{2, 3} && wheel.empty();
+}
+
+bool cancel_test() {
+    const auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(1us, 4, origin);
+    const TimerWheel::TimerId cancelled = wheel.schedule(origin + 2us, 7);
+    if (!wheel.cancel(cancelled) || wheel.cancel(cancelled) ||
+        wheel.cancel(TimerWheel::kInvalidTimer) || !wheel.empty()) {
+        return false;
+    }
+    const TimerWheel::TimerId reused = wheel.schedule(origin + 2us, 8);
+    std::vector<std::uint64_t> expired;
+    return reused != cancelled && !wheel.cancel(cancelled) &&
+           wheel.expire(origin + 2us, &expired) == 1 && expired == std::vector<std::uint64_t>{8};
+}
+
+bool wraparound_test() {
+    const auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(1us, 4, origin);
+    (void)wheel.schedule(origin + 6us, 1);
+    (void)wheel.schedule(origin + 2us, 2);
+    (void)wheel.schedule(origin + 100us, 3);
+    std::vector<std::uint64_t> expired;
+    if (wheel.expire(origin + 2us, &expired) != 1 || expired != std::vector<std::uint64_t>{2} ||
+        wheel.expire(origin + 5us, &expired) != 0 || wheel.expire(origin + 6us, &expired) != 1 ||
+        expired.back() != 1 || wheel.expire(origin + 99us, &expired) != 0) {
+        return false;
+    }
+    const TimerWheel::TimerId past = wheel.schedule(origin, 4);
+    return past != TimerWheel::kInvalidTimer && wheel.expire(origin + 99us, &expired) == 0 &&
+           wheel.expire(origin + 100us, &expired) == 2 && wheel.empty();
+}
+
+bool many_timers_test() {
+    const auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(4us, 4096, origin);
+    std::vector<TimerWheel::TimerId> timers;
+    for (std::uint64_t key = 1; key <= 50000; ++key) {
+        timers.push_back(wheel.schedule(origin + std::chrono::microseconds(key), key));
+    }
+    for (std::size_t index = 0; index < timers.size(); index += 2) {
+        if (!wheel.cancel(timers[index])) {
+            return false;
+        }
+    }
+    std::vector<std::uint64_t> expired;
+    return wheel.size() == 25000 && wheel.expire(origin + 50ms, &expired) == 25000 &&
+           std::all_of(expired.begin(), expired.end(),
+                       [](std::uint64_t key) { return key % 2 == 0; }) &&
+           wheel.empty();
+}
+
+}  // namespace
+
+int main() {
+    if (!schedule_and_expire_test()) {
+        return 1;
+    }
+    if (!cancel_test()) {
+        return 2;
+    }
+    if (!wraparound_test()) {
+        return 3;
+    }
+    return many_timers_test() ? 0 : 4;
+}
@@ -4,6 +4,7 @@
 
 #include <unistd.h>
 
+#include <array>
 #include <atomic>
 #include <cerrno>
 #include <cstddef>
@@ -258,6 +259,216 @@ bool immediate_validation() {
            receive_pair.consumer.consumer_peek(1, &batch) == EAGAIN;
 }
 
+bool array_prefix_and_wrap() {
+    RingPair pair;
+    RingPair receive_pair;
+    if (!make_pair(ugdr::queue::QueueKind::send, 3, 2, &pair) ||
+        !make_pair(ugdr::queue::QueueKind::receive, 2, 1, &receive_pair)) {
+        return false;
+    }
+    ugdr_sge sges[] = {{UINT64_C(0x1000), 64, 7}, {UINT64_C(0x2000), 32, 9}};
+    std::array<ugdr_send_wr, 4> sends{};
+    for (std::size_t index = 0; index < sends.size(); ++index) {
+        sends[index].wr_id = 501 + index;
+        sends[index].opcode = UGDR_WR_RDMA_WRITE;
+        sends[index].sg_list = sges;
+        sends[index].num_sge = static_cast<int>(index % 3);
+        sends[index].next = &sends[0];
+    }
+    int posted = -1;
+    ugdr::queue::ConstSlotBatch batch;
+    if (ugdr::api::post_send_array(pair.producer, 2, sends.data(), -1, &posted) != EINVAL ||
+        posted != 0 ||
+        ugdr::api::post_send_array(pair.producer, 2, nullptr, 1, &posted) != EINVAL ||
+        ugdr::api::post_send_array(pair.producer, 2, sends.data(), 1, nullptr) != EINVAL ||
+        ugdr::api::post_send_array(receive_pair.producer, 1, sends.data(), 1, &posted) != EINVAL ||
+        ugdr::api::post_send_array(pair.producer, 2, sends.data(), 0, &posted) != 0 ||
+        posted != 0) {
+        return false;
+    }
+    sends[1].num_sge = 3;
+    if (ugdr::api::post_send_array(pair.producer, 2, sends.data(), 4, &posted) != EINVAL ||
+        posted != 1 || pair.consumer.consumer_peek(3, &batch) != 0 || batch.count != 1 ||
+        pair.consumer.consumer_release(1) != 0) {
+        return false;
+    }
+    sends[1].num_sge = 1;
+
+    const std::size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+    const int status = ugdr::api::post_send_array(pair.producer, 2, sends.data(), 4, &posted);
+    const std::size_t allocations_after = allocation_count.load(std::memory_order_relaxed);
+    if (status != ENOMEM || posted != 3 || allocations_before != allocations_after ||
+        pair.consumer.consumer_peek(3, &batch) != 0 || batch.count != 3 ||
+        batch.first.count != 2 || batch.second.count != 1) {
+        return false;
+    }
+    const std::uint32_t stride = pair.consumer.descriptor().slot_stride;
+    bool valid = true;
+    for (std::uint32_t index = 0; index < 3; ++index) {
+        const auto *header =
+            reinterpret_cast<const ugdr::queue::SendWqeHeader *>(slot_at(batch, index, stride));
+        const auto *copy = reinterpret_cast<const ugdr::queue::SharedSge *>(header + 1);
+        valid = valid && header->wr_id == 501 + index && header->sge_count == index % 3 &&
+                (header->sge_count == 0 ||
+                 (copy[0].address == UINT64_C(0x1000) && copy[0].length == 64 &&
+                  copy[0].lkey == 7)) &&
+                (header->sge_count < 2 || copy[1].lkey == 9);
+    }
+    if (!valid || pair.consumer.consumer_release(3) != 0) {
+        return false;
+    }
+
+    std::array<ugdr_recv_wr, 2> receives{};
+    receives[0].wr_id = 601;
+    receives[1].wr_id = 602;
+    receives[1].sg_list = sges;
+    receives[1].num_sge = 1;
+    if (ugdr::api::post_receive_array(receive_pair.producer, 1, receives.data(), 2, &posted) != 0 ||
+        posted != 2 || receive_pair.consumer.consumer_peek(2, &batch) != 0 || batch.count != 2) {
+        return false;
+    }
+    const std::uint32_t receive_stride = receive_pair.consumer.descriptor().slot_stride;
+    const auto *second = reinterpret_cast<const ugdr::queue::ReceiveWqeHeader *>(
+        slot_at(batch, 1, receive_stride));
+    const auto *second_sge = reinterpret_cast<const ugdr::queue::SharedSge *>(second + 1);
+    return second->wr_id == 602 && second->sge_count == 1 &&
+           second_sge[0].address == UINT64_C(0x1000) &&
+           receive_pair.consumer.consumer_release(2) == 0;
+}
+
+bool template_validation_and_patching() {
+    RingPair pair;
+    if (!make_pair(ugdr::queue::QueueKind::send, 2, 2, &pair)) {
+        return false;
+    }
+    ugdr_sge sges[] = {{UINT64_C(0x1000), 64, 7}, {UINT64_C(0x2000), 32, 9}};
+    ugdr_send_wr shape{};
+    shape.wr_id = 800;
+    shape.sg_list = sges;
+    shape.num_sge = 2;
+    shape.opcode = UGDR_WR_RDMA_WRITE_WITH_IMM;
+    shape.send_flags = UGDR_SEND_SIGNALED;
+    shape.imm_data = UINT32_C(0x01020304);
+    shape.wr.rdma.remote_addr = UINT64_C(0x4000);
+    shape.wr.rdma.rkey = 13;
+    ugdr::api::SendTemplate send_template;
+    if (ugdr::api::make_send_template(shape, 2, &send_template) != EINVAL ||
+        ugdr::api::make_send_template(shape, 2, nullptr) != EINVAL) {
+        return false;
+    }
+    shape.num_sge = 1;
+    shape.send_flags = 1U << 6U;
+    if (ugdr::api::make_send_template(shape, 2, &send_template) != EINVAL) {
+        return false;
+    }
+    shape.send_flags = UGDR_SEND_SIGNALED;
+    if (ugdr::api::make_send_template(shape, 2, &send_template) != 0) {
+        return false;
+    }
+    sges[0] = {};
+
+    const std::size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+    const bool posted =
+        ugdr::api::post_send_template(pair.producer, send_template, 801, UINT64_C(0x1800),
+                                      UINT64_C(0x4800)) == 0 &&
+        ugdr::api::post_send_template(pair.producer, send_template, 802, UINT64_C(0x1900),
+                                      UINT64_C(0x4900)) == 0 &&
+        ugdr::api::post_send_template(pair.producer, send_template, 803, 0, 0) == ENOMEM;
+    const std::size_t allocations_after = allocation_count.load(std::memory_order_relaxed);
+    ugdr::queue::ConstSlotBatch batch;
+    if (!posted || allocations_before != allocations_after ||
+        pair.consumer.consumer_peek(2, &batch) != 0 || batch.count != 2) {
+        return false;
+    }
+    const std::uint32_t stride = pair.consumer.descriptor().slot_stride;
+    const auto *second =
+        reinterpret_cast<const ugdr::queue::SendWqeHeader *>(slot_at(batch, 1, stride));
+    const auto *second_sge = reinterpret_cast<const ugdr::queue::SharedSge *>(second + 1);
+    return second->wr_id == 802 && second->remote_address == UINT64_C(0x4900) &&
+           second->rkey == 13 && second->opcode == UGDR_WR_RDMA_WRITE_WITH_IMM &&
+           second->send_flags == UGDR_SEND_SIGNALED &&
+           second->immediate_data == UINT32_C(0x01020304) && second->sge_count == 1 &&
+           second_sge[0].address == UINT64_C(0x1900) && second_sge[0].length == 64 &&
+           second_sge[0].lkey == 7 && pair.consumer.consumer_release(2) == 0;
+}
+
+bool builder_wrap_and_latched_errors() {
+    RingPair pair;
+    if (!make_pair(ugdr::queue::QueueKind::send, 3, 2, &pair)) {
+        return false;
+    }
+    ugdr::api::SendWqeBuilder builder;
+    ugdr::queue::ConstSlotBatch batch;
+    if (builder.start(pair.producer, 2) != 0) {
+        return false;
+    }
+    builder.rdma_write(401, 0, 13, UINT64_C(0x4000));
+    builder.rdma_write(402, 0, 13, UINT64_C(0x4000));
+    if (builder.complete() != 0 || pair.consumer.consumer_peek(3, &batch) != 0 ||
+        batch.count != 2 || pair.consumer.consumer_release(2) != 0) {
+        return false;
+    }
+
+    const ugdr_sge sges[] = {{UINT64_C(0x1000), 64, 7}, {UINT64_C(0x2000), 32, 9}};
+    if (builder.start(pair.producer, 2) != 0) {
+        return false;
+    }
+    builder.set_sge(7, UINT64_C(0x1000), 64);
+    if (builder.complete() != EINVAL || builder.start(pair.producer, 2) != 0) {
+        return false;
+    }
+    builder.rdma_write(403, 0, 13, UINT64_C(0x4000));
+    builder.set_sge_list(3, sges);
+    if (builder.complete() != EINVAL || builder.start(pair.producer, 2) != 0) {
+        return false;
+    }
+    for (std::uint64_t wr_id = 404; wr_id < 408; ++wr_id) {
+        builder.rdma_write(wr_id, 0, 13, UINT64_C(0x4000));
+    }
+    if (builder.complete() != ENOMEM || builder.start(pair.producer, 2) != 0) {
+        return false;
+    }
+    builder.rdma_write(408, 0, 13, UINT64_C(0x4000));
+    builder.abort();
+    if (builder.active() || pair.consumer.consumer_peek(3, &batch) != EAGAIN ||
+        builder.start(pair.producer, 2) != 0) {
+        return false;
+    }
+
+    const std::size_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+    builder.rdma_write(409, 0, 13, UINT64_C(0x4000));
+    builder.set_sge_list(2, sges);
+    builder.rdma_write_imm(410, UGDR_SEND_SIGNALED, 17, UINT64_C(0x5000), UINT32_C(0xaabbccdd));
+    builder.set_sge(11, UINT64_C(0x3000), 16);
+    builder.rdma_write(411, 0, 13, UINT64_C(0x4000));
+    const int status = builder.complete();
+    const std::size_t allocations_after = allocation_count.load(std::memory_order_relaxed);
+    if (status != 0 || allocations_before != allocations_after ||
+        pair.consumer.consumer_peek(3, &batch) != 0 || batch.count != 3 ||
+        batch.first.count != 1 || batch.second.count != 2) {
+        return false;
+    }
+    const std::uint32_t stride = pair.consumer.descriptor().slot_stride;
+    const auto *first =
+        reinterpret_cast<const ugdr::queue::SendWqeHeader *>(slot_at(batch, 0, stride));
+    const auto *first_sges = reinterpret_cast<const ugdr::queue::SharedSge *>(first + 1);
+    const auto *second =
+        reinterpret_cast<const ugdr::queue::SendWqeHeader *>(slot_at(batch, 1, stride));
+    const auto *second_sge = reinterpret_cast<const ugdr::queue::SharedSge *>(second + 1);
+    const auto *third =
+        reinterpret_cast<const ugdr::queue::SendWqeHeader *>(slot_at(batch, 2, stride));
+    const bool valid =
+        first->wr_id == 409 && first->opcode == UGDR_WR_RDMA_WRITE && first->sge_count == 2 &&
+        first_sges[0].address == UINT64_C(0x1000) && first_sges[1].lkey == 9 &&
+        second->wr_id == 410 && second->opcode == UGDR_WR_RDMA_WRITE_WITH_IMM &&
+        second->send_flags == UGDR_SEND_SIGNALED && second->rkey == 17 &&
+        second->remote_address == UINT64_C(0x5000) &&
+        second->immediate_data == UINT32_C(0xaabbccdd) && second->sge_count == 1 &&
+        second_sge[0].address == UINT64_C(0x3000) && second_sge[0].length == 16 &&
+        third->wr_id == 411 && third->sge_count == 0 && third->immediate_data == 0;
+    return valid && pair.consumer.consumer_release(3) == 0;
+}
+
 }  // namespace
 
 void *operator new(std::size_t size) {
@@ -290,7 +501,9 @@ void operator delete[](void *memory, std::size_t) noexcept {
 
 int main() {
     return send_copy_and_no_allocation() && receive_copy_and_zero_sge() &&
-                   prefix_failure_full_and_wrap() && immediate_validation()
+                   prefix_failure_full_and_wrap() && immediate_validation() &&
+                   array_prefix_and_wrap() && template_validation_and_patching() &&
+                   builder_wrap_and_latched_errors()
                ? 0
                : 1;
 }